@@ -3,5 +3,6 @@
 
 #include "bios_system_services.h"
 #include "bios_video_services.h"
+#include "bios_keyboard_services.h"
 
 #endif
@@ -0,0 +1,43 @@
+/**
+ * @brief INT 16h keyboard service numbers and extended key scan codes
+ * @details A keystroke is returned as scan code (high byte) : ASCII (low byte).
+ * Keys without an ASCII value (cursor pad, function keys) have ASCII 0, so
+ * they are told apart by scan code alone.
+ */
+#ifndef BIOS_KEYBOARD_CONSTANTS_H
+#define BIOS_KEYBOARD_CONSTANTS_H
+
+#define BIOS_KEYBOARD_SERVICES		16h
+#define BIOS_READ_KEYSTROKE			0
+#define BIOS_CHECK_KEYSTROKE		1
+#define BIOS_GET_SHIFT_FLAGS		2
+#define BIOS_STORE_KEYSTROKE		5
+
+#define BIOS_KEY_SCAN(key)			((uint8_t)((key) >> 8))
+#define BIOS_KEY_ASCII(key)			((char)((key) & 0xFF))
+
+// scan codes of the keys an editor needs
+#define BIOS_SCAN_ESC				0x01
+#define BIOS_SCAN_BACKSPACE			0x0E
+#define BIOS_SCAN_TAB				0x0F
+#define BIOS_SCAN_ENTER				0x1C
+#define BIOS_SCAN_F1				0x3B
+#define BIOS_SCAN_F2				0x3C
+#define BIOS_SCAN_HOME				0x47
+#define BIOS_SCAN_UP				0x48
+#define BIOS_SCAN_PGUP				0x49
+#define BIOS_SCAN_LEFT				0x4B
+#define BIOS_SCAN_RIGHT				0x4D
+#define BIOS_SCAN_END				0x4F
+#define BIOS_SCAN_DOWN				0x50
+#define BIOS_SCAN_PGDN				0x51
+#define BIOS_SCAN_INS				0x52
+#define BIOS_SCAN_DEL				0x53
+#define BIOS_SCAN_CTRL_LEFT			0x73
+#define BIOS_SCAN_CTRL_RIGHT		0x74
+#define BIOS_SCAN_CTRL_END			0x75
+#define BIOS_SCAN_CTRL_PGDN			0x76
+#define BIOS_SCAN_CTRL_HOME			0x77
+#define BIOS_SCAN_CTRL_PGUP			0x84
+
+#endif
@@ -0,0 +1,133 @@
+/**
+ *  @brief
+ *  @details   Keystrokes are queued in the 16 word BIOS type-ahead buffer at
+ *  40:1E by the INT 09 keyboard handler; these services read that queue.
+ */
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "bios_keyboard_services.h"
+#include "bios_keyboard_constants.h"
+
+#ifdef __DOS__
+
+/**
+* @brief  INT 16,0 - Wait for a keystroke and remove it from the buffer.
+*
+* AH = 00
+* on return:
+* AH = keyboard scan code
+* AL = ASCII character or zero if special function key
+*/
+uint16_t bios_read_keystroke() {
+	uint16_t key;
+	__asm {
+		.8086
+
+		mov		ah, BIOS_READ_KEYSTROKE
+		int		BIOS_KEYBOARD_SERVICES
+		mov		key, ax
+
+	}
+	return key;
+}
+
+/**
+* @brief  INT 16,1 - Peek at the next keystroke without removing it.
+* @details Lets a caller poll the keyboard between redraws instead of blocking.
+*
+* AH = 01
+* on return:
+* ZF = 0 if a key is available (AX = scan code : ASCII), 1 if the buffer is empty
+*/
+bool bios_check_keystroke(uint16_t* key) {
+	uint16_t ready = 0;
+	uint16_t k = 0;
+	__asm {
+		.8086
+
+		mov		ah, BIOS_CHECK_KEYSTROKE
+		int		BIOS_KEYBOARD_SERVICES
+		jz		EMPTY
+		mov		k, ax
+		mov		ready, 1
+EMPTY:
+
+	}
+	*key = k;
+	return ready != 0;
+}
+
+/**
+* @brief  INT 16,2 - Read the shift flags byte kept at 40:17.
+*
+* AH = 02
+* on return:
+* AL = shift status (bit 0 right shift, 1 left shift, 2 ctrl, 3 alt,
+*      4 scroll lock, 5 num lock, 6 caps lock, 7 insert)
+*/
+uint8_t bios_get_shift_flags() {
+	uint8_t flags;
+	__asm {
+		.8086
+
+		mov		ah, BIOS_GET_SHIFT_FLAGS
+		int		BIOS_KEYBOARD_SERVICES
+		mov		flags, al
+
+	}
+	return flags;
+}
+
+/**
+* @brief  INT 16,5 - Place a keystroke at the end of the type-ahead buffer, as if typed.
+* @details For scripted input; AT class BIOSes only.
+*
+* AH = 05
+* CH = scan code
+* CL = ASCII character
+* on return:
+* AL = 00 if stored, 01 if the buffer is full
+*/
+bool bios_store_keystroke(uint16_t key) {
+	uint8_t full;
+	__asm {
+		.8086
+
+		mov		ah, BIOS_STORE_KEYSTROKE
+		mov		cx, key
+		int		BIOS_KEYBOARD_SERVICES
+		mov		full, al
+
+	}
+	return full == 0;
+}
+
+#else
+
+/*
+ * Host build: keys come from the terminal backend, which decodes them to the
+ * same scan code : ASCII words.
+ */
+#include "../HOST/host_terminal.h"
+
+uint16_t bios_read_keystroke() {
+	return host_terminal_read_key();
+}
+
+bool bios_check_keystroke(uint16_t* key) {
+	uint16_t k = 0;
+	bool ready = host_terminal_peek_key(&k);
+	*key = k;
+	return ready;
+}
+
+uint8_t bios_get_shift_flags() {
+	return 0;		// a terminal reports no shift state
+}
+
+bool bios_store_keystroke(uint16_t key) {
+	return host_terminal_store_key(key);
+}
+
+#endif
@@ -0,0 +1,25 @@
+/**
+ *  @brief    INT 16h: Keyboard Services
+ *  @url http://www.techhelpmanual.com/27-dos__bios___extensions_service_index.html
+ */
+#ifndef BIOS_KEYBOARD_SERVICES_H
+#define	BIOS_KEYBOARD_SERVICES_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "bios_keyboard_constants.h"
+
+// INT 16,00 - Wait for Keystroke and Read [PC] [XT] [AT]
+uint16_t bios_read_keystroke();
+
+// INT 16,01 - Get Keystroke Status [PC] [XT] [AT]
+bool bios_check_keystroke(uint16_t* key);
+
+// INT 16,02 - Get Shift Status [PC] [XT] [AT]
+uint8_t bios_get_shift_flags();
+
+// INT 16,05 - Store Keystroke in Keyboard Buffer [AT]
+bool bios_store_keystroke(uint16_t key);
+
+#endif
@@ -1,5 +1,7 @@
 #include "bios_memory_size.h"
 
+#ifdef __DOS__
+
 bios_memory_size_t bios_memory_size_KiB() {
 	bios_memory_size_t size_kib = 0;
 	__asm {
@@ -15,3 +17,11 @@ bios_memory_size_t bios_memory_size_KiB() {
 	}
 	return size_kib;
 }
+
+#else
+
+bios_memory_size_t bios_memory_size_KiB() {
+	return 640;		// host build: a fully populated PC
+}
+
+#endif
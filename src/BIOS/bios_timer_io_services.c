@@ -12,6 +12,8 @@
 #include "bios_timer_io_services.h"
 #include "bios_timer_io_constants.h"
 
+#ifdef __DOS__
+
 /**
 * @brief  INT 1A,0 - Read System Clock Counter - it is incremented about once every 55 ms by INT 08H.
 * @details Reads the BIOS Data Area address 40:6C Timer Counter DWord as updated by the INT 08 routine.
@@ -80,3 +82,26 @@ OK:
 #endif
 
 }
+
+#else
+
+/*
+ * Host build: the tick count is derived from local time, 1573040 ticks a day.
+ */
+#include <time.h>
+
+#define TIMER_TICKS_PER_DAY		1573040UL
+#define TIMER_SECONDS_PER_DAY	86400UL
+
+void bios_read_system_clock(bios_ticks_since_midnight_t* ticks) {
+	time_t now = time(NULL);
+	struct tm* local = localtime(&now);
+	uint32_t seconds = local->tm_hour * 3600UL + local->tm_min * 60UL + local->tm_sec;
+	*ticks = (bios_ticks_since_midnight_t)((uint64_t)seconds * TIMER_TICKS_PER_DAY / TIMER_SECONDS_PER_DAY);
+}
+
+void bios_set_system_clock(bios_ticks_since_midnight_t ticks) {
+	(void)ticks;	// the host clock is not ours to set
+}
+
+#endif
@@ -9,6 +9,8 @@
 #include "bios_video_services_constants.h"
 #include "bios_video_services.h"
 
+#ifdef __DOS__
+
 /**
 * @brief INT 10,0 - Set Video Mode
 * AH = 00
@@ -434,6 +436,153 @@ uint8_t bios_helper_video_subsytem_configuration(uint8_t request, uint8_t settin
 	return e;
 }
 
+#else
+
+/*
+ * Host build: the services act on the CRTC model (MDA/mda_crtc.h), shown
+ * by the terminal backend (HOST/host_terminal.h), as the MDA BIOS acts on
+ * the card. Like the BIOS they assume display start 0 and a single page.
+ */
+#include "../HOST/host_terminal.h"
+#include "../MDA/mda_crtc.h"
+#include "../MDA/mda_attributes.h"
+#include "../MDA/mda_constants.h"
+
+#define VIDEO_BEL	0x07
+#define VIDEO_BS	0x08
+#define VIDEO_LF	0x0A
+#define VIDEO_CR	0x0D
+
+static bios_cursor_state_t video_cursor = { 0x0B, 0x0C, 0, 0 };	// BDA 40:50 and 40:60
+
+/**
+* @brief Store a cell in the model page and its mirror.
+*/
+static void video_poke(uint16_t offset, char chr, uint8_t attr) {
+	mda_cell_t* cell = &mda_crtc_model.vram[offset & MDA_CRTC_WORD_MASK];
+	cell->chr = chr;
+	cell->attr = attr;
+	cell[MDA_CRTC_PAGE_WORDS] = *cell;
+}
+
+static uint16_t video_offset(void) {
+	return video_cursor.row * MDA_COLUMNS + video_cursor.column;
+}
+
+void bios_set_video_mode(uint8_t mode) {
+	(void)mode;		// only MDA text mode is emulated
+	host_terminal_open();
+	mda_crtc_set_start(0);
+	for (uint16_t i = 0; i < MDA_CRTC_PAGE_WORDS; ++i) {
+		video_poke(i, ' ', MDA_NORMAL);
+	}
+	bios_set_cursor_type(0x0B, 0x0C);
+	bios_set_cursor_position(0, 0, 0);
+}
+
+void bios_set_cursor_type(uint8_t start_scan_line, uint8_t end_scan_line) {
+	video_cursor.start_scan = start_scan_line;
+	video_cursor.end_scan = end_scan_line;
+	mda_crtc_write(MDA_CRTC_CURSOR_START, start_scan_line);
+	mda_crtc_write(MDA_CRTC_CURSOR_END, end_scan_line);
+}
+
+void bios_set_cursor_position(uint8_t x, uint8_t y, uint8_t video_page) {
+	(void)video_page;
+	video_cursor.column = x;
+	video_cursor.row = y;
+	uint16_t offset = video_offset();
+	mda_crtc_write(MDA_CRTC_CURSOR_HI, (uint8_t)(offset >> 8));
+	mda_crtc_write(MDA_CRTC_CURSOR_LO, (uint8_t)offset);
+}
+
+void bios_get_cursor_position_and_size(bios_cursor_state_t* state, uint8_t video_page) {
+	(void)video_page;
+	*state = video_cursor;
+}
+
+uint16_t bios_read_character_and_attribute_at_cursor(uint8_t video_page) {
+	(void)video_page;
+	return mda_crtc_model.vram[video_offset()].packed;
+}
+
+void bios_write_character_and_attribute_at_cursor(char chr, char attr, uint16_t count, uint8_t video_page) {
+	(void)video_page;
+	for (uint16_t i = 0, offset = video_offset(); i < count; ++i) {
+		video_poke(offset + i, chr, (uint8_t)attr);
+	}
+}
+
+void bios_write_character_at_cursor(char chr, uint8_t foreground_colour, uint16_t count, uint8_t video_page) {
+	(void)foreground_colour;
+	(void)video_page;
+	for (uint16_t i = 0, offset = video_offset(); i < count; ++i) {
+		video_poke(offset + i, chr, mda_crtc_model.vram[(offset + i) & MDA_CRTC_WORD_MASK].attr);
+	}
+}
+
+void bios_write_text_teletype_mode(char chr, uint8_t foreground_colour, uint8_t video_page) {
+	(void)foreground_colour;
+	(void)video_page;
+	uint8_t x = video_cursor.column;
+	uint8_t y = video_cursor.row;
+	switch (chr) {
+	case VIDEO_BEL:
+		host_terminal_bell();
+		return;
+	case VIDEO_BS:
+		x = (x > 0) ? x - 1 : 0;
+		break;
+	case VIDEO_CR:
+		x = 0;
+		break;
+	case VIDEO_LF:
+		y++;
+		break;
+	default:
+		video_poke(video_offset(), chr, mda_crtc_model.vram[video_offset()].attr);
+		if (++x == MDA_COLUMNS) {
+			x = 0;
+			y++;
+		}
+		break;
+	}
+	if (y == MDA_ROWS) {	// scroll the page up a line, the new line takes the attribute at the cursor
+		uint8_t attr = mda_crtc_model.vram[video_offset()].attr;
+		for (uint16_t i = 0; i < MDA_SCREEN_WORDS - MDA_COLUMNS; ++i) {
+			mda_cell_t cell = mda_crtc_model.vram[i + MDA_COLUMNS];
+			video_poke(i, cell.chr, cell.attr);
+		}
+		for (uint16_t i = MDA_SCREEN_WORDS - MDA_COLUMNS; i < MDA_SCREEN_WORDS; ++i) {
+			video_poke(i, ' ', attr);
+		}
+		y--;
+	}
+	bios_set_cursor_position(x, y, 0);
+}
+
+void bios_get_video_state(bios_video_state_t* state) {
+	state->columns = MDA_COLUMNS;
+	state->mode = MDA_TEXT_MONOCHROME_80X25;
+	state->page = 0;
+}
+
+uint8_t bios_return_video_configuration_information(bios_video_subsystem_config_t* config) {
+	config->color_mode = 1;			// mono
+	config->ega_memory = 0x10;		// BL > 4: not an EGA or VGA
+	config->feature_bits = 0;
+	config->switch_settings = 0;
+	return 0;
+}
+
+uint8_t bios_helper_video_subsytem_configuration(uint8_t request, uint8_t setting) {
+	(void)request;
+	(void)setting;
+	return 0;		// AL unchanged: not supported, as on an MDA
+}
+
+#endif
+
 /**
 * @brief INT 10,12 - Video Subsystem Configuration (EGA/VGA)
 */
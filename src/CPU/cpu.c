@@ -0,0 +1,67 @@
+/**
+ * @file cpu.c
+ * @brief Implementation of Runtime CPU Detection
+ * @author Jeremy Thornton
+ */
+#include "cpu.h"
+#include <stdint.h>
+
+#ifdef __DOS__
+cpu_type_t cpu_detect(void) {
+    uint16_t type = CPU_8086;
+    __asm {
+        .8086
+        pushf                   ; preserve flags
+        // 1. try to clear FLAGS bits 12-15
+        pushf
+        pop  ax
+        and  ax, 0FFFh
+        push ax
+        popf
+        pushf
+        pop  ax
+        and  ax, 0F000h
+        cmp  ax, 0F000h
+        jne  AT                 ; bits stuck at 1 => 8086 or 80186
+        // 2. 8086 shifts by the full count, 80186 masks it to 5 bits
+        mov  ax, 1
+        mov  cl, 32
+        shl  ax, cl             ; 8086: AX = 0, 80186: AX = 1
+        test ax, ax
+        jz   DONE
+        mov  type, 1            ; CPU_80186
+        jmp  DONE
+        // 3. try to set FLAGS bits 12-14
+AT:     pushf
+        pop  ax
+        or   ax, 7000h
+        push ax
+        popf
+        pushf
+        pop  ax
+        mov  type, 2            ; CPU_80286
+        test ax, 7000h
+        jz   DONE               ; bits stuck at 0 => 80286 real mode
+        mov  type, 3            ; CPU_80386
+DONE:   popf                    ; restore flags
+    }
+    return (cpu_type_t)type;
+}
+#else
+cpu_type_t cpu_detect(void) {
+    return CPU_80386;           // host build: any 32-bit capable CPU
+}
+#endif
+
+const char* cpu_name(cpu_type_t cpu) {
+    switch (cpu) {
+        case CPU_80186:
+            return "80186";
+        case CPU_80286:
+            return "80286";
+        case CPU_80386:
+            return "80386+";
+        default:
+            return "8086";
+    }
+}
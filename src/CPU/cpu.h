@@ -0,0 +1,39 @@
+/**
+ * @file cpu.h
+ * @brief Runtime CPU Detection
+ * @details Identifies the processor generation at startup so that code
+ * built for the 8086 baseline can switch to kernels using newer
+ * instructions. NEC V20/V30 parts execute the 80186 instruction set and
+ * report as CPU_80186.
+ * @author Jeremy Thornton
+ */
+#ifndef CPU_H
+#define CPU_H
+
+/**
+ * @enum cpu_type_t
+ * @brief Processor generations, ordered so later types run earlier code.
+ */
+typedef enum {
+    CPU_8086    = 0,    /**< 8086/8088 */
+    CPU_80186   = 1,    /**< 80186/80188, NEC V20/V30 */
+    CPU_80286   = 2,    /**< 80286 */
+    CPU_80386   = 3     /**< 80386 or later */
+} cpu_type_t;
+
+/**
+ * @brief Detect the processor generation.
+ * @details Uses only 8086 instructions:
+ * - FLAGS bits 12-15 are stuck at 1 on the 8086/80186, stuck at 0 in real
+ *   mode on the 80286, and writable on the 80386.
+ * - The 80186 masks shift counts to 5 bits, so `shl ax, cl` with CL = 32
+ *   leaves AX unchanged, whereas the 8086 shifts it out to zero.
+ */
+cpu_type_t cpu_detect(void);
+
+/**
+ * @brief Printable name of a processor generation.
+ */
+const char* cpu_name(cpu_type_t cpu);
+
+#endif /* CPU_H */
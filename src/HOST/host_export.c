@@ -0,0 +1,139 @@
+/**
+ * @file host_export.c
+ * @brief Implementation of the Shared-Memory Screen Export
+ * @details The cells in the mapping double as the writer's shadow: a row is
+ * compared with its mapped copy and written only if it differs. A frame in
+ * which nothing changed leaves the sequence alone, so idle readers see no
+ * new frames.
+ * @author Jeremy Thornton
+ */
+#include "host_export.h"
+#include "../MDA/mda_primitives.h"
+#include "../CONTRACT/contract.h"
+#include <fcntl.h>
+#include <stddef.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+_Static_assert(offsetof(host_export_map_t, cells) == HOST_EXPORT_HEADER, "export header layout");
+_Static_assert(sizeof(host_export_map_t) == HOST_EXPORT_SIZE, "export file layout");
+
+/**
+ * @brief Map path, creating it at full size if create is set.
+ */
+static host_export_map_t* export_map(const char* path, bool create) {
+    int fd = create ? open(path, O_RDWR | O_CREAT | O_TRUNC, 0644) : open(path, O_RDONLY);
+    if (fd < 0) {
+        return NULL;
+    }
+    void* map = MAP_FAILED;
+    if (!create || ftruncate(fd, HOST_EXPORT_SIZE) == 0) {
+        map = mmap(NULL, HOST_EXPORT_SIZE, create ? PROT_READ | PROT_WRITE : PROT_READ, MAP_SHARED, fd, 0);
+    }
+    close(fd);                      // the mapping keeps the file
+    return (map == MAP_FAILED) ? NULL : (host_export_map_t*)map;
+}
+
+bool host_export_open(host_export_t* export, const char* path) {
+    require_address(export, "NULL export!");
+    require_address(path, "NULL path!");
+    host_export_map_t* map = export_map(path, true);
+    if (map == NULL) {
+        return false;
+    }
+    memcpy(map->magic, HOST_EXPORT_MAGIC, 4);
+    map->version = HOST_EXPORT_VERSION;
+    map->columns = MDA_COLUMNS;
+    map->rows = MDA_ROWS;
+    for (uint16_t i = 0; i < MDA_SCREEN_WORDS; ++i) {
+        map->cells[i].packed = ~map->cells[i].packed;   // differ from any screen: the first frame has every row
+    }
+    map->cursor = MDA_SCREEN_WORDS;
+    export->map = map;
+    export->frame = 0;
+    host_export_present(export, NULL);
+    return true;
+}
+
+void host_export_present(host_export_t* export, const mda_point_t* cursor) {
+    require_address(export, "NULL export!");
+    host_export_map_t* map = export->map;
+    uint16_t offset = cursor ? cursor->y * MDA_COLUMNS + cursor->x : MDA_SCREEN_WORDS;
+    uint32_t dirty = 0;
+    mda_point_t p = mda_point_make(0, 0);
+    for (; p.y < MDA_ROWS; ++p.y) {
+        if (memcmp(map->cells + p.y * MDA_COLUMNS, mda_as_pointer(&p), MDA_ROW_BYTES) != 0) {
+            dirty |= 1UL << p.y;
+        }
+    }
+    if (dirty == 0 && offset == map->cursor) {
+        return;
+    }
+    unsigned sequence = atomic_load_explicit(&map->sequence, memory_order_relaxed);
+    atomic_store_explicit(&map->sequence, sequence + 1, memory_order_relaxed);    // odd: writing
+    atomic_thread_fence(memory_order_release);
+    for (p.y = 0; p.y < MDA_ROWS; ++p.y) {
+        if (dirty & (1UL << p.y)) {
+            memcpy(map->cells + p.y * MDA_COLUMNS, mda_as_pointer(&p), MDA_ROW_BYTES);
+        }
+    }
+    map->cursor = offset;
+    atomic_store_explicit(&map->dirty, dirty, memory_order_relaxed);
+    atomic_store_explicit(&map->frame, ++export->frame, memory_order_relaxed);
+    atomic_store_explicit(&map->sequence, sequence + 2, memory_order_release);    // even: complete
+}
+
+bool host_export_attach(host_export_t* export, const char* path) {
+    require_address(export, "NULL export!");
+    require_address(path, "NULL path!");
+    host_export_map_t* map = export_map(path, false);
+    if (map != NULL && (memcmp(map->magic, HOST_EXPORT_MAGIC, 4) != 0 || map->version != HOST_EXPORT_VERSION)) {
+        munmap(map, HOST_EXPORT_SIZE);
+        map = NULL;
+    }
+    export->map = map;
+    export->frame = 0;              // frames count from 1: the first snapshot copies every row
+    return map != NULL;
+}
+
+uint32_t host_export_snapshot(host_export_t* export, mda_cell_t* cells, uint16_t* cursor) {
+    require_address(export, "NULL export!");
+    require_address(cells, "NULL cells!");
+    host_export_map_t* map = export->map;
+    unsigned before;
+    unsigned after;
+    uint32_t frame;
+    uint16_t at;
+    do {
+        before = atomic_load_explicit(&map->sequence, memory_order_acquire);
+        if (before & 1) {
+            continue;               // a frame is being written
+        }
+        frame = atomic_load_explicit(&map->frame, memory_order_relaxed);
+        uint32_t rows = (frame == export->frame) ? 0
+                      : (frame == export->frame + 1) ? atomic_load_explicit(&map->dirty, memory_order_relaxed)
+                      : HOST_EXPORT_ALL_ROWS;
+        for (uint8_t y = 0; y < MDA_ROWS; ++y) {
+            if (rows & (1UL << y)) {
+                memcpy(cells + y * MDA_COLUMNS, map->cells + y * MDA_COLUMNS, MDA_ROW_BYTES);
+            }
+        }
+        at = map->cursor;
+        atomic_thread_fence(memory_order_acquire);
+        after = atomic_load_explicit(&map->sequence, memory_order_relaxed);
+    } while ((before & 1) || before != after);
+    export->frame = frame;
+    if (cursor != NULL) {
+        *cursor = at;
+    }
+    return frame;
+}
+
+void host_export_close(host_export_t* export) {
+    require_address(export, "NULL export!");
+    if (export->map != NULL) {
+        munmap(export->map, HOST_EXPORT_SIZE);
+        export->map = NULL;
+    }
+}
@@ -0,0 +1,105 @@
+/**
+ * @file host_export.h
+ * @brief Shared-Memory Screen Export for External Viewers
+ * @details Exports the screen as a memory-mapped file that viewers,
+ * screenshot tools and test harnesses map and read in place: no copies
+ * through pipes, no round trips to the program.
+ *
+ * File layout (little endian):
+ *   0  magic "MDAX"
+ *   4  version, columns (80), rows (25), reserved
+ *   8  sequence: even when the frame is complete, odd while one is written
+ *  12  frame: frames exported
+ *  16  dirty: bit y set if row y changed in the last frame
+ *  20  cursor: cell offset, 2000 (MDA_SCREEN_WORDS) when hidden
+ *  22  reserved
+ *  32  cells: 4000 bytes, the layout mda_save_screen() writes
+ *
+ * The writer is a seqlock: it makes the sequence odd, updates only the rows
+ * that changed, then makes it even again. A reader copies what it needs
+ * between two reads of the sequence and retries if they differ or are odd,
+ * so it never sees a torn frame and never holds up the writer. A reader
+ * that saw frame n - 1 need only copy the dirty rows of frame n.
+ *
+ * With TUI_EXPORT=path in the environment the terminal backend exports each
+ * frame it presents there, so any demo can be watched from outside.
+ *
+ * @author Jeremy Thornton
+ */
+#ifndef HOST_EXPORT_H
+#define HOST_EXPORT_H
+
+#include "../MDA/mda_cell.h"
+#include "../MDA/mda_constants.h"
+#include "../MDA/mda_point.h"
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#define HOST_EXPORT_MAGIC       "MDAX"
+#define HOST_EXPORT_VERSION     1
+#define HOST_EXPORT_HEADER      32      /**< Bytes before the cells */
+#define HOST_EXPORT_SIZE        (HOST_EXPORT_HEADER + MDA_SCREEN_WORDS * 2)
+#define HOST_EXPORT_ALL_ROWS    0x01FFFFFFUL    /**< Dirty bits of every row */
+
+/**
+ * @struct host_export_map_t
+ * @brief The mapped file as laid out above.
+ */
+typedef struct {
+    char magic[4];
+    uint8_t version;
+    uint8_t columns;
+    uint8_t rows;
+    uint8_t reserved;
+    atomic_uint sequence;
+    atomic_uint frame;
+    atomic_uint dirty;
+    uint16_t cursor;
+    uint8_t reserved2[HOST_EXPORT_HEADER - 22];
+    mda_cell_t cells[MDA_SCREEN_WORDS];
+} host_export_map_t;
+
+/**
+ * @struct host_export_t
+ * @brief One mapping, writer's or reader's.
+ */
+typedef struct {
+    host_export_map_t* map;
+    uint32_t frame;                 /**< Reader: frame of the last snapshot */
+} host_export_t;
+
+/**
+ * @brief Create (or truncate) the export file, map it and export the screen.
+ * @return false if the file could not be created or mapped.
+ */
+bool host_export_open(host_export_t* export, const char* path);
+
+/**
+ * @brief Export the rows of the screen that changed since the last call.
+ * @param cursor Cursor to export, or NULL if hidden.
+ * @note Async-signal-safe: no locks, no allocation.
+ */
+void host_export_present(host_export_t* export, const mda_point_t* cursor);
+
+/**
+ * @brief Map an export file written by another process, read only.
+ * @return false if it is missing or not an export.
+ */
+bool host_export_attach(host_export_t* export, const char* path);
+
+/**
+ * @brief Copy a consistent frame.
+ * @param cells  MDA_SCREEN_WORDS cells; rows not dirty are only copied if
+ *               frames were missed since the last snapshot into this buffer.
+ * @param cursor Set to the cursor offset, MDA_SCREEN_WORDS when hidden; may be NULL.
+ * @return Frame number of the snapshot.
+ */
+uint32_t host_export_snapshot(host_export_t* export, mda_cell_t* cells, uint16_t* cursor);
+
+/**
+ * @brief Unmap; the file stays for readers still attached.
+ */
+void host_export_close(host_export_t* export);
+
+#endif /* HOST_EXPORT_H */
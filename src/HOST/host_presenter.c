@@ -0,0 +1,122 @@
+/**
+ * @file host_presenter.c
+ * @brief Implementation of the Threaded Host Presenter
+ * @details The ready slot holds a buffer index with PRESENTER_FRESH set
+ * while the presenter has not taken it. Publishing is one exchange and a
+ * sem_post(), neither of which waits. The presenter only exchanges when it
+ * sees the flag set, and only the producer sets it, so the exchange always
+ * returns a fresh frame. Each side owns its buffer outright between swaps.
+ * @author Jeremy Thornton
+ */
+#include "host_presenter.h"
+#include "host_screen.h"
+#include "../MDA/mda_clock.h"
+#include "../CONTRACT/contract.h"
+#include <signal.h>
+#include <string.h>
+
+#define PRESENTER_FRESH     0x04
+#define PRESENTER_INDEX     0x03
+
+/**
+ * @brief Take the frame published last, if the presenter has not yet, and write it to the sink.
+ */
+static void presenter_take(host_presenter_t* presenter) {
+    if (!(atomic_load(&presenter->ready) & PRESENTER_FRESH)) {
+        return;
+    }
+    presenter->front = atomic_exchange(&presenter->ready, presenter->front) & PRESENTER_INDEX;
+    const host_presenter_frame_t* frame = &presenter->frames[presenter->front];
+    mda_point_t cursor = mda_point_make(frame->cursor % MDA_COLUMNS, frame->cursor / MDA_COLUMNS);
+    mda_remote_set_source(&presenter->remote, frame->cells);
+    mda_remote_frame(&presenter->remote, MDA_REMOTE_ALL_ROWS, (frame->cursor < MDA_SCREEN_WORDS) ? &cursor : NULL);
+    while (!mda_remote_pump(&presenter->remote)) {
+        ;   // the sink blocks; the producer carries on meanwhile
+    }
+    uint32_t latency = mda_clock_us() - frame->published;
+    atomic_fetch_add(&presenter->presented, 1);
+    atomic_fetch_add(&presenter->latency_us, latency);
+    if (latency > atomic_load(&presenter->latency_max_us)) {
+        atomic_store(&presenter->latency_max_us, latency);      // only this thread stores it
+    }
+    atomic_store(&presenter->bytes, presenter->remote.bytes);
+}
+
+static void* presenter_run(void* arg) {
+    host_presenter_t* presenter = (host_presenter_t*)arg;
+    bool running = true;
+    while (running) {
+        while (sem_wait(&presenter->wake) != 0) {
+            ;   // EINTR
+        }
+        running = atomic_load(&presenter->running);
+        presenter_take(presenter);              // after a stop: the last frame published
+    }
+    return NULL;
+}
+
+bool host_presenter_start(host_presenter_t* presenter, int fd, mda_remote_mode_t mode) {
+    require_address(presenter, "NULL presenter!");
+    presenter->back = 0;
+    presenter->front = 1;
+    atomic_init(&presenter->ready, 2);
+    atomic_init(&presenter->running, true);
+    atomic_init(&presenter->published, 0);
+    atomic_init(&presenter->dropped, 0);
+    atomic_init(&presenter->presented, 0);
+    atomic_init(&presenter->latency_us, 0);
+    atomic_init(&presenter->latency_max_us, 0);
+    atomic_init(&presenter->bytes, 0);
+    mda_remote_open(&presenter->remote, fd, 0, mode, presenter->queue, HOST_PRESENTER_QUEUE);
+    if (sem_init(&presenter->wake, 0, 0) != 0) {
+        return false;
+    }
+    sigset_t all;
+    sigset_t old;
+    sigfillset(&all);
+    pthread_sigmask(SIG_BLOCK, &all, &old);    // signals, host_terminal's SIGALRM among them, stay with the program
+    int error = pthread_create(&presenter->thread, NULL, presenter_run, presenter);
+    pthread_sigmask(SIG_SETMASK, &old, NULL);
+    if (error != 0) {
+        sem_destroy(&presenter->wake);
+        return false;
+    }
+    return true;
+}
+
+void host_presenter_publish(host_presenter_t* presenter, const mda_point_t* cursor) {
+    require_address(presenter, "NULL presenter!");
+    host_presenter_frame_t* frame = &presenter->frames[presenter->back];
+    memcpy(frame->cells, host_screen_cells(), sizeof(frame->cells));
+    frame->cursor = cursor ? cursor->y * MDA_COLUMNS + cursor->x : MDA_SCREEN_WORDS;
+    frame->published = mda_clock_us();
+    unsigned previous = atomic_exchange(&presenter->ready, presenter->back | PRESENTER_FRESH);
+    presenter->back = previous & PRESENTER_INDEX;
+    atomic_fetch_add(&presenter->published, 1);
+    if (previous & PRESENTER_FRESH) {
+        atomic_fetch_add(&presenter->dropped, 1);
+    }
+    sem_post(&presenter->wake);
+}
+
+bool host_presenter_stop(host_presenter_t* presenter) {
+    require_address(presenter, "NULL presenter!");
+    atomic_store(&presenter->running, false);
+    sem_post(&presenter->wake);
+    pthread_join(presenter->thread, NULL);
+    sem_destroy(&presenter->wake);
+    bool ok = mda_remote_close(&presenter->remote);
+    atomic_store(&presenter->bytes, presenter->remote.bytes);
+    return ok;
+}
+
+void host_presenter_stats(host_presenter_t* presenter, host_presenter_stats_t* stats) {
+    require_address(presenter, "NULL presenter!");
+    require_address(stats, "NULL stats!");
+    stats->published = atomic_load(&presenter->published);
+    stats->presented = atomic_load(&presenter->presented);
+    stats->dropped = atomic_load(&presenter->dropped);
+    stats->latency_mean_us = stats->presented ? (uint32_t)(atomic_load(&presenter->latency_us) / stats->presented) : 0;
+    stats->latency_max_us = atomic_load(&presenter->latency_max_us);
+    stats->bytes = atomic_load(&presenter->bytes);
+}
@@ -0,0 +1,112 @@
+/**
+ * @file host_presenter.h
+ * @brief Threaded Host Presenter with a Triple-Buffered Cell Grid
+ * @details Decouples drawing from output on the host build. The program
+ * draws on the screen as usual and publishes each finished frame; a
+ * presenter thread diffs the latest published frame against what the sink
+ * shows and writes the difference, encoded by mda_remote.h, while the
+ * program goes on drawing the next.
+ *
+ * Three buffers: the program copies the screen into the back buffer and
+ * swaps it with the ready slot in one atomic exchange, so publishing never
+ * waits on the presenter. The presenter swaps the ready slot with its front
+ * buffer when a fresh frame is there. A frame published before the last
+ * was taken is dropped: a slow sink shows the latest frame, never a queue
+ * of stale ones.
+ *
+ * The sink is any file descriptor: a terminal (VT100), or a file, pipe or
+ * socket (either encoding). Pointing it at /dev/null measures drawing
+ * throughput apart from output I/O.
+ *
+ * @note Not for use with the terminal the program was started on while
+ * host_terminal.h presents to it.
+ * @author Jeremy Thornton
+ */
+#ifndef HOST_PRESENTER_H
+#define HOST_PRESENTER_H
+
+#include "../MDA/mda_cell.h"
+#include "../MDA/mda_constants.h"
+#include "../MDA/mda_point.h"
+#include "../MDA/mda_remote.h"
+#include <pthread.h>
+#include <semaphore.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#define HOST_PRESENTER_BUFFERS  3
+#define HOST_PRESENTER_QUEUE    32768   /**< Bytes of output per frame at most */
+
+/**
+ * @struct host_presenter_frame_t
+ * @brief One buffer: a copy of the screen and when it was published.
+ */
+typedef struct {
+    mda_cell_t cells[MDA_SCREEN_WORDS];
+    uint16_t cursor;                        /**< Cursor offset, MDA_SCREEN_WORDS hidden */
+    uint32_t published;                     /**< mda_clock_us() at publish */
+} host_presenter_frame_t;
+
+/**
+ * @struct host_presenter_stats_t
+ * @brief Counts since host_presenter_start().
+ */
+typedef struct {
+    uint32_t published;                     /**< Frames published */
+    uint32_t presented;                     /**< Frames written to the sink */
+    uint32_t dropped;                       /**< Frames replaced before the presenter took them */
+    uint32_t latency_mean_us;               /**< Publish to written, mean of presented frames */
+    uint32_t latency_max_us;                /**< Publish to written, worst */
+    uint32_t bytes;                         /**< Bytes written to the sink */
+} host_presenter_stats_t;
+
+/**
+ * @struct host_presenter_t
+ * @brief Buffers, presenter thread and sink.
+ */
+typedef struct {
+    host_presenter_frame_t frames[HOST_PRESENTER_BUFFERS];
+    uint8_t back;                           /**< Producer: buffer being filled */
+    uint8_t front;                          /**< Presenter: buffer last presented */
+    atomic_uint ready;                      /**< Buffer last published, flagged fresh until taken */
+    atomic_bool running;
+    sem_t wake;                             /**< Posted on publish and stop */
+    pthread_t thread;
+    mda_remote_t remote;                    /**< Presenter thread only */
+    uint8_t queue[HOST_PRESENTER_QUEUE];
+    atomic_uint published;
+    atomic_uint dropped;
+    atomic_uint presented;
+    atomic_ullong latency_us;               /**< Sum over presented frames */
+    atomic_uint latency_max_us;
+    atomic_uint bytes;
+} host_presenter_t;
+
+/**
+ * @brief Start a presenter thread writing to a sink.
+ * @param fd   Sink: terminal, file, pipe or socket, open for writing.
+ * @param mode MDA_REMOTE_VT100 for a terminal, either for the rest.
+ * @return false if the thread could not be started.
+ * @note Call mda_clock_init() first; latency is measured with mda_clock_us().
+ */
+bool host_presenter_start(host_presenter_t* presenter, int fd, mda_remote_mode_t mode);
+
+/**
+ * @brief Publish the screen as it is now; never waits.
+ * @param cursor Cursor to show with the frame, or NULL to hide it.
+ */
+void host_presenter_publish(host_presenter_t* presenter, const mda_point_t* cursor);
+
+/**
+ * @brief Present the last frame published, stop the thread and flush the sink.
+ * @return false if a write to the sink failed.
+ */
+bool host_presenter_stop(host_presenter_t* presenter);
+
+/**
+ * @brief Counts so far; exact once stopped.
+ */
+void host_presenter_stats(host_presenter_t* presenter, host_presenter_stats_t* stats);
+
+#endif /* HOST_PRESENTER_H */
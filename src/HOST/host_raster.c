@@ -0,0 +1,251 @@
+/**
+ * @file host_raster.c
+ * @brief Implementation of the MDA 9x14 Glyph Rasterizer
+ * @details Attributes reduce to six looks (raster_look()); the glyph cache
+ * holds each character in each look, drawn on first use under a lock and
+ * published with a release store, so lookups that hit take no lock.
+ *
+ * PNG needs zlib data, but not compression: stored deflate blocks are
+ * written with their own CRC-32 and Adler-32, so there is no dependency.
+ * At 2 bits per pixel the screen is 63 KB.
+ * @author Jeremy Thornton
+ */
+#include "host_raster.h"
+#include "host_screen.h"
+#include "../CONTRACT/contract.h"
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <string.h>
+
+#define RASTER_LOOKS            6
+#define RASTER_LOOK_HIDDEN      0
+#define RASTER_LOOK_REVERSE     1
+#define RASTER_LOOK_BRIGHT      1       /**< Added to RASTER_LOOK_TEXT */
+#define RASTER_LOOK_UNDERLINE   2       /**< Added to RASTER_LOOK_TEXT */
+#define RASTER_LOOK_TEXT        2
+#define RASTER_GLYPH_BYTES      (HOST_RASTER_CELL_W * HOST_RASTER_CELL_H)
+#define RASTER_STORED_MAX       65535   /**< Bytes in a stored deflate block */
+#define RASTER_WIDTH_MAX        (UINT8_MAX * HOST_RASTER_CELL_W)
+
+const host_raster_palette_t host_raster_green = { { { 0x00, 0x00, 0x00 }, { 0x28, 0xB0, 0x28 }, { 0x7C, 0xFF, 0x7C } } };
+const host_raster_palette_t host_raster_white = { { { 0x00, 0x00, 0x00 }, { 0xAA, 0xAA, 0xAA }, { 0xFF, 0xFF, 0xFF } } };
+
+static uint8_t raster_glyphs[256][RASTER_LOOKS][RASTER_GLYPH_BYTES];
+static atomic_uchar raster_ready[256][RASTER_LOOKS];
+static pthread_mutex_t raster_lock = PTHREAD_MUTEX_INITIALIZER;
+
+/**
+ * @brief Look of an attribute, as the MDA decodes it.
+ * @details 0x00 and 0x08 (and with blink) are not displayed, 0x70 is
+ * reverse video, anything else is text on black, bright if bit 3 is set
+ * and underlined if the foreground is 1.
+ */
+static uint8_t raster_look(uint8_t attr) {
+    switch (attr & 0x77) {
+    case 0x00:
+        return RASTER_LOOK_HIDDEN;
+    case 0x70:
+        return RASTER_LOOK_REVERSE;
+    default:
+        return RASTER_LOOK_TEXT + ((attr & MDA_BOLD) ? RASTER_LOOK_BRIGHT : 0)
+                                + (((attr & 0x07) == MDA_UNDERLINE) ? RASTER_LOOK_UNDERLINE : 0);
+    }
+}
+
+static void raster_draw_glyph(uint8_t chr, uint8_t look, uint8_t* glyph) {
+    uint8_t fg = (look & RASTER_LOOK_BRIGHT) ? HOST_RASTER_BRIGHT : HOST_RASTER_NORMAL;
+    uint8_t bg = HOST_RASTER_BLACK;
+    if (look == RASTER_LOOK_HIDDEN) {
+        memset(glyph, HOST_RASTER_BLACK, RASTER_GLYPH_BYTES);
+        return;
+    }
+    if (look == RASTER_LOOK_REVERSE) {
+        fg = HOST_RASTER_BLACK;
+        bg = HOST_RASTER_NORMAL;
+    }
+    bool line_graphics = chr >= 0xC0 && chr <= 0xDF;
+    for (uint8_t y = 0; y < HOST_RASTER_CELL_H; ++y) {
+        uint8_t bits = host_raster_font[chr][y];
+        bool underline = y == HOST_RASTER_UNDERLINE && look >= RASTER_LOOK_TEXT + RASTER_LOOK_UNDERLINE;
+        if (underline) {
+            bits = 0xFF;
+        }
+        uint8_t* row = glyph + y * HOST_RASTER_CELL_W;
+        for (uint8_t x = 0; x < HOST_RASTER_FONT_W; ++x) {
+            row[x] = (bits & (0x80 >> x)) ? fg : bg;
+        }
+        row[HOST_RASTER_FONT_W] = ((line_graphics || underline) && (bits & 0x01)) ? fg : bg;
+    }
+}
+
+/**
+ * @brief The glyph of chr in look, drawn if this is its first use.
+ */
+static const uint8_t* raster_glyph(uint8_t chr, uint8_t look) {
+    if (!atomic_load_explicit(&raster_ready[chr][look], memory_order_acquire)) {
+        pthread_mutex_lock(&raster_lock);
+        if (!atomic_load_explicit(&raster_ready[chr][look], memory_order_relaxed)) {
+            raster_draw_glyph(chr, look, raster_glyphs[chr][look]);
+            atomic_store_explicit(&raster_ready[chr][look], 1, memory_order_release);
+        }
+        pthread_mutex_unlock(&raster_lock);
+    }
+    return raster_glyphs[chr][look];
+}
+
+void host_raster_cells(const mda_cell_t* cells, uint8_t w, uint8_t h, uint8_t* pixels) {
+    require_address(cells, "NULL cells!");
+    require_address(pixels, "NULL pixels!");
+    size_t stride = (size_t)w * HOST_RASTER_CELL_W;
+    for (uint8_t y = 0; y < h; ++y) {
+        for (uint8_t x = 0; x < w; ++x) {
+            mda_cell_t cell = cells[y * w + x];
+            const uint8_t* glyph = raster_glyph((uint8_t)cell.chr, raster_look(cell.attr));
+            uint8_t* out = pixels + (size_t)y * HOST_RASTER_CELL_H * stride + (size_t)x * HOST_RASTER_CELL_W;
+            for (uint8_t row = 0; row < HOST_RASTER_CELL_H; ++row) {
+                memcpy(out + row * stride, glyph + row * HOST_RASTER_CELL_W, HOST_RASTER_CELL_W);
+            }
+        }
+    }
+}
+
+void host_raster_screen(uint8_t* pixels) {
+    host_raster_cells(host_screen_cells(), MDA_COLUMNS, MDA_ROWS, pixels);
+}
+
+bool host_raster_write_ppm(const char* path, const uint8_t* pixels, uint16_t width, uint16_t height,
+                           const host_raster_palette_t* palette) {
+    require_address(path, "NULL path!");
+    require_address(pixels, "NULL pixels!");
+    require_address(palette, "NULL palette!");
+    require(width <= RASTER_WIDTH_MAX, "PPM too wide!");
+    FILE* f = fopen(path, "wb");
+    if (f == NULL) {
+        return false;
+    }
+    fprintf(f, "P6\n%u %u\n255\n", width, height);
+    uint8_t rgb[RASTER_WIDTH_MAX * 3];
+    for (uint16_t y = 0; y < height; ++y) {
+        const uint8_t* row = pixels + (size_t)y * width;
+        for (uint16_t x = 0; x < width; ++x) {
+            memcpy(rgb + x * 3, palette->rgb[row[x]], 3);
+        }
+        fwrite(rgb, 3, width, f);
+    }
+    bool ok = !ferror(f);
+    return (fclose(f) == 0) && ok;
+}
+
+/**
+ * @brief PNG file being written: CRC-32 of the chunk, Adler-32 of the zlib data.
+ */
+typedef struct {
+    FILE* f;
+    uint32_t crc;
+    uint32_t adler_a;
+    uint32_t adler_b;
+} raster_png_t;
+
+static uint32_t raster_crc(uint32_t crc, const uint8_t* data, size_t n) {
+    static const uint32_t nibble[16] = {
+        0x00000000, 0x1DB71064, 0x3B6E20C8, 0x26D930AC, 0x76DC4190, 0x6B6B51F4, 0x4DB26158, 0x5005713C,
+        0xEDB88320, 0xF00F9344, 0xD6D6A3E8, 0xCB61B38C, 0x9B64C2B0, 0x86D3D2D4, 0xA00AE278, 0xBDBDF21C
+    };
+    crc = ~crc;
+    for (size_t i = 0; i < n; ++i) {
+        crc ^= data[i];
+        crc = (crc >> 4) ^ nibble[crc & 0x0F];
+        crc = (crc >> 4) ^ nibble[crc & 0x0F];
+    }
+    return ~crc;
+}
+
+static void raster_png_bytes(raster_png_t* png, const uint8_t* data, size_t n) {
+    png->crc = raster_crc(png->crc, data, n);
+    fwrite(data, 1, n, png->f);
+}
+
+static void raster_png_u32(raster_png_t* png, uint32_t value) {
+    uint8_t be[4] = { (uint8_t)(value >> 24), (uint8_t)(value >> 16), (uint8_t)(value >> 8), (uint8_t)value };
+    raster_png_bytes(png, be, 4);
+}
+
+static void raster_png_chunk_begin(raster_png_t* png, const char* type, uint32_t length) {
+    raster_png_u32(png, length);
+    png->crc = 0;
+    raster_png_bytes(png, (const uint8_t*)type, 4);
+}
+
+static void raster_png_chunk_end(raster_png_t* png) {
+    raster_png_u32(png, png->crc);
+}
+
+/**
+ * @brief Image data: bytes checksummed with Adler-32 as well.
+ */
+static void raster_png_data(raster_png_t* png, const uint8_t* data, size_t n) {
+    for (size_t i = 0; i < n; ++i) {
+        png->adler_a = (png->adler_a + data[i]) % 65521;
+        png->adler_b = (png->adler_b + png->adler_a) % 65521;
+    }
+    raster_png_bytes(png, data, n);
+}
+
+bool host_raster_write_png(const char* path, const uint8_t* pixels, uint16_t width, uint16_t height,
+                           const host_raster_palette_t* palette) {
+    static const uint8_t signature[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+    static const uint8_t zlib_header[2] = { 0x78, 0x01 };
+    require_address(path, "NULL path!");
+    require_address(pixels, "NULL pixels!");
+    require_address(palette, "NULL palette!");
+    require(width <= RASTER_WIDTH_MAX, "PNG too wide!");
+    raster_png_t png = { fopen(path, "wb"), 0, 1, 0 };
+    if (png.f == NULL) {
+        return false;
+    }
+    fwrite(signature, 1, sizeof(signature), png.f);
+    raster_png_chunk_begin(&png, "IHDR", 13);
+    raster_png_u32(&png, width);
+    raster_png_u32(&png, height);
+    const uint8_t ihdr[5] = { 2, 3, 0, 0, 0 };  // 2 bits, palette, deflate, no filter, no interlace
+    raster_png_bytes(&png, ihdr, sizeof(ihdr));
+    raster_png_chunk_end(&png);
+    raster_png_chunk_begin(&png, "PLTE", sizeof(palette->rgb));
+    raster_png_bytes(&png, &palette->rgb[0][0], sizeof(palette->rgb));
+    raster_png_chunk_end(&png);
+    // each row is a filter byte then 4 pixels a byte; the rows run through stored blocks
+    uint32_t row_bytes = 1 + (width + 3) / 4;
+    uint32_t raw = row_bytes * height;
+    uint32_t blocks = (raw + RASTER_STORED_MAX - 1) / RASTER_STORED_MAX;
+    raster_png_chunk_begin(&png, "IDAT", sizeof(zlib_header) + blocks * 5 + raw + 4);
+    raster_png_bytes(&png, zlib_header, sizeof(zlib_header));
+    uint8_t row[1 + (RASTER_WIDTH_MAX + 3) / 4];
+    uint32_t left = 0;                          // bytes left in the current block
+    uint32_t written = 0;
+    for (uint16_t y = 0; y < height; ++y) {
+        memset(row, 0, row_bytes);
+        for (uint16_t x = 0; x < width; ++x) {
+            row[1 + x / 4] |= pixels[(size_t)y * width + x] << (6 - (x % 4) * 2);
+        }
+        for (uint32_t i = 0; i < row_bytes; ) {
+            if (left == 0) {
+                left = (raw - written < RASTER_STORED_MAX) ? raw - written : RASTER_STORED_MAX;
+                const uint8_t stored[5] = { (written + left == raw) ? 1 : 0, (uint8_t)left, (uint8_t)(left >> 8),
+                                            (uint8_t)~left, (uint8_t)(~left >> 8) };
+                raster_png_bytes(&png, stored, sizeof(stored));
+            }
+            uint32_t n = (row_bytes - i < left) ? row_bytes - i : left;
+            raster_png_data(&png, row + i, n);
+            i += n;
+            left -= n;
+            written += n;
+        }
+    }
+    raster_png_u32(&png, (png.adler_b << 16) | png.adler_a);
+    raster_png_chunk_end(&png);
+    raster_png_chunk_begin(&png, "IEND", 0);
+    raster_png_chunk_end(&png);
+    bool ok = !ferror(png.f);
+    return (fclose(png.f) == 0) && ok;
+}
@@ -0,0 +1,93 @@
+/**
+ * @file host_raster.h
+ * @brief MDA 9x14 Glyph Rasterizer with PNG and PPM Export
+ * @details Draws cells as the MDA shows them, 720 x 350 for the screen, for
+ * bug reports and image based tests. .MDA dumps, the live screen and any
+ * cell buffer (a surface's cells) can be drawn.
+ *
+ * Characters are 9 x 14: 8 columns from the font and a ninth that repeats
+ * the eighth for 0xC0-0xDF, so horizontal box lines join, and is background
+ * for the rest. Attributes are decoded as the MDA does: intensity, underline
+ * on scan line 12, reverse video, and non-display for 0x00/0x08/0x80/0x88.
+ * Blinking cells are drawn in their visible phase.
+ *
+ * Each (character, attribute) pair is drawn once, on first use, into a
+ * cache of 9 x 14 pixel glyphs; a cell is then 14 row copies. Attributes
+ * that look the same share a glyph. The cache may be used from several
+ * threads.
+ *
+ * Pixels are one byte each, a host_raster_level_t; a palette turns levels
+ * into colours as the file is written.
+ *
+ * @note The font is drawn for this tree after the IBM MDA character ROM.
+ * @author Jeremy Thornton
+ */
+#ifndef HOST_RASTER_H
+#define HOST_RASTER_H
+
+#include "../MDA/mda_cell.h"
+#include "../MDA/mda_constants.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+#define HOST_RASTER_CELL_W      9
+#define HOST_RASTER_CELL_H      14
+#define HOST_RASTER_FONT_W      8                                   /**< Columns stored per font row */
+#define HOST_RASTER_UNDERLINE   12                                  /**< Scan line of the underline */
+#define HOST_RASTER_WIDTH       (MDA_COLUMNS * HOST_RASTER_CELL_W)  /**< 720 */
+#define HOST_RASTER_HEIGHT      (MDA_ROWS * HOST_RASTER_CELL_H)     /**< 350 */
+
+/**
+ * @enum host_raster_level_t
+ * @brief Brightness of a pixel.
+ */
+typedef enum {
+    HOST_RASTER_BLACK = 0,
+    HOST_RASTER_NORMAL,
+    HOST_RASTER_BRIGHT,
+    HOST_RASTER_LEVELS
+} host_raster_level_t;
+
+/**
+ * @struct host_raster_palette_t
+ * @brief RGB of each level.
+ */
+typedef struct {
+    uint8_t rgb[HOST_RASTER_LEVELS][3];
+} host_raster_palette_t;
+
+extern const host_raster_palette_t host_raster_green;  /**< P39 phosphor of the IBM 5151 */
+extern const host_raster_palette_t host_raster_white;  /**< Grey levels */
+
+/**
+ * @brief Font rows, bit 7 leftmost.
+ */
+extern const uint8_t host_raster_font[256][HOST_RASTER_CELL_H];
+
+/**
+ * @brief Draw w x h cells.
+ * @param pixels w * 9 by h * 14 bytes, rows top down.
+ */
+void host_raster_cells(const mda_cell_t* cells, uint8_t w, uint8_t h, uint8_t* pixels);
+
+/**
+ * @brief Draw the screen as displayed.
+ * @param pixels HOST_RASTER_WIDTH by HOST_RASTER_HEIGHT bytes.
+ */
+void host_raster_screen(uint8_t* pixels);
+
+/**
+ * @brief Write pixels as a binary PPM (P6).
+ * @return false if the file could not be written.
+ */
+bool host_raster_write_ppm(const char* path, const uint8_t* pixels, uint16_t width, uint16_t height,
+                           const host_raster_palette_t* palette);
+
+/**
+ * @brief Write pixels as a PNG: 2 bits per pixel, the palette as PLTE, stored deflate blocks.
+ * @return false if the file could not be written.
+ */
+bool host_raster_write_png(const char* path, const uint8_t* pixels, uint16_t width, uint16_t height,
+                           const host_raster_palette_t* palette);
+
+#endif /* HOST_RASTER_H */
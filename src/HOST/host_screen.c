@@ -0,0 +1,25 @@
+/**
+ * @file host_screen.c
+ * @brief Implementation of Headless Screen Access
+ * @author Jeremy Thornton
+ */
+#include "host_screen.h"
+#include "../BIOS/bios_video_services.h"
+#include "../CPU/cpu.h"
+#include "../MDA/mda_kernels.h"
+#include "../MDA/mda_primitives.h"
+#include "../CONTRACT/contract.h"
+
+mda_cell_t* host_screen_cells(void) {
+    mda_point_t origin = mda_point_make(0, 0);
+    return mda_as_pointer(&origin);
+}
+
+void host_screen_context(mda_context_t* ctx) {
+    require_address(ctx, "NULL context!");
+    mda_install_kernels(cpu_detect());
+    bios_set_cursor_type(0x0B, 0x0C);   // what setting the mode does, bar opening the terminal
+    bios_set_cursor_position(0, 0, 0);
+    mda_initialize_context(ctx);
+    mda_fill_screen(&ctx->blank);
+}
@@ -0,0 +1,32 @@
+/**
+ * @file host_screen.h
+ * @brief Headless Screen Access for Host Tools
+ * @details Tests, benchmarks and the image and presenter backends read the
+ * screen as one array of cells and set up a context without a terminal.
+ *
+ * The screen is read straight from the CRTC model (mda_crtc.h): the model
+ * holds the 4 KB text page followed by its mirror, as the MDA's address
+ * decoding repeats it, so the 80x25 screen is contiguous at any display
+ * start address, wrap included.
+ *
+ * @author Jeremy Thornton
+ */
+#ifndef HOST_SCREEN_H
+#define HOST_SCREEN_H
+
+#include "../MDA/mda_cell.h"
+#include "../MDA/mda_context.h"
+
+/**
+ * @brief The screen as shown: MDA_SCREEN_WORDS cells, rows top down.
+ */
+mda_cell_t* host_screen_cells(void);
+
+/**
+ * @brief mda_initialize_default_context() without bios_set_video_mode(),
+ * which would open the terminal: mda_initialize_context() over a blank
+ * page with the cursor home.
+ */
+void host_screen_context(mda_context_t* ctx);
+
+#endif /* HOST_SCREEN_H */
@@ -0,0 +1,321 @@
+/**
+ * @file host_terminal.c
+ * @brief Implementation of the Linux Terminal Backend
+ * @details The presenter runs from SIGALRM and from the main flow (waiting
+ * for a key); the main flow blocks SIGALRM while it presents, so frames
+ * never interleave. A frame may catch the model part way through a drawing
+ * call; the next frame, 20 ms later, shows it complete.
+ * @author Jeremy Thornton
+ */
+#include "host_terminal.h"
+#include "host_export.h"
+#include "../MDA/mda_crtc.h"
+#include "../MDA/mda_remote.h"
+#include "../BIOS/bios_keyboard_constants.h"
+#include <errno.h>
+#include <poll.h>
+#include <signal.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/time.h>
+#include <termios.h>
+#include <unistd.h>
+
+#define TERMINAL_CURSOR_OFF     0x20        /**< R10 bit 5: cursor disabled */
+#define TERMINAL_ESC            0x1B
+#define TERMINAL_ENTER_SCREEN   "\x1B[?1049h"
+#define TERMINAL_LEAVE_SCREEN   "\x1B[0m\x1B[?25h\x1B[?1049l"
+
+static bool terminal_open;
+static bool terminal_raw;                           // terminal_saved must be restored
+static struct termios terminal_saved;
+static mda_remote_t terminal_remote;
+static uint8_t terminal_queue[HOST_TERMINAL_QUEUE];
+static uint16_t terminal_keys[HOST_TERMINAL_KEYS];  // type-ahead ring
+static uint8_t terminal_key_head;
+static uint8_t terminal_key_count;
+static uint8_t terminal_input[32];                  // bytes read, not yet decoded
+static uint8_t terminal_input_count;
+static host_export_t terminal_export;               // TUI_EXPORT, if set
+
+/**
+ * @brief Send what changed in the model since the last frame.
+ */
+static void terminal_frame(void) {
+    const uint8_t* regs = mda_crtc_model.regs;
+    uint16_t start = (regs[MDA_CRTC_START_HI] << 8) | regs[MDA_CRTC_START_LO];
+    uint16_t offset = (((regs[MDA_CRTC_CURSOR_HI] << 8) | regs[MDA_CRTC_CURSOR_LO]) - start) & MDA_CRTC_WORD_MASK;
+    mda_point_t cursor = mda_point_make(offset % MDA_COLUMNS, offset / MDA_COLUMNS);
+    bool visible = !(regs[MDA_CRTC_CURSOR_START] & TERMINAL_CURSOR_OFF) && offset < MDA_SCREEN_WORDS;
+    mda_remote_frame(&terminal_remote, MDA_REMOTE_ALL_ROWS, visible ? &cursor : NULL);
+    if (terminal_export.map != NULL) {
+        host_export_present(&terminal_export, visible ? &cursor : NULL);
+    }
+}
+
+static void terminal_tick(int sig) {
+    int saved = errno;
+    (void)sig;
+    terminal_frame();
+    errno = saved;
+}
+
+/**
+ * @brief Restore the terminal on SIGINT or SIGTERM and exit.
+ */
+static void terminal_abort(int sig) {
+    if (terminal_raw) {
+        tcsetattr(STDIN_FILENO, TCSAFLUSH, &terminal_saved);
+    }
+    if (write(STDOUT_FILENO, TERMINAL_LEAVE_SCREEN, sizeof(TERMINAL_LEAVE_SCREEN) - 1) < 0) {
+        ;   // exiting regardless
+    }
+    _exit(128 + sig);
+}
+
+static void terminal_block(sigset_t* old) {
+    sigset_t alarm;
+    sigemptyset(&alarm);
+    sigaddset(&alarm, SIGALRM);
+    sigprocmask(SIG_BLOCK, &alarm, old);
+}
+
+void host_terminal_open(void) {
+    if (terminal_open) {
+        return;
+    }
+    if (tcgetattr(STDIN_FILENO, &terminal_saved) == 0) {
+        struct termios raw = terminal_saved;
+        raw.c_iflag &= ~(ICRNL | INLCR | IGNCR | IXON);
+        raw.c_lflag &= ~(ICANON | ECHO | IEXTEN);  // ISIG stays: Ctrl-C still interrupts
+        raw.c_cc[VMIN] = 1;
+        raw.c_cc[VTIME] = 0;
+        terminal_raw = tcsetattr(STDIN_FILENO, TCSAFLUSH, &raw) == 0;
+    }
+    if (write(STDOUT_FILENO, TERMINAL_ENTER_SCREEN, sizeof(TERMINAL_ENTER_SCREEN) - 1) < 0) {
+        ;   // the presenter reports nothing either; a dead terminal shows nothing
+    }
+    mda_remote_open(&terminal_remote, STDOUT_FILENO, 0, MDA_REMOTE_VT100, terminal_queue, HOST_TERMINAL_QUEUE);
+    const char* export_path = getenv("TUI_EXPORT");
+    if (export_path != NULL) {
+        host_export_open(&terminal_export, export_path);
+    }
+    terminal_open = true;
+    atexit(host_terminal_close);
+    struct sigaction action;
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = terminal_abort;
+    sigaction(SIGINT, &action, NULL);
+    sigaction(SIGTERM, &action, NULL);
+    action.sa_handler = terminal_tick;
+    action.sa_flags = SA_RESTART;
+    sigaction(SIGALRM, &action, NULL);
+    struct itimerval timer = { { 0, HOST_TERMINAL_FRAME_US }, { 0, HOST_TERMINAL_FRAME_US } };
+    setitimer(ITIMER_REAL, &timer, NULL);
+}
+
+void host_terminal_close(void) {
+    if (!terminal_open) {
+        return;
+    }
+    struct itimerval stop = { { 0, 0 }, { 0, 0 } };
+    setitimer(ITIMER_REAL, &stop, NULL);
+    signal(SIGALRM, SIG_DFL);
+    terminal_frame();
+    mda_remote_close(&terminal_remote);
+    if (terminal_export.map != NULL) {
+        host_export_close(&terminal_export);
+    }
+    if (write(STDOUT_FILENO, TERMINAL_LEAVE_SCREEN, sizeof(TERMINAL_LEAVE_SCREEN) - 1) < 0) {
+        ;   // nothing left to restore it on
+    }
+    if (terminal_raw) {
+        tcsetattr(STDIN_FILENO, TCSAFLUSH, &terminal_saved);
+        terminal_raw = false;
+    }
+    terminal_open = false;
+}
+
+void host_terminal_present(void) {
+    if (!terminal_open) {
+        return;
+    }
+    sigset_t old;
+    terminal_block(&old);
+    terminal_frame();
+    sigprocmask(SIG_SETMASK, &old, NULL);
+}
+
+void host_terminal_bell(void) {
+    sigset_t old;
+    terminal_block(&old);                           // not inside a frame
+    if (write(STDOUT_FILENO, "\a", 1) < 0) {
+        ;   // a bell is not worth failing over
+    }
+    sigprocmask(SIG_SETMASK, &old, NULL);
+}
+
+/**
+ * @brief Key word for a single byte.
+ */
+static uint16_t terminal_ascii_key(uint8_t c) {
+    switch (c) {
+        case '\r':
+        case '\n':
+            return (BIOS_SCAN_ENTER << 8) | '\r';
+        case '\b':
+        case 0x7F:
+            return (BIOS_SCAN_BACKSPACE << 8) | '\b';
+        case '\t':
+            return (BIOS_SCAN_TAB << 8) | '\t';
+        case TERMINAL_ESC:
+            return (BIOS_SCAN_ESC << 8) | TERMINAL_ESC;
+        default:
+            return (c < 0x80) ? c : 0;
+    }
+}
+
+/**
+ * @brief Scan code for the final byte and parameters of an escape sequence, 0 if unknown.
+ */
+static uint8_t terminal_scan(uint8_t final, uint8_t number, uint8_t modifier) {
+    bool ctrl = modifier == 5;
+    switch (final) {
+        case 'A': return BIOS_SCAN_UP;
+        case 'B': return BIOS_SCAN_DOWN;
+        case 'C': return ctrl ? BIOS_SCAN_CTRL_RIGHT : BIOS_SCAN_RIGHT;
+        case 'D': return ctrl ? BIOS_SCAN_CTRL_LEFT : BIOS_SCAN_LEFT;
+        case 'H': return ctrl ? BIOS_SCAN_CTRL_HOME : BIOS_SCAN_HOME;
+        case 'F': return ctrl ? BIOS_SCAN_CTRL_END : BIOS_SCAN_END;
+        case 'P':
+        case 'Q':
+        case 'R':
+        case 'S': return BIOS_SCAN_F1 + (final - 'P');         // F1..F10 are consecutive
+        case 'Z': return BIOS_SCAN_TAB;                         // Shift-Tab: ASCII 0
+        case '~':
+            switch (number) {
+                case 1:
+                case 7: return ctrl ? BIOS_SCAN_CTRL_HOME : BIOS_SCAN_HOME;
+                case 2: return BIOS_SCAN_INS;
+                case 3: return BIOS_SCAN_DEL;
+                case 4:
+                case 8: return ctrl ? BIOS_SCAN_CTRL_END : BIOS_SCAN_END;
+                case 5: return ctrl ? BIOS_SCAN_CTRL_PGUP : BIOS_SCAN_PGUP;
+                case 6: return ctrl ? BIOS_SCAN_CTRL_PGDN : BIOS_SCAN_PGDN;
+                default:
+                    if (number >= 11 && number <= 15) {
+                        return BIOS_SCAN_F1 + (number - 11);
+                    }
+                    if (number >= 17 && number <= 21) {
+                        return BIOS_SCAN_F1 + 5 + (number - 17);
+                    }
+                    return 0;
+            }
+        default:
+            return 0;
+    }
+}
+
+/**
+ * @brief Decode one key from the front of the input.
+ * @param key Set to the key word, or 0 for a sequence with no BIOS key.
+ * @return Bytes consumed, 0 if the input ends inside an escape sequence.
+ */
+static uint8_t terminal_decode(const uint8_t* in, uint8_t n, uint16_t* key) {
+    if (in[0] != TERMINAL_ESC) {
+        *key = terminal_ascii_key(in[0]);
+        return 1;
+    }
+    if (n == 1) {
+        return 0;
+    }
+    if (in[1] != '[' && in[1] != 'O') {             // Alt+key: taken as Esc, then the key
+        *key = terminal_ascii_key(TERMINAL_ESC);
+        return 1;
+    }
+    uint8_t params[2] = { 0, 0 };
+    uint8_t p = 0;
+    uint8_t i = 2;
+    for (; i < n && in[i] >= 0x30 && in[i] <= 0x3F; ++i) {     // parameter bytes
+        if (in[i] == ';') {
+            p = (p < 1) ? p + 1 : p;
+        }
+        else if (in[i] >= '0' && in[i] <= '9') {
+            params[p] = params[p] * 10 + (in[i] - '0');
+        }
+    }
+    if (i == n) {
+        return 0;
+    }
+    uint8_t scan = terminal_scan(in[i], params[0], params[1]);
+    *key = scan << 8;
+    return i + 1;
+}
+
+/**
+ * @brief Read what input is waiting, or wait up to timeout ms (-1 forever), and decode keys.
+ */
+static void terminal_poll(int timeout) {
+    struct pollfd fd = { STDIN_FILENO, POLLIN, 0 };
+    if (poll(&fd, 1, timeout) <= 0) {
+        return;
+    }
+    ssize_t n = read(STDIN_FILENO, terminal_input + terminal_input_count,
+                     sizeof(terminal_input) - terminal_input_count);
+    if (n == 0 && terminal_key_count < HOST_TERMINAL_KEYS) {  // end of input
+        terminal_keys[(terminal_key_head + terminal_key_count++) % HOST_TERMINAL_KEYS] = terminal_ascii_key(TERMINAL_ESC);
+        return;
+    }
+    if (n > 0) {
+        terminal_input_count += (uint8_t)n;
+    }
+    while (terminal_input_count > 0 && terminal_key_count < HOST_TERMINAL_KEYS) {
+        uint16_t key = 0;
+        uint8_t used = terminal_decode(terminal_input, terminal_input_count, &key);
+        if (used == 0) {
+            if (terminal_input_count < sizeof(terminal_input) && poll(&fd, 1, HOST_TERMINAL_ESC_MS) > 0
+                && (n = read(STDIN_FILENO, terminal_input + terminal_input_count,
+                             sizeof(terminal_input) - terminal_input_count)) > 0) {
+                terminal_input_count += (uint8_t)n;
+                continue;
+            }
+            key = terminal_ascii_key(TERMINAL_ESC);     // a lone or broken sequence
+            used = 1;
+        }
+        terminal_input_count -= used;
+        memmove(terminal_input, terminal_input + used, terminal_input_count);
+        if (key != 0) {
+            terminal_keys[(terminal_key_head + terminal_key_count++) % HOST_TERMINAL_KEYS] = key;
+        }
+    }
+}
+
+uint16_t host_terminal_read_key(void) {
+    host_terminal_present();                        // show what the caller is waiting on
+    while (terminal_key_count == 0) {
+        terminal_poll(-1);
+    }
+    uint16_t key = terminal_keys[terminal_key_head];
+    terminal_key_head = (terminal_key_head + 1) % HOST_TERMINAL_KEYS;
+    terminal_key_count--;
+    return key;
+}
+
+bool host_terminal_store_key(uint16_t key) {
+    if (terminal_key_count == HOST_TERMINAL_KEYS) {
+        return false;
+    }
+    terminal_keys[(terminal_key_head + terminal_key_count++) % HOST_TERMINAL_KEYS] = key;
+    return true;
+}
+
+bool host_terminal_peek_key(uint16_t* key) {
+    if (terminal_key_count == 0) {
+        terminal_poll(0);
+    }
+    if (terminal_key_count == 0) {
+        return false;
+    }
+    *key = terminal_keys[terminal_key_head];
+    return true;
+}
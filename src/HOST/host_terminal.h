@@ -0,0 +1,76 @@
+/**
+ * @file host_terminal.h
+ * @brief Linux Terminal Backend for the Host Build
+ * @details Stands in for the MDA monitor and keyboard when the tree is built
+ * for the host (cmake -DTUI_HOST=ON). The drawing primitives draw into the
+ * CRTC model (mda_crtc.h); a presenter shows the model on the controlling
+ * terminal 50 times a second from SIGALRM, and again whenever the program
+ * waits for a key, so the demos run unmodified at interactive rates.
+ *
+ * Each frame is diffed against what the terminal already shows and sent as
+ * one write() of VT100 cursor moves, SGR attributes and UTF-8, encoded by
+ * mda_remote.h. The cursor follows the CRTC cursor registers. With
+ * TUI_EXPORT set, each frame is also exported there (host_export.h).
+ *
+ * Keys are read from the same terminal in raw mode and decoded from their
+ * escape sequences into BIOS scan code : ASCII words, as INT 16h returns them.
+ * Printable keys have scan code 0 and non-ASCII input is ignored. At end of
+ * input (a pipe) every read returns Esc, so scripted runs finish. Keys
+ * stored with bios_store_keystroke() join the type-ahead as if typed, with
+ * or without a terminal open, so tests can script input headless.
+ *
+ * bios_set_video_mode() opens the terminal; it is restored at exit.
+ *
+ * @author Jeremy Thornton
+ */
+#ifndef HOST_TERMINAL_H
+#define HOST_TERMINAL_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define HOST_TERMINAL_FRAME_US  20000   /**< Presenter period: 50 frames a second */
+#define HOST_TERMINAL_KEYS      16      /**< Type-ahead, as the BIOS buffer */
+#define HOST_TERMINAL_ESC_MS    25      /**< A lone ESC is the Esc key after this long */
+#define HOST_TERMINAL_QUEUE     32768   /**< Bytes of output per frame at most */
+
+/**
+ * @brief Switch the terminal to raw mode and the alternate screen and start presenting.
+ * @details Does nothing if already open.
+ */
+void host_terminal_open(void);
+
+/**
+ * @brief Present a last frame and restore the terminal.
+ */
+void host_terminal_close(void);
+
+/**
+ * @brief Show the CRTC model on the terminal now.
+ */
+void host_terminal_present(void);
+
+/**
+ * @brief Wait for a key and remove it from the type-ahead.
+ * @return Scan code : ASCII.
+ */
+uint16_t host_terminal_read_key(void);
+
+/**
+ * @brief Peek at the next key without removing it.
+ * @return false if no key is waiting.
+ */
+bool host_terminal_peek_key(uint16_t* key);
+
+/**
+ * @brief Add a key to the end of the type-ahead.
+ * @return false if the type-ahead is full.
+ */
+bool host_terminal_store_key(uint16_t key);
+
+/**
+ * @brief Sound the terminal bell.
+ */
+void host_terminal_bell(void);
+
+#endif /* HOST_TERMINAL_H */
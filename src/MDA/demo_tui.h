@@ -4,8 +4,37 @@
 #include "mda_cell.h"
 #include "mda_primitives.h"
 #include "mda_context.h"
+#include "mda_list_view.h"
+#include "mda_pager.h"
+#include "mda_scrollback.h"
+#include "mda_display_list.h"
+#include "mda_surface.h"
+#include "mda_canvas.h"
+#include "mda_strip_chart.h"
+#include "mda_border.h"
+#include "mda_pattern.h"
+#include "mda_printf.h"
+#include "mda_markup.h"
+#include "mda_layout.h"
+#include "mda_editor.h"
+#include "mda_line_edit.h"
+#include "mda_clock.h"
+#include "mda_recorder.h"
+#include "mda_player.h"
+#include "mda_trace.h"
+#include "mda_remote.h"
+#include "../BIOS/bios_keyboard_services.h"
 #include "cp437_constants.h"
 #include <stdio.h>
+#include <string.h>
+#ifndef __DOS__
+#include "../HOST/host_presenter.h"
+#include "../HOST/host_raster.h"
+#include <fcntl.h>
+#include <strings.h>
+#include <unistd.h>
+#define strnicmp strncasecmp
+#endif
 
 void demo_mda_ptr(mda_context_t* ctx) {
     mda_point_t p = mda_point_make(20, 10);
@@ -219,4 +248,538 @@ void demo_scroll (mda_context_t *ctx) {
     }
 }
 
+static void demo_list_row(uint32_t index, char* text, uint8_t width, void* user) {
+    snprintf(text, width + 1, "Record %05lu", (unsigned long)index);
+}
+
+void demo_list_view(mda_context_t *ctx) {
+    static mda_list_view_t view;    // ~5K cache, keep it off the stack
+    mda_rect_t r = mda_rect_make(20, 2, 40, 20);
+
+    mda_clear_screen();
+    mda_list_view_init(&view, &r, 50000UL, demo_list_row, NULL);
+    mda_list_view_draw(&view);
+
+    char k = getchar();
+    while(k != 'q') {
+        switch(k) {
+            case 'w':
+                mda_list_view_up(&view);
+                break;
+            case 's':
+                mda_list_view_down(&view);
+                break;
+            case 'a':
+                mda_list_view_page_up(&view);
+                break;
+            case 'd':
+                mda_list_view_page_down(&view);
+                break;
+        };
+        k = getchar();
+    }
+}
+
+void demo_pager(mda_context_t *ctx) {
+    static mda_pager_t pager;   // block cache, keep it off the stack
+    mda_rect_t r = mda_rect_make(0, 0, 80, 25);
+
+    if (!mda_pager_open(&pager, "TUI.MAP", &r)) {
+        printf("FAIL to open TUI.MAP\n");
+        return;
+    }
+    mda_pager_draw(&pager);
+
+    char k = getchar();
+    while(k != 'q') {
+        switch(k) {
+            case 'w':
+                mda_pager_line_up(&pager);
+                break;
+            case 's':
+                mda_pager_line_down(&pager);
+                break;
+            case 'a':
+                mda_pager_page_up(&pager);
+                break;
+            case 'd':
+                mda_pager_page_down(&pager);
+                break;
+            case 'g':
+                mda_pager_home(&pager);
+                break;
+            case 'G':
+                mda_pager_end(&pager);
+                break;
+            case '5':
+                mda_pager_seek_percent(&pager, 50);
+                break;
+        };
+        k = getchar();
+    }
+    mda_pager_close(&pager);
+}
+
+void demo_scrollback(mda_context_t *ctx) {
+    static uint8_t history[8192];
+    mda_scrollback_t sb;
+    char line[32];
+
+    mda_scrollback_init(&sb, history, sizeof(history));
+    mda_set_scrollback(ctx, &sb);
+    for(int i = 0; i < 200; ++i) {
+        sprintf(line, "Console line %d\\r\\n", i);
+        mda_print_string(ctx, line);
+    }
+
+    mda_scrollback_enter(&sb, &ctx->bounds, &ctx->blank);
+    char k = getchar();
+    while(k != 'q') {
+        switch(k) {
+            case 'w':
+                mda_scrollback_scroll(&sb, &ctx->bounds, &ctx->blank, -1);
+                break;
+            case 's':
+                mda_scrollback_scroll(&sb, &ctx->bounds, &ctx->blank, 1);
+                break;
+            case 'a':
+                mda_scrollback_scroll(&sb, &ctx->bounds, &ctx->blank, -ctx->bounds.h);
+                break;
+            case 'd':
+                mda_scrollback_scroll(&sb, &ctx->bounds, &ctx->blank, ctx->bounds.h);
+                break;
+        };
+        k = getchar();
+    }
+    mda_scrollback_leave(&sb, &ctx->bounds, &ctx->blank);
+    mda_set_scrollback(ctx, NULL);
+}
+
+void demo_hw_scroll(mda_context_t *ctx) {
+    char line[40];
+    mda_set_hw_scroll(ctx, true);
+    for(int i = 0; i < 500; ++i) {
+        sprintf(line, "Hardware scrolled line %d\\r\\n", i);
+        mda_print_string(ctx, line);
+    }
+    getchar();
+    mda_set_hw_scroll(ctx, false);
+}
+
+void demo_display_list(mda_context_t* ctx) {
+    mda_draw_cmd_t cmds[64];
+    mda_display_list_t dl;
+    mda_cell_t shade = mda_cell_make(CP437_LIGHT_SHADE, MDA_NORMAL);
+    mda_cell_t field = mda_cell_make(' ', MDA_REVERSE);
+    mda_cell_t frame = mda_cell_make('#', MDA_NORMAL | MDA_BOLD);
+    mda_rect_t screen = mda_rect_make(0, 0, MDA_COLUMNS, MDA_ROWS);
+    mda_rect_t form = mda_rect_make(10, 4, 60, 16);
+    mda_display_list_init(&dl, cmds, 64);
+    mda_display_list_fill_rect(&dl, &screen, &shade);
+    mda_display_list_fill_rect(&dl, &form, &ctx->blank);
+    mda_display_list_rect(&dl, &form, &frame);
+    for(uint8_t y = 6; y < 18; y += 2) {
+        mda_point_t p0 = mda_point_make(30, y);
+        mda_point_t p1 = mda_point_make(65, y);
+        mda_display_list_hline(&dl, &p0, &p1, &field);
+    }
+    mda_display_list_submit(&dl);
+}
+
+void demo_surface(mda_context_t* ctx) {
+    mda_surface_store_t store;
+    mda_surface_t screens[8];
+    mda_rect_t screen = mda_rect_make(0, 0, MDA_COLUMNS, MDA_ROWS);
+    mda_point_t origin = mda_point_make(0, 0);
+    if (!mda_surface_store_init(&store, 64, MDA_SURFACE_ANY)) {
+        printf("FAIL to reserve surface memory\n");
+        return;
+    }
+    for(int i = 0; i < 8; ++i) {    // compose and cache 8 screens
+        mda_cell_t cell = mda_cell_make('0' + i, MDA_NORMAL);
+        mda_fill_screen(&cell);
+        mda_surface_create(&store, &screens[i], MDA_COLUMNS, MDA_ROWS);
+        mda_surface_capture(&screens[i], &screen);
+    }
+    char k = getchar();
+    while(k != 'q') {
+        if (k >= '0' && k <= '7') {
+            mda_surface_present(&screens[k - '0'], &origin);
+        }
+        k = getchar();
+    }
+    mda_surface_store_release(&store);
+}
+
+void demo_canvas(mda_context_t* ctx) {
+    static mda_canvas_t canvas;
+    static const uint8_t ball[] = { 0x3C, 0x7E, 0xFF, 0xFF, 0x7E, 0x3C };
+    mda_rect_t screen = mda_rect_make(0, 0, MDA_COLUMNS, MDA_ROWS);
+    int16_t x = 36;
+    int16_t y = 22;
+    mda_canvas_init(&canvas, &screen, ctx->attributes);
+    mda_canvas_line(&canvas, 0, 0, 79, 49, MDA_CANVAS_SET);
+    mda_canvas_line(&canvas, 79, 0, 0, 49, MDA_CANVAS_SET);
+    mda_canvas_fill_rect(&canvas, 0, 46, 80, 4, MDA_CANVAS_SET);
+    mda_canvas_blit(&canvas, ball, 8, 6, x, y, MDA_CANVAS_XOR);
+    mda_canvas_present(&canvas);
+    char k = getchar();
+    while(k != 'q') {
+        mda_canvas_blit(&canvas, ball, 8, 6, x, y, MDA_CANVAS_XOR);  // erase
+        switch(k) {
+            case 'w': y--; break;
+            case 's': y++; break;
+            case 'a': x--; break;
+            case 'd': x++; break;
+        };
+        mda_canvas_blit(&canvas, ball, 8, 6, x, y, MDA_CANVAS_XOR);
+        mda_canvas_present(&canvas);    // only the rows the ball touched
+        k = getchar();
+    }
+}
+
+void demo_strip_chart(mda_context_t* ctx) {
+    static mda_strip_chart_t chart;
+    static mda_strip_chart_t spark;
+    mda_rect_t r0 = mda_rect_make(0, 2, MDA_COLUMNS, 20);
+    mda_rect_t r1 = mda_rect_make(0, 23, MDA_COLUMNS, 1);
+    int16_t values[2] = { 50, 20 };
+    mda_strip_chart_init(&chart, &r0, 2, 1, MDA_STRIP_MEAN);
+    mda_strip_chart_set_series(&chart, 0, 0, 100, MDA_NORMAL, true);
+    mda_strip_chart_set_series(&chart, 1, 0, 100, MDA_NORMAL | MDA_BOLD, false);
+    mda_strip_chart_init(&spark, &r1, 1, 4, MDA_STRIP_PEAK);
+    mda_strip_chart_draw(&chart);
+    mda_strip_chart_draw(&spark);
+    char k = getchar();
+    while(k != 'q') {
+        switch(k) {
+            case 'w': values[0] += 5; break;
+            case 's': values[0] -= 5; break;
+            case 'a': values[1] -= 5; break;
+            case 'd': values[1] += 5; break;
+        };
+        mda_strip_chart_push(&chart, values);   // one scroll + one column
+        mda_strip_chart_push(&spark, values);   // a column every 4 samples
+        k = getchar();
+    }
+}
+
+void demo_border(mda_context_t* ctx) {
+    mda_rect_t frame = mda_rect_make(5, 3, 41, 11);
+    mda_rect_t popup = mda_rect_make(30, 9, 30, 8);
+    mda_cell_t cells[8];
+    mda_border_rect(&frame, MDA_BORDER_DOUBLE, MDA_BORDER_DOUBLE, ctx->attributes);
+    for(uint8_t y = 5; y < 13; y += 2) {    // table rows
+        mda_point_t p0 = mda_point_make(5, y);
+        mda_point_t p1 = mda_point_make(45, y);
+        mda_border_hline(&p0, &p1, MDA_BORDER_SINGLE, ctx->attributes);
+    }
+    for(uint8_t x = 15; x < 45; x += 10) {  // table columns
+        mda_point_t p0 = mda_point_make(x, 3);
+        mda_point_t p1 = mda_point_make(x, 13);
+        mda_border_vline(&p0, &p1, MDA_BORDER_SINGLE, ctx->attributes);
+    }
+    mda_border_rect(&popup, MDA_BORDER_SINGLE, MDA_BORDER_DOUBLE, ctx->attributes);
+    mda_border_cells(MDA_BORDER_DOUBLE, MDA_BORDER_SINGLE, ctx->attributes, cells);
+    frame = mda_rect_make(5, 18, 20, 5);
+    mda_draw_border(&frame, cells);         // plain frame, no merging
+    getchar();
+}
+
+void demo_pattern(mda_context_t* ctx) {
+    mda_rect_t screen = mda_rect_make(0, 0, MDA_COLUMNS, MDA_ROWS);
+    mda_rect_t bar = mda_rect_make(10, 20, 60, 1);
+    mda_cell_t checker[4] = {   // 2x2 dither
+        mda_shade_cell(1, ctx->attributes), mda_shade_cell(3, ctx->attributes),
+        mda_shade_cell(3, ctx->attributes), mda_shade_cell(1, ctx->attributes)
+    };
+    mda_fill_pattern(&screen, checker, 2, 2);
+    mda_rect_t r = mda_rect_make(10, 4, 60, 5);
+    mda_fill_hgradient(&r, 0, 4, ctx->attributes);
+    r = mda_rect_make(10, 10, 60, 8);
+    mda_fill_vgradient(&r, 4, 0, ctx->attributes);
+    uint8_t done = 0;
+    char k = getchar();
+    while(k != 'q') {
+        switch(k) {
+            case 'a': if (done > 0) done--; break;
+            case 'd': if (done < bar.w) done++; break;
+        };
+        r = mda_rect_make(bar.x, bar.y, done, 1);
+        mda_fill_hgradient(&r, 1, 4, ctx->attributes);     // progress shading
+        r = mda_rect_make(bar.x + done, bar.y, bar.w - done, 1);
+        mda_fill_pattern(&r, checker, 2, 1);
+        k = getchar();
+    }
+}
+
+void demo_printf(mda_context_t* ctx) {
+    uint16_t tick = 0;
+    int16_t temp = 2150;    // hundredths of a degree
+    long bytes = 0;
+    char k = 0;
+    while(k != 'q') {
+        for(uint8_t y = 0; y < 20; ++y) {   // dozens of fields per tick
+            mda_point_t p = mda_point_make(0, y);
+            mda_printf_at(&p, 12, ctx->attributes, "tick %5u", tick + y);
+            p.x = 14;
+            mda_printf_at(&p, 14, ctx->attributes, "temp %+6.2F", temp - y * 37);
+            p.x = 30;
+            mda_printf_at(&p, 16, ctx->attributes | MDA_BOLD, "rx %08lX", bytes + y);
+            p.x = 48;
+            mda_printf_at(&p, 10, ctx->attributes, "%-10s", (y & 1) ? "odd" : "even");
+        }
+        switch(k) {
+            case 'w': temp += 25; break;
+            case 's': temp -= 25; break;
+        };
+        tick++;
+        bytes += 1460;
+        k = getchar();
+    }
+}
+
+void demo_markup(mda_context_t* ctx) {
+    static char text[1024];
+    static mda_markup_run_t runs[64];
+    mda_markup_t help;
+    mda_rect_t r = mda_rect_make(10, 3, 40, 15);
+    mda_markup_init(&help, text, sizeof(text), runs, 64);
+    mda_markup_compile(&help,   // compiled once, redrawn from the run list
+        "{r} HELP {/r}\n\n"
+        "Press {b}F1{/b} for this screen, {b}Esc{/b} to leave it. "
+        "Use {u}w{/u} and {u}s{/u} to narrow and widen the panel; "
+        "the text is re-wrapped from the same runs every time. "
+        "{f}Blinking{/f} text, {r}{b}bold reverse{/b}{/r} and {{braces} all survive wrapping.",
+        ctx->attributes);
+    mda_markup_draw(&help, 0, &r, &ctx->blank);
+    char k = getchar();
+    while(k != 'q') {
+        switch(k) {
+            case 'w': if (r.w > 10) r.w--; break;
+            case 's': if (r.w < 60) r.w++; break;
+        };
+        r.w++;                                  // clear the column left behind
+        mda_fill_rect(&r, &ctx->blank);
+        r.w--;
+        mda_markup_draw(&help, 0, &r, &ctx->blank);
+        k = getchar();
+    }
+}
+
+void demo_layout(mda_context_t* ctx) {
+    static char text[512] =
+        "Paragraphs are wrapped at word boundaries and aligned in one pass. "
+        "Press a letter to insert it at the end of this first paragraph and "
+        "watch only the rows from here down being redrawn.\n"
+        "The second paragraph only moves when the first one grows a line.";
+    static mda_layout_line_t lines[32];
+    mda_layout_t layout;
+    mda_rect_t r = mda_rect_make(20, 5, 40, 10);
+    uint16_t at = strchr(text, '\n') - text;   // end of the first paragraph
+    uint16_t length = strlen(text);
+    mda_layout_init(&layout, &r, MDA_ALIGN_JUSTIFY, &ctx->blank, lines, 32);
+    mda_layout_set_text(&layout, text, length);
+    mda_layout_draw(&layout);
+    char k = getchar();
+    while(k != 'q') {
+        if (k >= ' ' && k <= '~' && (size_t)length + 1 < sizeof(text)) {
+            memmove(text + at + 1, text + at, length - at + 1);
+            text[at] = k;
+            mda_layout_edit(&layout, text, ++length, at++);
+            mda_layout_draw(&layout);
+        }
+        k = getchar();
+    }
+}
+
+void demo_editor(mda_context_t* ctx) {
+    static char buffer[16384];
+    static uint16_t lines[1024];
+    static const char sample[] = "FILES=30\nBUFFERS=20\nDEVICE=C:\\DOS\\HIMEM.SYS\nDOS=HIGH\n";
+    mda_editor_t ed;
+    mda_rect_t r = mda_rect_make(0, 1, MDA_COLUMNS, MDA_ROWS - 2);
+    mda_editor_init(&ed, &r, &ctx->blank, buffer, sizeof(buffer), lines, 1024);
+    if (!mda_editor_load(&ed, "CONFIG.SYS")) {
+        mda_editor_set_text(&ed, sample, sizeof(sample) - 1);
+    }
+    mda_editor_draw(&ed);
+    uint16_t key = bios_read_keystroke();
+    while(BIOS_KEY_SCAN(key) != BIOS_SCAN_ESC) {
+        if (BIOS_KEY_SCAN(key) == BIOS_SCAN_F2) {
+            mda_editor_save(&ed, "CONFIG.NEW");
+        }
+        else {
+            mda_editor_key(&ed, key);   // redraws only what the key changed
+        }
+        mda_point_t status = mda_point_make(0, MDA_ROWS - 1);
+        mda_printf_at(&status, MDA_COLUMNS, MDA_REVERSE, " Ln %u Col %u %s  F2 save  Esc quit",
+                      ed.row + 1, ed.col + 1, ed.modified ? "*" : " ");
+        key = bios_read_keystroke();
+    }
+}
+
+static const char* demo_commands[] = { "CHDIR", "CHKDSK", "CLS", "COPY", "DEL", "DIR", "ECHO", "EDIT", "EXIT" };
+
+static const char* demo_complete(const char* word, uint8_t length, uint8_t index, void* user) {
+    (void)user;
+    for (uint8_t i = 0; i < sizeof(demo_commands) / sizeof(demo_commands[0]); ++i) {
+        if (strnicmp(demo_commands[i], word, length) == 0 && index-- == 0) {
+            return demo_commands[i];
+        }
+    }
+    return NULL;
+}
+
+void demo_line_edit(mda_context_t* ctx) {
+    static mda_line_history_t history;
+    mda_line_edit_t le;
+    mda_point_t prompt = mda_point_make(0, MDA_ROWS - 1);
+    mda_point_t field = mda_point_make(3, MDA_ROWS - 1);
+    mda_point_t echo = mda_point_make(0, 0);
+    mda_line_history_init(&history);
+    mda_line_edit_init(&le, &field, 40, &ctx->blank, &history, demo_complete, NULL);
+    mda_printf_at(&prompt, 3, MDA_BOLD, "C>");
+    mda_line_edit_set_text(&le, "");
+    mda_line_status_t status = MDA_LINE_EDITING;
+    while(status != MDA_LINE_CANCEL) {
+        status = mda_line_edit_key(&le, bios_read_keystroke());
+        if (status == MDA_LINE_DONE) {
+            mda_printf_at(&echo, MDA_COLUMNS, ctx->attributes, "> %s", le.text);
+            echo.y = (echo.y + 1) % (MDA_ROWS - 1);
+            mda_line_edit_set_text(&le, "");
+        }
+    }
+}
+
+void demo_recorder(mda_context_t* ctx) {
+    static uint8_t buffer[4096];
+    static mda_recorder_t rec;
+    static mda_player_t player;
+    static mda_player_key_t keys[64];
+    mda_line_edit_t le;
+    mda_point_t field = mda_point_make(0, MDA_ROWS - 1);
+    mda_clock_init();
+    mda_line_edit_init(&le, &field, MDA_COLUMNS, &ctx->blank, NULL, NULL, NULL);
+    mda_line_edit_set_text(&le, "Type, then Esc to replay at 2x");
+    if (!mda_recorder_open(&rec, "SESSION.MDR", buffer, sizeof(buffer))) {
+        return;
+    }
+    mda_recorder_frame(&rec, MDA_RECORD_ALL_ROWS);
+    while(mda_line_edit_key(&le, bios_read_keystroke()) != MDA_LINE_CANCEL) {
+        mda_recorder_frame(&rec, 1UL << field.y);   // only the field row can have changed
+    }
+    mda_recorder_close(&rec);
+    if (mda_player_open(&player, "SESSION.MDR", keys, 64)) {
+        mda_player_play(&player, 2 * MDA_PLAYER_REAL_TIME, NULL, NULL);
+        mda_player_close(&player);
+    }
+}
+
+/**
+ * @brief Trace a short console session for TOOLS/REPLAY.
+ * @note Build with -DTUI_TRACE=ON, otherwise the trace holds only the screen.
+ */
+void demo_trace(mda_context_t* ctx) {
+    static uint8_t buffer[4096];
+    mda_rect_t box = mda_rect_make(50, 2, 24, 8);
+    mda_cell_t shade = mda_cell_make(CP437_LIGHT_SHADE, MDA_NORMAL);
+    if (!mda_trace_open("TRACE.TRC", buffer, sizeof(buffer))) {
+        return;
+    }
+    mda_FF(ctx);
+    for (int i = 0; i < 100; ++i) {
+        mda_print_string(ctx, "The quick brown fox jumps over the lazy dog.\t");
+        if (i % 10 == 0) {
+            mda_fill_rect(&box, &shade);
+            mda_trace_frame();
+        }
+    }
+    mda_trace_close();
+}
+
+/**
+ * @brief Mirror the line editor to a VT100 terminal on COM1 at 9600 baud.
+ */
+void demo_remote(mda_context_t* ctx) {
+    static uint8_t queue[256];
+    static mda_remote_t remote;
+    mda_line_edit_t le;
+    mda_point_t field = mda_point_make(0, MDA_ROWS - 1);
+    mda_point_t cursor;
+    uint16_t key;
+    if (!mda_remote_open(&remote, 1, 9600, MDA_REMOTE_VT100, queue, sizeof(queue))) {
+        return;
+    }
+    mda_line_edit_init(&le, &field, MDA_COLUMNS, &ctx->blank, NULL, NULL, NULL);
+    mda_line_edit_set_text(&le, "Type and watch the terminal, Esc to stop");
+    do {
+        cursor = mda_point_make(field.x + le.cursor - le.left, field.y);
+        mda_remote_frame(&remote, MDA_REMOTE_ALL_ROWS, &cursor);
+        while (!bios_check_keystroke(&key)) {      // send what did not fit while waiting
+            mda_remote_frame(&remote, 0, &cursor);
+        }
+    } while (mda_line_edit_key(&le, bios_read_keystroke()) != MDA_LINE_CANCEL);
+    mda_remote_close(&remote);
+}
+
+#ifndef __DOS__
+/**
+ * @brief Host build: draw 2000 frames while a presenter thread writes them to PRESENT.VT.
+ * @details cat PRESENT.VT in a terminal replays what the presenter kept.
+ */
+void demo_presenter(mda_context_t* ctx) {
+    static host_presenter_t presenter;
+    host_presenter_stats_t stats;
+    mda_cell_t shade = mda_cell_make(CP437_LIGHT_SHADE, MDA_NORMAL);
+    mda_cell_t box = mda_cell_make(CP437_FULL_BLOCK, MDA_NORMAL | MDA_BOLD);
+    mda_point_t status = mda_point_make(0, MDA_ROWS - 1);
+    int fd = open("PRESENT.VT", O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        return;
+    }
+    mda_clock_init();
+    host_presenter_start(&presenter, fd, MDA_REMOTE_VT100);
+    uint32_t start = mda_clock_us();
+    for (uint16_t i = 0; i < 2000; ++i) {
+        mda_rect_t r = mda_rect_make(i % (MDA_COLUMNS - 10), (i / 7) % (MDA_ROWS - 6), 10, 5);
+        mda_fill_screen(&shade);
+        mda_fill_rect(&r, &box);
+        mda_printf_at(&status, MDA_COLUMNS, ctx->attributes, "frame %u", i);
+        host_presenter_publish(&presenter, NULL);
+    }
+    uint32_t elapsed = mda_clock_us() - start;
+    host_presenter_stop(&presenter);
+    close(fd);
+    host_presenter_stats(&presenter, &stats);
+    mda_printf_at(&status, MDA_COLUMNS, ctx->attributes,
+                  "%lu fps drawn, %lu/%lu presented, %lu dropped, latency mean %lu max %lu us",
+                  (unsigned long)(2000000000ULL / (elapsed ? elapsed : 1)),
+                  (unsigned long)stats.presented, (unsigned long)stats.published, (unsigned long)stats.dropped,
+                  (unsigned long)stats.latency_mean_us, (unsigned long)stats.latency_max_us);
+    bios_read_keystroke();
+}
+
+/**
+ * @brief Host build: draw each attribute in a double box and save the screen as SCREEN.PNG.
+ */
+void demo_raster(mda_context_t* ctx) {
+    static uint8_t pixels[HOST_RASTER_WIDTH * HOST_RASTER_HEIGHT];
+    static const uint8_t attrs[] = { MDA_NORMAL, MDA_NORMAL | MDA_BOLD, MDA_UNDERLINE, MDA_UNDERLINE | MDA_BOLD,
+                                     MDA_REVERSE, MDA_NORMAL | MDA_BLINK, MDA_INVISIBLE };
+    mda_rect_t r = mda_rect_make(10, 4, 60, 2 + sizeof(attrs));
+    mda_point_t p = mda_point_make(12, 5);
+    mda_fill_screen(&ctx->blank);
+    mda_border_rect(&r, MDA_BORDER_DOUBLE, MDA_BORDER_DOUBLE, ctx->attributes);
+    for (uint8_t i = 0; i < sizeof(attrs); ++i, ++p.y) {
+        mda_printf_at(&p, 56, attrs[i], "attribute %02X: The quick brown fox", attrs[i]);
+    }
+    host_raster_screen(pixels);
+    bool saved = host_raster_write_png("SCREEN.PNG", pixels, HOST_RASTER_WIDTH, HOST_RASTER_HEIGHT, &host_raster_green);
+    p.y = r.y + r.h + 1;
+    mda_printf_at(&p, 56, ctx->attributes, saved ? "saved SCREEN.PNG" : "cannot write SCREEN.PNG");
+    bios_read_keystroke();
+}
+#endif
+
 #endif
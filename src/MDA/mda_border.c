@@ -0,0 +1,148 @@
+/**
+ * @file mda_border.c
+ * @brief Implementation of the Box-Drawing Border Engine
+ * @details A line is one pass over VRAM: each cell is read, its arms
+ * decoded, the line's arms written in and the merged glyph stored back.
+ * @author Jeremy Thornton
+ */
+#include "mda_border.h"
+#include "mda_constants.h"
+#include "mda_primitives.h"
+#include "cp437_constants.h"
+#include "../CONTRACT/contract.h"
+#include <stdbool.h>
+
+#define BORDER_FIRST    CP437_BOX_VERTICAL      // 0xB3, first box glyph
+#define BORDER_LAST     CP437_BOX_DOWN_RIGHT    // 0xDA, last box glyph
+
+/**
+ * @brief Arms of glyphs 0xB3..0xDA (N | E << 2 | S << 4 | W << 6).
+ */
+static const uint8_t border_decode[BORDER_LAST - BORDER_FIRST + 1] = {
+    0x11, 0x51, 0x91, 0x62, 0x60, 0x90, 0xA2, 0x22,   // │ ┤ ╡ ╢ ╖ ╕ ╣ ║
+    0xA0, 0x82, 0x42, 0x81, 0x50, 0x05, 0x45, 0x54,   // ╗ ╝ ╜ ╛ ┐ └ ┴ ┬
+    0x15, 0x44, 0x55, 0x19, 0x26, 0x0A, 0x28, 0x8A,   // ├ ─ ┼ ╞ ╟ ╚ ╔ ╩
+    0xA8, 0x2A, 0x88, 0xAA, 0x89, 0x46, 0x98, 0x64,   // ╦ ╠ ═ ╬ ╧ ╨ ╤ ╥
+    0x06, 0x09, 0x18, 0x24, 0x66, 0x99, 0x41, 0x14    // ╙ ╘ ╒ ╓ ╫ ╪ ┘ ┌
+};
+
+/**
+ * @brief Glyph for every arms byte; combinations CP437 lacks resolve to
+ * the nearest glyph and arm weight 3 is unused.
+ */
+static const uint8_t border_encode[256] = {
+    0x20, 0xB3, 0xBA, 0x20, 0xC4, 0xC0, 0xD3, 0x20, 0xCD, 0xD4, 0xC8, 0x20, 0x20, 0x20, 0x20, 0x20,   // W=0 S=0
+    0xB3, 0xB3, 0xBA, 0x20, 0xDA, 0xC3, 0xC7, 0x20, 0xD5, 0xC6, 0xCC, 0x20, 0x20, 0x20, 0x20, 0x20,   // W=0 S=1
+    0xBA, 0xBA, 0xBA, 0x20, 0xD6, 0xC7, 0xC7, 0x20, 0xC9, 0xCC, 0xCC, 0x20, 0x20, 0x20, 0x20, 0x20,   // W=0 S=2
+    0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,   // W=0 S=3
+    0xC4, 0xD9, 0xBD, 0x20, 0xC4, 0xC1, 0xD0, 0x20, 0xCD, 0xCF, 0xCA, 0x20, 0x20, 0x20, 0x20, 0x20,   // W=1 S=0
+    0xBF, 0xB4, 0xB6, 0x20, 0xC2, 0xC5, 0xD7, 0x20, 0xD1, 0xD8, 0xCE, 0x20, 0x20, 0x20, 0x20, 0x20,   // W=1 S=1
+    0xB7, 0xB6, 0xB6, 0x20, 0xD2, 0xD7, 0xD7, 0x20, 0xCB, 0xCE, 0xCE, 0x20, 0x20, 0x20, 0x20, 0x20,   // W=1 S=2
+    0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,   // W=1 S=3
+    0xCD, 0xBE, 0xBC, 0x20, 0xCD, 0xCF, 0xCA, 0x20, 0xCD, 0xCF, 0xCA, 0x20, 0x20, 0x20, 0x20, 0x20,   // W=2 S=0
+    0xB8, 0xB5, 0xB9, 0x20, 0xD1, 0xD8, 0xCE, 0x20, 0xD1, 0xD8, 0xCE, 0x20, 0x20, 0x20, 0x20, 0x20,   // W=2 S=1
+    0xBB, 0xB9, 0xB9, 0x20, 0xCB, 0xCE, 0xCE, 0x20, 0xCB, 0xCE, 0xCE, 0x20, 0x20, 0x20, 0x20, 0x20,   // W=2 S=2
+    0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,   // W=2 S=3
+    0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,   // W=3 S=0
+    0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,   // W=3 S=1
+    0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,   // W=3 S=2
+    0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20    // W=3 S=3
+};
+
+uint8_t mda_border_arms(char chr) {
+    uint8_t c = (uint8_t)chr;
+    if (c < BORDER_FIRST || c > BORDER_LAST) {
+        return 0;
+    }
+    return border_decode[c - BORDER_FIRST];
+}
+
+char mda_border_glyph(uint8_t arms) {
+    return (char)border_encode[arms];
+}
+
+void mda_border_cells(mda_border_style_t h, mda_border_style_t v, uint8_t attr, mda_cell_t* cells) {
+    require_address(cells, "NULL cells!");
+    cells[0] = mda_cell_make(mda_border_glyph(h << MDA_BORDER_E | v << MDA_BORDER_S), attr);   // TL
+    cells[1] = mda_cell_make(mda_border_glyph(h << MDA_BORDER_E | h << MDA_BORDER_W), attr);   // T
+    cells[2] = mda_cell_make(mda_border_glyph(h << MDA_BORDER_W | v << MDA_BORDER_S), attr);   // TR
+    cells[3] = mda_cell_make(mda_border_glyph(v << MDA_BORDER_N | v << MDA_BORDER_S), attr);   // L
+    cells[4] = cells[3];                                                                        // R
+    cells[5] = mda_cell_make(mda_border_glyph(h << MDA_BORDER_E | v << MDA_BORDER_N), attr);   // BL
+    cells[6] = cells[1];                                                                        // B
+    cells[7] = mda_cell_make(mda_border_glyph(h << MDA_BORDER_W | v << MDA_BORDER_N), attr);   // BR
+}
+
+/**
+ * @brief Replace the arms in mask of the glyph at vram with arms.
+ */
+static void border_merge(mda_cell_t* vram, uint8_t mask, uint8_t arms, uint8_t attr) {
+    arms |= mda_border_arms(vram->chr) & ~mask;
+    vram->packed = (uint16_t)attr << 8 | border_encode[arms];
+}
+
+/**
+ * @brief Merge a line of count cells into VRAM.
+ * @param stride Words between cells (1 across, MDA_ROW_WORDS down).
+ * @param back   Arm facing the previous cell (W or N).
+ * @param ahead  Arm facing the next cell (E or S).
+ * @param capped true = the line stops at its ends, false = it runs on
+ *               into the neighbouring cells (which the caller joins).
+ */
+static void border_line(const mda_point_t* p0, uint8_t count, uint8_t stride, uint8_t back, uint8_t ahead,
+                        mda_border_style_t style, uint8_t attr, bool capped) {
+    uint8_t mask = 3 << back | 3 << ahead;
+    uint8_t both = style << back | style << ahead;
+    mda_cell_t* vram = mda_as_pointer(p0);
+    if (capped && count > 1) {  // ends carry only their inward arm
+        border_merge(vram, 3 << ahead, style << ahead, attr);
+        border_merge(vram + (count - 1) * stride, 3 << back, style << back, attr);
+        vram += stride;
+        count -= 2;
+    }
+    while (count-- > 0) {
+        border_merge(vram, mask, both, attr);
+        vram += stride;
+    }
+}
+
+void mda_border_hline(const mda_point_t* p0, const mda_point_t* p1, mda_border_style_t style, uint8_t attr) {
+    require_address(p0, "NULL p0!");
+    require_address(p1, "NULL p1!");
+    require(p1->x >= p0->x && p1->y == p0->y, "INVALID hline!");
+    border_line(p0, p1->x - p0->x + 1, 1, MDA_BORDER_W, MDA_BORDER_E, style, attr, true);
+}
+
+void mda_border_vline(const mda_point_t* p0, const mda_point_t* p1, mda_border_style_t style, uint8_t attr) {
+    require_address(p0, "NULL p0!");
+    require_address(p1, "NULL p1!");
+    require(p1->y >= p0->y && p1->x == p0->x, "INVALID vline!");
+    border_line(p0, p1->y - p0->y + 1, MDA_ROW_WORDS, MDA_BORDER_N, MDA_BORDER_S, style, attr, true);
+}
+
+void mda_border_rect(const mda_rect_t* rect, mda_border_style_t h, mda_border_style_t v, uint8_t attr) {
+    require_address(rect, "NULL rect!");
+    require(rect->w > 1 && rect->h > 1, "INVALID border rect!");
+    uint8_t x1 = rect->x + rect->w - 1;
+    uint8_t y1 = rect->y + rect->h - 1;
+    mda_point_t p = mda_point_make(rect->x, rect->y);
+    mda_cell_t* tl = mda_as_pointer(&p);
+    mda_cell_t* bl = tl + (rect->h - 1) * MDA_ROW_WORDS;
+    // corners take both their arms at once so they never read a half drawn edge
+    border_merge(tl, 3 << MDA_BORDER_E | 3 << MDA_BORDER_S, h << MDA_BORDER_E | v << MDA_BORDER_S, attr);
+    border_merge(tl + rect->w - 1, 3 << MDA_BORDER_W | 3 << MDA_BORDER_S, h << MDA_BORDER_W | v << MDA_BORDER_S, attr);
+    border_merge(bl, 3 << MDA_BORDER_E | 3 << MDA_BORDER_N, h << MDA_BORDER_E | v << MDA_BORDER_N, attr);
+    border_merge(bl + rect->w - 1, 3 << MDA_BORDER_W | 3 << MDA_BORDER_N, h << MDA_BORDER_W | v << MDA_BORDER_N, attr);
+    if (rect->w > 2) {
+        p = mda_point_make(rect->x + 1, rect->y);
+        border_line(&p, rect->w - 2, 1, MDA_BORDER_W, MDA_BORDER_E, h, attr, false);
+        p.y = y1;
+        border_line(&p, rect->w - 2, 1, MDA_BORDER_W, MDA_BORDER_E, h, attr, false);
+    }
+    if (rect->h > 2) {
+        p = mda_point_make(rect->x, rect->y + 1);
+        border_line(&p, rect->h - 2, MDA_ROW_WORDS, MDA_BORDER_N, MDA_BORDER_S, v, attr, false);
+        p.x = x1;
+        border_line(&p, rect->h - 2, MDA_ROW_WORDS, MDA_BORDER_N, MDA_BORDER_S, v, attr, false);
+    }
+}
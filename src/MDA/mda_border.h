@@ -0,0 +1,87 @@
+/**
+ * @file mda_border.h
+ * @brief Box-Drawing Border Engine with Junction Merging
+ * @details Draws single, double and mixed CP437 box lines that join
+ * correctly with whatever box characters are already on screen.
+ *
+ * Every box glyph is described by its four arms (north, east, south,
+ * west), 2 bits each: 0 none, 1 single, 2 double. Drawing a line reads the
+ * cell under it, decodes its arms with a 40-entry table, overwrites the
+ * arms the line contributes and encodes the result back to a glyph with a
+ * 256-entry table — no branching on glyph shapes. Crossing a ─ with a │
+ * gives ┼, ending a ═ on a ║ gives ╣, and so on.
+ *
+ * CP437 cannot show every arm combination (e.g. a single north arm with a
+ * double south arm); the encode table resolves these to the nearest glyph,
+ * promoting the mismatched axis to double. A lone arm is drawn as a full
+ * line of its weight.
+ *
+ * Frames, tables and grids are drawn one line at a time, one pass each.
+ *
+ * @note Like the primitives, unbounded — caller must clip.
+ * @author Jeremy Thornton
+ */
+#ifndef MDA_BORDER_H
+#define MDA_BORDER_H
+
+#include "mda_cell.h"
+#include "mda_types.h"
+#include <stdint.h>
+
+/**
+ * @enum mda_border_style_t
+ * @brief Line weight, as stored in each 2 bit arm.
+ */
+typedef enum {
+    MDA_BORDER_NONE = 0,    /**< No line */
+    MDA_BORDER_SINGLE,      /**< ─ │ */
+    MDA_BORDER_DOUBLE       /**< ═ ║ */
+} mda_border_style_t;
+
+/**
+ * @defgroup border_arms Arm Encoding
+ * @brief Bit position of each arm in an arms byte.
+ * @{
+ */
+#define MDA_BORDER_N    0
+#define MDA_BORDER_E    2
+#define MDA_BORDER_S    4
+#define MDA_BORDER_W    6
+///@}
+
+/**
+ * @brief Arms of a CP437 character (0 if it is not a box glyph).
+ */
+uint8_t mda_border_arms(char chr);
+
+/**
+ * @brief CP437 glyph for an arms byte (space for no arms).
+ */
+char mda_border_glyph(uint8_t arms);
+
+/**
+ * @brief Build the 8 cells of a plain frame for mda_draw_border().
+ * @param h      Weight of the top and bottom edges.
+ * @param v      Weight of the left and right edges.
+ * @param attr   Attribute of every cell.
+ * @param cells  Receives TL, T, TR, L, R, BL, B, BR.
+ */
+void mda_border_cells(mda_border_style_t h, mda_border_style_t v, uint8_t attr, mda_cell_t* cells);
+
+/**
+ * @defgroup border_merge Merging Line Drawing
+ * @brief Lines that join with box glyphs already on screen.
+ * @{
+ */
+void mda_border_hline(const mda_point_t* p0, const mda_point_t* p1, mda_border_style_t style, uint8_t attr);
+void mda_border_vline(const mda_point_t* p0, const mda_point_t* p1, mda_border_style_t style, uint8_t attr);
+
+/**
+ * @brief Outline rect, joining any lines it meets.
+ * @param h Weight of the top and bottom edges.
+ * @param v Weight of the left and right edges.
+ */
+void mda_border_rect(const mda_rect_t* rect, mda_border_style_t h, mda_border_style_t v, uint8_t attr);
+///@}
+
+#endif /* MDA_BORDER_H */
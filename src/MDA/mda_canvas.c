@@ -0,0 +1,193 @@
+/**
+ * @file mda_canvas.c
+ * @brief Implementation of the Half-Block Pseudo-Graphics Canvas
+ * @details Text row r of the canvas is built from pixel rows 2r (top half)
+ * and 2r+1 (bottom half). Conversion walks both rows a byte at a time,
+ * shifting the two pixels of each cell out of the top bits.
+ * @author Jeremy Thornton
+ */
+#include "mda_canvas.h"
+#include "mda_primitives.h"
+#include "cp437_constants.h"
+#include "../CONTRACT/contract.h"
+#include <string.h>
+
+/**
+ * @brief Combine mask into one framebuffer byte.
+ */
+static void canvas_apply(uint8_t* byte, uint8_t mask, mda_canvas_op_t op) {
+    switch (op) {
+        case MDA_CANVAS_CLEAR:
+            *byte &= ~mask;
+            break;
+        case MDA_CANVAS_SET:
+            *byte |= mask;
+            break;
+        default:
+            *byte ^= mask;
+            break;
+    }
+}
+
+/**
+ * @brief Mark the text rows holding pixel rows y0..y1 dirty.
+ */
+static void canvas_touch(mda_canvas_t* canvas, int16_t y0, int16_t y1) {
+    for (int16_t r = y0 >> 1; r <= (y1 >> 1); ++r) {
+        canvas->dirty |= 1UL << r;
+    }
+}
+
+void mda_canvas_init(mda_canvas_t* canvas, const mda_rect_t* bounds, uint8_t attr) {
+    require_address(canvas, "NULL canvas!");
+    require_address(bounds, "NULL bounds!");
+    require(bounds->w > 0 && bounds->w <= MDA_COLUMNS, "INVALID canvas width!");
+    require(bounds->h > 0 && bounds->h <= MDA_ROWS, "INVALID canvas height!");
+    canvas->bounds = *bounds;
+    canvas->width = bounds->w;
+    canvas->height = bounds->h * 2;
+    canvas->dirty = 0;
+    canvas->lut[0] = mda_cell_make(' ', attr);                       // neither half
+    canvas->lut[1] = mda_cell_make(CP437_LOWER_HALF_BLOCK, attr);    // bottom only
+    canvas->lut[2] = mda_cell_make(CP437_UPPER_HALF_BLOCK, attr);    // top only
+    canvas->lut[3] = mda_cell_make(CP437_FULL_BLOCK, attr);          // both halves
+    mda_canvas_clear(canvas);
+}
+
+void mda_canvas_clear(mda_canvas_t* canvas) {
+    require_address(canvas, "NULL canvas!");
+    memset(canvas->bits, 0, sizeof(canvas->bits));
+    canvas_touch(canvas, 0, canvas->height - 1);
+}
+
+void mda_canvas_plot(mda_canvas_t* canvas, int16_t x, int16_t y, mda_canvas_op_t op) {
+    require_address(canvas, "NULL canvas!");
+    if (x < 0 || y < 0 || x >= canvas->width || y >= canvas->height) {
+        return;
+    }
+    canvas_apply(&canvas->bits[y][x >> 3], 0x80 >> (x & 7), op);
+    canvas->dirty |= 1UL << (y >> 1);
+}
+
+void mda_canvas_line(mda_canvas_t* canvas, int16_t x0, int16_t y0, int16_t x1, int16_t y1, mda_canvas_op_t op) {
+    require_address(canvas, "NULL canvas!");
+    int16_t dx = (x1 > x0) ? x1 - x0 : x0 - x1;
+    int16_t dy = (y1 > y0) ? y0 - y1 : y1 - y0;     // negative
+    int16_t sx = (x0 < x1) ? 1 : -1;
+    int16_t sy = (y0 < y1) ? 1 : -1;
+    int16_t err = dx + dy;
+    for (;;) {
+        mda_canvas_plot(canvas, x0, y0, op);
+        if (x0 == x1 && y0 == y1) {
+            break;
+        }
+        int16_t e2 = err * 2;
+        if (e2 >= dy) {     // step x
+            err += dy;
+            x0 += sx;
+        }
+        if (e2 <= dx) {     // step y
+            err += dx;
+            y0 += sy;
+        }
+    }
+}
+
+void mda_canvas_fill_rect(mda_canvas_t* canvas, int16_t x, int16_t y, int16_t w, int16_t h, mda_canvas_op_t op) {
+    require_address(canvas, "NULL canvas!");
+    int16_t x1 = x + w;
+    int16_t y1 = y + h;
+    if (x < 0) {
+        x = 0;
+    }
+    if (y < 0) {
+        y = 0;
+    }
+    if (x1 > canvas->width) {
+        x1 = canvas->width;
+    }
+    if (y1 > canvas->height) {
+        y1 = canvas->height;
+    }
+    if (x >= x1 || y >= y1) {
+        return;
+    }
+    uint8_t first = x >> 3;
+    uint8_t last = (x1 - 1) >> 3;
+    uint8_t head = 0xFF >> (x & 7);                 // pixels from x to the end of its byte
+    uint8_t tail = 0xFF << (7 - ((x1 - 1) & 7));    // pixels up to x1-1 in its byte
+    for (int16_t row = y; row < y1; ++row) {
+        uint8_t* bits = canvas->bits[row];
+        if (first == last) {
+            canvas_apply(&bits[first], head & tail, op);
+            continue;
+        }
+        canvas_apply(&bits[first], head, op);
+        for (uint8_t i = first + 1; i < last; ++i) {
+            canvas_apply(&bits[i], 0xFF, op);
+        }
+        canvas_apply(&bits[last], tail, op);
+    }
+    canvas_touch(canvas, y, y1 - 1);
+}
+
+void mda_canvas_blit(mda_canvas_t* canvas, const uint8_t* bits, uint8_t w, uint8_t h, int16_t x, int16_t y, mda_canvas_op_t op) {
+    require_address(canvas, "NULL canvas!");
+    require_address(bits, "NULL sprite!");
+    uint8_t stride = (w + 7) >> 3;
+    for (uint8_t sy = 0; sy < h; ++sy, bits += stride) {
+        int16_t py = y + sy;
+        if (py < 0 || py >= canvas->height) {
+            continue;
+        }
+        for (uint8_t sx = 0; sx < w; ++sx) {
+            int16_t px = x + sx;
+            if (px < 0 || px >= canvas->width || !(bits[sx >> 3] & (0x80 >> (sx & 7)))) {
+                continue;
+            }
+            canvas_apply(&canvas->bits[py][px >> 3], 0x80 >> (px & 7), op);
+        }
+    }
+    int16_t y0 = (y < 0) ? 0 : y;
+    int16_t y1 = (y + h > canvas->height) ? canvas->height : y + h;
+    if (y0 < y1) {
+        canvas_touch(canvas, y0, y1 - 1);
+    }
+}
+
+bool mda_canvas_get(const mda_canvas_t* canvas, int16_t x, int16_t y) {
+    require_address(canvas, "NULL canvas!");
+    if (x < 0 || y < 0 || x >= canvas->width || y >= canvas->height) {
+        return false;
+    }
+    return (canvas->bits[y][x >> 3] & (0x80 >> (x & 7))) != 0;
+}
+
+void mda_canvas_present(mda_canvas_t* canvas) {
+    require_address(canvas, "NULL canvas!");
+    mda_cell_t row[MDA_COLUMNS];
+    for (uint8_t r = 0; r < canvas->bounds.h && canvas->dirty != 0; ++r) {
+        if (!(canvas->dirty & (1UL << r))) {
+            continue;
+        }
+        const uint8_t* top = canvas->bits[r * 2];
+        const uint8_t* bottom = canvas->bits[r * 2 + 1];
+        mda_cell_t* cell = row;
+        for (uint8_t i = 0; i * 8 < canvas->width; ++i) {
+            uint8_t t = top[i];
+            uint8_t b = bottom[i];
+            uint8_t n = canvas->width - i * 8;
+            if (n > 8) {
+                n = 8;
+            }
+            while (n-- > 0) {   // pixel pair -> lut index (top << 1 | bottom)
+                *cell++ = canvas->lut[((t >> 6) & 2) | (b >> 7)];
+                t <<= 1;
+                b <<= 1;
+            }
+        }
+        mda_point_t p = mda_point_make(canvas->bounds.x, canvas->bounds.y + r);
+        mda_write_cells(&p, row, canvas->width);
+        canvas->dirty &= ~(1UL << r);
+    }
+}
@@ -0,0 +1,94 @@
+/**
+ * @file mda_canvas.h
+ * @brief Half-Block Pseudo-Graphics Canvas
+ * @details Splits every text cell into a top and a bottom "pixel" drawn
+ * with the CP437 half blocks, giving up to 80x50 monochrome pixels on the
+ * MDA text page.
+ *
+ * Pixels are kept in a bit-packed framebuffer (10 bytes per pixel row,
+ * leftmost pixel in the most significant bit) and drawn to with plots,
+ * Bresenham lines, rectangle fills and sprite blits. Nothing touches VRAM
+ * until mda_canvas_present(), which converts only the text rows marked
+ * dirty, looking each top/bottom pixel pair up in a 4-entry cell table and
+ * committing each row with one mda_write_cells().
+ *
+ * Pixel coordinates are clipped to the canvas.
+ *
+ * @author Jeremy Thornton
+ */
+#ifndef MDA_CANVAS_H
+#define MDA_CANVAS_H
+
+#include "mda_cell.h"
+#include "mda_constants.h"
+#include "mda_types.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+#define MDA_CANVAS_MAX_WIDTH    MDA_COLUMNS         /**< Pixels across */
+#define MDA_CANVAS_MAX_HEIGHT   (MDA_ROWS * 2)      /**< Pixels down */
+#define MDA_CANVAS_ROW_BYTES    (MDA_CANVAS_MAX_WIDTH / 8) /**< Bytes per pixel row */
+
+/**
+ * @enum mda_canvas_op_t
+ * @brief How drawing combines with pixels already set.
+ */
+typedef enum {
+    MDA_CANVAS_CLEAR = 0,   /**< Turn pixels off */
+    MDA_CANVAS_SET,         /**< Turn pixels on */
+    MDA_CANVAS_XOR          /**< Invert pixels */
+} mda_canvas_op_t;
+
+/**
+ * @struct mda_canvas_t
+ * @brief Framebuffer, dirty rows and on-screen placement of one canvas.
+ */
+typedef struct {
+    mda_rect_t bounds;                          /**< Screen cells covered (pixels = w x 2h) */
+    uint8_t width;                              /**< Width in pixels */
+    uint8_t height;                             /**< Height in pixels */
+    uint32_t dirty;                             /**< Bit r set = text row r of bounds needs converting */
+    mda_cell_t lut[4];                          /**< Cell per (top << 1 | bottom) pixel pair */
+    uint8_t bits[MDA_CANVAS_MAX_HEIGHT][MDA_CANVAS_ROW_BYTES]; /**< Pixels, MSB leftmost */
+} mda_canvas_t;
+
+/**
+ * @brief Initialize a blank canvas over a screen rectangle.
+ * @param canvas Canvas to initialize.
+ * @param bounds Screen cells covered (caller clipped to 80x25).
+ * @param attr   Attribute of every canvas cell.
+ */
+void mda_canvas_init(mda_canvas_t* canvas, const mda_rect_t* bounds, uint8_t attr);
+
+/**
+ * @brief Turn every pixel off and mark the whole canvas dirty.
+ */
+void mda_canvas_clear(mda_canvas_t* canvas);
+
+/**
+ * @defgroup canvas_draw Canvas Drawing
+ * @brief Framebuffer only; call mda_canvas_present() to show the result.
+ * @{
+ */
+void mda_canvas_plot(mda_canvas_t* canvas, int16_t x, int16_t y, mda_canvas_op_t op);
+void mda_canvas_line(mda_canvas_t* canvas, int16_t x0, int16_t y0, int16_t x1, int16_t y1, mda_canvas_op_t op);
+void mda_canvas_fill_rect(mda_canvas_t* canvas, int16_t x, int16_t y, int16_t w, int16_t h, mda_canvas_op_t op);
+
+/**
+ * @brief Apply op wherever a sprite pixel is set.
+ * @param bits Sprite rows of (w + 7) / 8 bytes, MSB leftmost.
+ */
+void mda_canvas_blit(mda_canvas_t* canvas, const uint8_t* bits, uint8_t w, uint8_t h, int16_t x, int16_t y, mda_canvas_op_t op);
+///@}
+
+/**
+ * @brief true if pixel (x,y) is on; false outside the canvas.
+ */
+bool mda_canvas_get(const mda_canvas_t* canvas, int16_t x, int16_t y);
+
+/**
+ * @brief Convert dirty text rows to cells and write them to the screen.
+ */
+void mda_canvas_present(mda_canvas_t* canvas);
+
+#endif /* MDA_CANVAS_H */
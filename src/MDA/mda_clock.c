@@ -0,0 +1,125 @@
+/**
+ * @file mda_clock.c
+ * @brief Implementation of the Millisecond Clock
+ * @details A tick lasts 65536 PIT counts = 54.925 ms, taken as 2197/40 so
+ * that the conversion stays in 32-bit integers; within the tick one
+ * millisecond is 1193 counts and one count is 0.838 us.
+ * @author Jeremy Thornton
+ */
+#include "mda_clock.h"
+
+static uint32_t clock_last;         // last value returned, keeps the clock monotonic
+
+#ifdef __DOS__
+
+static uint32_t clock_base;         // tick count at init
+static uint32_t clock_prev;         // tick count at the previous read
+static uint32_t clock_days;         // ticks added for each midnight passed
+
+/**
+ * @brief Read the BIOS tick count and the PIT channel 0 count together.
+ * @details Interrupts stay enabled; the tick count is read again after
+ * latching the PIT and the pair is retried if a tick arrived in between.
+ */
+static uint32_t clock_sample(uint16_t* count) {
+    uint16_t lo, hi, pit;
+    __asm {
+        .8086
+        push es
+        mov  ax, 40h
+        mov  es, ax         ; ES = BIOS data area
+NEXT:   mov  bx, es:[6Ch]   ; BX = tick count (low)
+        mov  cx, es:[6Eh]   ; CX = tick count (high)
+        xor  al, al         ; latch channel 0
+        out  43h, al
+        in   al, 40h        ; count (low)
+        mov  dl, al
+        in   al, 40h        ; count (high)
+        mov  dh, al
+        cmp  bx, es:[6Ch]   ; did a tick arrive?
+        jne  NEXT
+        pop  es
+        mov  lo, bx
+        mov  hi, cx
+        mov  pit, dx
+    }
+    *count = pit;
+    return ((uint32_t)hi << 16) | lo;
+}
+
+void mda_clock_init(void) {
+    __asm {
+        .8086
+        pushf
+        cli
+        mov  al, 34h        ; channel 0, low then high byte, mode 2, binary
+        out  43h, al
+        xor  al, al         ; divisor 0 = 65536, the BIOS rate
+        out  40h, al
+        out  40h, al
+        popf
+    }
+    uint16_t count;
+    clock_base = clock_prev = clock_sample(&count);
+    clock_days = 0;
+    clock_last = 0;
+}
+
+/**
+ * @brief Ticks since init and PIT counts into the current tick.
+ */
+static uint32_t clock_read(uint16_t* elapsed) {
+    uint16_t count;
+    uint32_t ticks = clock_sample(&count);
+    if (ticks < clock_prev) {                   // passed midnight
+        clock_days += MDA_CLOCK_TICKS_PER_DAY;
+    }
+    clock_prev = ticks;
+    *elapsed = (uint16_t)(0 - count);           // mode 2 runs down from 65536
+    return ticks + clock_days - clock_base;
+}
+
+uint32_t mda_clock_ms(void) {
+    uint16_t elapsed;
+    uint32_t t = clock_read(&elapsed);
+    uint32_t ms = (t / 40) * 2197 + ((t % 40) * 2197) / 40 + elapsed / 1193;
+    if (ms > clock_last) {
+        clock_last = ms;
+    }
+    return clock_last;
+}
+
+uint32_t mda_clock_us(void) {
+    uint16_t elapsed;
+    uint32_t t = clock_read(&elapsed);
+    return t * 54925UL + (elapsed * 838UL) / 1000;
+}
+
+#else
+
+#include <time.h>
+
+static struct timespec clock_base;
+
+void mda_clock_init(void) {
+    clock_gettime(CLOCK_MONOTONIC, &clock_base);
+    clock_last = 0;
+}
+
+uint32_t mda_clock_ms(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    uint32_t ms = (uint32_t)((now.tv_sec - clock_base.tv_sec) * 1000 + (now.tv_nsec - clock_base.tv_nsec) / 1000000);
+    if (ms > clock_last) {
+        clock_last = ms;
+    }
+    return clock_last;
+}
+
+uint32_t mda_clock_us(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint32_t)((now.tv_sec - clock_base.tv_sec) * 1000000 + (now.tv_nsec - clock_base.tv_nsec) / 1000);
+}
+
+#endif
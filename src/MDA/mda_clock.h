@@ -0,0 +1,42 @@
+/**
+ * @file mda_clock.h
+ * @brief Millisecond Clock from the BIOS Tick Count and the 8254 PIT
+ * @details The BIOS tick count at 0040:006C advances only 18.2 times a
+ * second. Reading the count of PIT channel 0, which runs down once per
+ * tick at 1.19318 MHz, gives the position within the tick as well, so
+ * timestamps resolve to about a millisecond.
+ *
+ * mda_clock_init() reprograms channel 0 from mode 3 (square wave, counts
+ * down twice per tick) to mode 2 (rate generator, counts down once) with
+ * the same divisor, so the tick rate the BIOS and DOS rely on is unchanged.
+ *
+ * On the host the clock is CLOCK_MONOTONIC.
+ *
+ * @author Jeremy Thornton
+ */
+#ifndef MDA_CLOCK_H
+#define MDA_CLOCK_H
+
+#include <stdint.h>
+
+#define MDA_CLOCK_PIT_HZ        1193182UL   /**< PIT input clock */
+#define MDA_CLOCK_TICKS_PER_DAY 0x1800B0UL  /**< BIOS ticks from midnight to midnight */
+
+/**
+ * @brief Put PIT channel 0 in mode 2 and start the clock at 0.
+ */
+void mda_clock_init(void);
+
+/**
+ * @brief Milliseconds since mda_clock_init(); never goes backwards.
+ * @note Wraps after about 49 days.
+ */
+uint32_t mda_clock_ms(void);
+
+/**
+ * @brief Microseconds since mda_clock_init(), for timing short intervals.
+ * @note Wraps after about 71 minutes; take differences, not absolute values.
+ */
+uint32_t mda_clock_us(void);
+
+#endif /* MDA_CLOCK_H */
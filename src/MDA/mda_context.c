@@ -4,17 +4,49 @@
 #include "mda_primitives.h"
 #include "mda_rect.h"
 #include "mda_control_codes.h"
+#include "mda_crtc.h"
+#include "mda_kernels.h"
+#include "mda_trace.h"
 #include "../CONTRACT/contract.h"
 #include "../BIOS/bios_video_services.h"
+#include <string.h>
+
+/**
+ * @brief Move the BIOS cursor, then re-aim the hardware cursor if the display start has moved.
+ */
+static void context_set_cursor(const mda_context_t* ctx, uint8_t x, uint8_t y) {
+    bios_set_cursor_position(x, y, ctx->video.page);
+    if (mda_vram_base != 0) {   // BIOS assumes start address 0
+        mda_crtc_set_cursor(x, y);
+    }
+}
 
 void mda_set_bounds(mda_context_t* ctx, uint8_t x, uint8_t y, uint8_t w, uint8_t h) {
     require_address(ctx, "NULL context!");
     ctx->bounds = mda_rect_make(x, y, w, h);
 }
 
+void mda_set_scrollback(mda_context_t* ctx, mda_scrollback_t* sb) {
+    require_address(ctx, "NULL context!");
+    ctx->scrollback = sb;
+}
+
+void mda_set_hw_scroll(mda_context_t* ctx, bool enable) {
+    require_address(ctx, "NULL context!");
+    require(!enable || (ctx->bounds.w == MDA_COLUMNS && ctx->bounds.h == MDA_ROWS), "Hardware scroll needs full screen bounds!");
+    ctx->hw_scroll = enable;
+}
+
 void mda_initialize_default_context(mda_context_t* ctx) {
     require_address(ctx, "NULL context!");
+    mda_install_kernels(cpu_detect());
     bios_set_video_mode(MDA_TEXT_MONOCHROME_80X25);
+    mda_initialize_context(ctx);
+}
+
+void mda_initialize_context(mda_context_t* ctx) {
+    require_address(ctx, "NULL context!");
+    mda_crtc_set_start(0);
     bios_get_video_state(&ctx->video);
     bios_get_cursor_position_and_size(&ctx->cursor, ctx->video.page);
     mda_set_bounds(ctx, 0, 0, ctx->video.columns, MDA_ROWS);
@@ -22,33 +54,52 @@ void mda_initialize_default_context(mda_context_t* ctx) {
     ctx->blank = mda_cell_make(' ', MDA_NORMAL);
     ctx->htab_size = MDA_DEFAULT_HTAB;
     ctx->vtab_size = MDA_DEFAULT_VTAB;
+    ctx->scrollback = NULL;
+    ctx->hw_scroll = false;
 }
 
 void mda_cursor_to(mda_context_t* ctx, mda_point_t* p) {
     require_address(ctx, "NULL context!");
     require(mda_rect_contains_point(&ctx->bounds, p), "POINT out of bounds!");
-    bios_set_cursor_position(p->x, p->y, ctx->video.page);
+    MDA_TRACE_CONTEXT_CALL(MDA_TRACE_CURSOR_TO, ctx, p, 2);
+    context_set_cursor(ctx, p->x, p->y);
     bios_get_cursor_position_and_size(&ctx->cursor, ctx->video.page);
+    MDA_TRACE_CONTEXT_LEAVE(ctx);
 }
 
 void mda_cursor_up(mda_context_t* ctx) {
     require_address(ctx, "NULL context!");
     if (ctx->cursor.row == ctx->bounds.y) {
-        mda_scroll_down(&ctx->bounds, &ctx->blank);
+        if (ctx->hw_scroll) {
+            mda_hw_scroll_down(&ctx->blank);
+            context_set_cursor(ctx, ctx->cursor.column, ctx->cursor.row);
+        }
+        else {
+            mda_scroll_down(&ctx->bounds, &ctx->blank);
+        }
         return;
     }
     ctx->cursor.row--;
-    bios_set_cursor_position(ctx->cursor.column, ctx->cursor.row, ctx->video.page);
+    context_set_cursor(ctx, ctx->cursor.column, ctx->cursor.row);
 }
 
 void mda_cursor_down(mda_context_t* ctx) {
     require_address(ctx, "NULL context!");
     if (ctx->cursor.row == ctx->bounds.y + ctx->bounds.h - 1) {
-        mda_scroll_up(&ctx->bounds, &ctx->blank);
+        if (ctx->scrollback) {  // keep the top line before it is lost
+            mda_scrollback_push(ctx->scrollback, mda_as_pointer(&ctx->bounds.origin), ctx->bounds.w, &ctx->blank);
+        }
+        if (ctx->hw_scroll) {
+            mda_hw_scroll_up(&ctx->blank);
+            context_set_cursor(ctx, ctx->cursor.column, ctx->cursor.row);
+        }
+        else {
+            mda_scroll_up(&ctx->bounds, &ctx->blank);
+        }
         return;
     }
     ctx->cursor.row++;
-    bios_set_cursor_position(ctx->cursor.column, ctx->cursor.row, ctx->video.page);
+    context_set_cursor(ctx, ctx->cursor.column, ctx->cursor.row);
 }
 
 void mda_cursor_forward(mda_context_t* ctx) {
@@ -58,7 +109,7 @@ void mda_cursor_forward(mda_context_t* ctx) {
         mda_CRLF(ctx);
         return;
     }
-    bios_set_cursor_position(ctx->cursor.column, ctx->cursor.row, ctx->video.page);
+    context_set_cursor(ctx, ctx->cursor.column, ctx->cursor.row);
 }
 
 void mda_cursor_back(mda_context_t* ctx) {
@@ -73,7 +124,7 @@ void mda_cursor_back(mda_context_t* ctx) {
     else { // At top-left corner: cannot go back — ring bell!
         mda_BEL(ctx);
     }
-    bios_set_cursor_position(ctx->cursor.column, ctx->cursor.row, ctx->video.page);
+    context_set_cursor(ctx, ctx->cursor.column, ctx->cursor.row);
 }
 
 void mda_BEL(const mda_context_t* ctx) {
@@ -81,39 +132,51 @@ void mda_BEL(const mda_context_t* ctx) {
     bios_write_text_teletype_mode(ASCII_BEL, 0, ctx->video.page);
 }
 
-void mda_BS(const mda_context_t* ctx) {
+void mda_BS(mda_context_t* ctx) {
+    MDA_TRACE_CONTEXT_CALL(MDA_TRACE_BS, ctx, NULL, 0);
     mda_cursor_back(ctx);
+    MDA_TRACE_CONTEXT_LEAVE(ctx);
 }
 
-void mda_HT(const mda_context_t* ctx) {
+void mda_HT(mda_context_t* ctx) {
+    MDA_TRACE_CONTEXT_CALL(MDA_TRACE_HT, ctx, NULL, 0);
     for(int i = 0; i < ctx->htab_size; ++i) {
         mda_cursor_forward(ctx);
     }
+    MDA_TRACE_CONTEXT_LEAVE(ctx);
 }
 
-void mda_LF(const mda_context_t* ctx) {
+void mda_LF(mda_context_t* ctx) {
+    MDA_TRACE_CONTEXT_CALL(MDA_TRACE_LF, ctx, NULL, 0);
     mda_cursor_down(ctx);
+    MDA_TRACE_CONTEXT_LEAVE(ctx);
 }
 
-void mda_VT(const mda_context_t* ctx) {
+void mda_VT(mda_context_t* ctx) {
+    MDA_TRACE_CONTEXT_CALL(MDA_TRACE_VT, ctx, NULL, 0);
     for(int i = 0; i < ctx->vtab_size; ++i){
         mda_LF(ctx);
     }
+    MDA_TRACE_CONTEXT_LEAVE(ctx);
 }
 
 void mda_FF(mda_context_t* ctx) {
+    MDA_TRACE_CONTEXT_CALL(MDA_TRACE_FF, ctx, NULL, 0);
     for(int i = 0; i < ctx->bounds.h; ++i){
         mda_scroll_up(&ctx->bounds, &ctx->blank);
     }
     ctx->cursor.row = ctx->bounds.y;
     ctx->cursor.column = ctx->bounds.x;
-    bios_set_cursor_position(ctx->cursor.column, ctx->cursor.row, ctx->video.page);
+    context_set_cursor(ctx, ctx->cursor.column, ctx->cursor.row);
+    MDA_TRACE_CONTEXT_LEAVE(ctx);
 }
 
 void mda_CR(mda_context_t* ctx) {
     require_address(ctx, "NULL context!");
+    MDA_TRACE_CONTEXT_CALL(MDA_TRACE_CR, ctx, NULL, 0);
     ctx->cursor.column = ctx->bounds.x;
-    bios_set_cursor_position(ctx->cursor.column, ctx->cursor.row, ctx->video.page);
+    context_set_cursor(ctx, ctx->cursor.column, ctx->cursor.row);
+    MDA_TRACE_CONTEXT_LEAVE(ctx);
 }
 
 void mda_ESC(const mda_context_t* ctx) {
@@ -122,26 +185,35 @@ void mda_ESC(const mda_context_t* ctx) {
 }
 
 
-void mda_DELconst (mda_context_t* ctx) {
+void mda_DEL(mda_context_t* ctx) {
+    MDA_TRACE_CONTEXT_CALL(MDA_TRACE_DEL, ctx, NULL, 0);
     mda_BS(ctx);
     mda_print_char(ctx, ' ');
     mda_BS(ctx);
+    MDA_TRACE_CONTEXT_LEAVE(ctx);
 }
 
-void mda_CRLF(const mda_context_t* ctx) {
+void mda_CRLF(mda_context_t* ctx) {
+    MDA_TRACE_CONTEXT_CALL(MDA_TRACE_CRLF, ctx, NULL, 0);
     mda_CR(ctx);
     mda_LF(ctx);
+    MDA_TRACE_CONTEXT_LEAVE(ctx);
 }
 
-void mda_print_char(const mda_context_t* ctx, char chr) {
+void mda_print_char(mda_context_t* ctx, char chr) {
     require_address(ctx, "NULL context!");
-    bios_write_character_and_attribute_at_cursor(chr, ctx->attributes, 1, ctx->video.page);
+    MDA_TRACE_CONTEXT_CALL(MDA_TRACE_PRINT_CHAR, ctx, &chr, 1);
+    mda_point_t p = mda_point_make(ctx->cursor.column, ctx->cursor.row);
+    mda_cell_t cell = mda_cell_make(chr, ctx->attributes);
+    mda_plot(&p, &cell);    // BIOS writes ignore the display start address
     mda_cursor_forward(ctx);
+    MDA_TRACE_CONTEXT_LEAVE(ctx);
 }
 
-void mda_print_string(const mda_context_t* ctx, char* str) {
+void mda_print_string(mda_context_t* ctx, char* str) {
     require_address(ctx, "NULL context!");
     require_address(str, "NULL string!");
+    MDA_TRACE_CONTEXT_CALL(MDA_TRACE_PRINT_STRING, ctx, str, (uint16_t)strlen(str) + 1);
 
     char c;
     while ((c = *str++) != '\0') {
@@ -180,4 +252,5 @@ void mda_print_string(const mda_context_t* ctx, char* str) {
             mda_print_char(ctx, c);
         }
     }
+    MDA_TRACE_CONTEXT_LEAVE(ctx);
 }
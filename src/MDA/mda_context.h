@@ -16,6 +16,7 @@
 
 #include "mda_constants.h"
 #include "mda_types.h"
+#include "mda_scrollback.h"
 #include "../BIOS/bios_video_services.h"
 #include <stdbool.h>
 #include <stdint.h>
@@ -38,6 +39,8 @@ typedef struct {
     uint8_t vtab_size;           /**< Vertical tab spacing (in rows) */
     bios_video_state_t video;    /**< Saved BIOS video mode and page info */
     bios_cursor_state_t cursor;  /**< Saved cursor position and shape */
+    mda_scrollback_t* scrollback;/**< Optional history of rows scrolled off the top (NULL = none) */
+    bool hw_scroll;              /**< Scroll by moving the CRTC start address (full screen bounds only) */
     // TODO clip function here
     // TODO: mouse_state mouse; has mouse support etc
 } mda_context_t;
@@ -49,6 +52,15 @@ typedef struct {
  */
 void mda_initialize_default_context(mda_context_t* ctx);
 
+/**
+ * @brief Initialize context with default values for the video mode already set.
+ * @details Everything mda_initialize_default_context() does after setting the
+ * mode: display start 0, BIOS video state and cursor, full screen bounds and
+ * normal attributes. Kernels must already be installed.
+ * @param ctx Pointer to context to initialize.
+ */
+void mda_initialize_context(mda_context_t* ctx);
+
 
 /**
  * @brief Set the active bounds for the context.
@@ -60,6 +72,25 @@ void mda_initialize_default_context(mda_context_t* ctx);
  */
 void mda_set_bounds(mda_context_t* ctx, uint8_t x, uint8_t y, uint8_t w, uint8_t h);
 
+/**
+ * @brief Attach a scrollback store to the context.
+ * @details While attached, every row that mda_cursor_down() scrolls off the
+ * top of the bounds is appended to the store before it is lost.
+ * @param ctx Pointer to context.
+ * @param sb  Initialized store, or NULL to detach.
+ */
+void mda_set_scrollback(mda_context_t* ctx, mda_scrollback_t* sb);
+
+/**
+ * @brief Scroll the console by moving the display start address.
+ * @details Only the exposed row is cleared per line instead of moving the
+ * whole screen. Requires full screen bounds and a genuine MDA (see mda_crtc.h).
+ * Disabling leaves the start address where it is; primitives stay relative to it.
+ * @param ctx    Pointer to context.
+ * @param enable true to scroll in hardware, false to move VRAM.
+ */
+void mda_set_hw_scroll(mda_context_t* ctx, bool enable);
+
 /**
  * @defgroup cursor_ops Cursor Movement & Advancement
  * @brief Functions for direct and incremental cursor control.
@@ -78,20 +109,19 @@ void mda_cursor_advance(mda_context_t* ctx);  ///< Advance cursor right with wra
  * @{
  */
 void mda_BEL(const mda_context_t* ctx);  ///< Sound bell (CRTL-G)
-void mda_BS(const mda_context_t* ctx);   ///< Backspace: move left, no underflow
-void mda_HT(const mda_context_t* ctx);   ///< Horizontal tab: advance to next HT stop
-void mda_LF(const mda_context_t* ctx);   ///< Line Feed: move down, scroll if needed
-void mda_VT(const mda_context_t* ctx);   ///< Vertical Tab: advance down by vtab_size
+void mda_BS(mda_context_t* ctx);   ///< Backspace: move left, no underflow
+void mda_HT(mda_context_t* ctx);   ///< Horizontal tab: advance to next HT stop
+void mda_LF(mda_context_t* ctx);   ///< Line Feed: move down, scroll if needed
+void mda_VT(mda_context_t* ctx);   ///< Vertical Tab: advance down by vtab_size
 void mda_FF(mda_context_t* ctx);   ///< Form Feed: clear screen, home cursor
 void mda_CR(mda_context_t* ctx);   ///< Carriage Return: move to start of line
 void mda_ESC(const mda_context_t* ctx);  ///< Escape: begin control sequence (stub)
 /**
- * @brief Handle ASCII DEL — overwrite with invisible character.
- * @details Unlike BS, DEL does not move cursor left.
- * Instead, it writes an MDA_INVISIBLE cell (attribute 0x00).
- * This matches hardware behavior on MDA/Hercules.
+ * @brief Handle ASCII DEL — rub out the character left of the cursor.
+ * @details Backspace, overwrite with a space, backspace again.
+ * @see mda_line_edit.h for full line editing.
  */
-void mda_DEL(const mda_context_t* ctx);
+void mda_DEL(mda_context_t* ctx);
 ///@}
 
 
@@ -100,9 +130,9 @@ void mda_DEL(const mda_context_t* ctx);
  * @brief Character writing and standard line-ending sequences.
  * @{
  */
-void mda_CRLF(const mda_context_t* ctx);
-void mda_print_char(const mda_context_t* ctx, char chr);
-void mda_print_string(const mda_context_t* ctx, char* str);
+void mda_CRLF(mda_context_t* ctx);
+void mda_print_char(mda_context_t* ctx, char chr);
+void mda_print_string(mda_context_t* ctx, char* str);
 ///@}
 
 #endif /* MDA_CONTEXT_H */
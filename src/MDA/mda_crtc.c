@@ -0,0 +1,114 @@
+/**
+ * @file mda_crtc.c
+ * @brief Implementation of 6845 CRTC Access and Hardware Scrolling
+ * @details On DOS registers are written through the index/data port pair;
+ * on the host the writes land in mda_crtc_model.
+ *
+ * The host page is linear: cells drawn past its end land in the copy that
+ * follows rather than wrapping. Only the 2000 displayed cells are drawn
+ * between moves of the start address, so folding them back to their wrapped
+ * positions and copying the page over its mirror before each move leaves
+ * both copies as the real mirror would.
+ * @author Jeremy Thornton
+ */
+#include "mda_crtc.h"
+#include "mda_primitives.h"
+#include "mda_trace.h"
+#include "../CONTRACT/contract.h"
+#include <string.h>
+
+uint16_t mda_vram_base = 0;
+
+#ifndef __DOS__
+mda_crtc_model_t mda_crtc_model;
+#endif
+
+#ifdef __DOS__
+void mda_crtc_write(uint8_t reg, uint8_t value) {
+    __asm {
+        .8086
+        mov dx, 3B4h        ; DX = MDA_CRTC_INDEX
+        mov al, reg
+        out dx, al          ; select register
+        inc dx              ; DX = MDA_CRTC_DATA
+        mov al, value
+        out dx, al          ; write register
+    }
+}
+#else
+void mda_crtc_write(uint8_t reg, uint8_t value) {
+    require(reg < MDA_CRTC_REGISTERS, "INVALID CRTC register!");
+    mda_crtc_model.index = reg;
+    mda_crtc_model.regs[reg] = value;
+}
+
+mda_cell_t mda_crtc_model_cell(uint8_t x, uint8_t y) {
+    uint16_t start = ((mda_crtc_model.regs[MDA_CRTC_START_HI] << 8) | mda_crtc_model.regs[MDA_CRTC_START_LO]) & MDA_CRTC_WORD_MASK;
+    return mda_crtc_model.vram[start + y * MDA_COLUMNS + x];
+}
+
+/**
+ * @brief Fold the displayed cells into the page and refresh the mirror.
+ */
+static void crtc_fold(void) {
+    uint16_t start = mda_crtc_start();
+    for (uint16_t i = MDA_CRTC_PAGE_WORDS - start; i < MDA_SCREEN_WORDS; ++i) {
+        mda_crtc_model.vram[(start + i) & MDA_CRTC_WORD_MASK] = mda_crtc_model.vram[start + i];
+    }
+    memcpy(mda_crtc_model.vram + MDA_CRTC_PAGE_WORDS, mda_crtc_model.vram, MDA_CRTC_PAGE_BYTES);
+}
+#endif
+
+/**
+ * @brief Rebase the primitives on a new start address.
+ */
+static void crtc_rebase(uint16_t start) {
+#ifndef __DOS__
+    crtc_fold();
+#endif
+    mda_vram_base = start << 1;
+}
+
+/**
+ * @brief Load the start address registers; the 6845 latches them at the next frame.
+ */
+static void crtc_load_start(uint16_t start) {
+    mda_crtc_write(MDA_CRTC_START_HI, (uint8_t)(start >> 8));
+    mda_crtc_write(MDA_CRTC_START_LO, (uint8_t)start);
+}
+
+void mda_crtc_set_start(uint16_t start) {
+    start &= MDA_CRTC_WORD_MASK;
+    crtc_rebase(start);
+    crtc_load_start(start);
+}
+
+void mda_crtc_set_cursor(uint8_t x, uint8_t y) {
+    uint16_t addr = (mda_crtc_start() + y * MDA_COLUMNS + x) & MDA_CRTC_WORD_MASK;
+    mda_crtc_write(MDA_CRTC_CURSOR_HI, (uint8_t)(addr >> 8));
+    mda_crtc_write(MDA_CRTC_CURSOR_LO, (uint8_t)addr);
+}
+
+void mda_hw_scroll_up(const mda_cell_t* blank) {
+    require_address(blank, "NULL blank!");
+    MDA_TRACE_CALL(MDA_TRACE_HW_SCROLL_UP, blank, 2, NULL, 0, NULL, 0);
+    mda_point_t p0 = mda_point_make(0, MDA_ROWS - 1);
+    mda_point_t p1 = mda_point_make(MDA_COLUMNS - 1, MDA_ROWS - 1);
+    uint16_t start = (mda_crtc_start() + MDA_COLUMNS) & MDA_CRTC_WORD_MASK;
+    crtc_rebase(start);
+    mda_draw_hline(&p0, &p1, blank);    // exposed bottom row, overlaps only the old top row
+    crtc_load_start(start);
+    MDA_TRACE_LEAVE();
+}
+
+void mda_hw_scroll_down(const mda_cell_t* blank) {
+    require_address(blank, "NULL blank!");
+    MDA_TRACE_CALL(MDA_TRACE_HW_SCROLL_DOWN, blank, 2, NULL, 0, NULL, 0);
+    mda_point_t p0 = mda_point_make(0, 0);
+    mda_point_t p1 = mda_point_make(MDA_COLUMNS - 1, 0);
+    uint16_t start = (mda_crtc_start() - MDA_COLUMNS) & MDA_CRTC_WORD_MASK;
+    crtc_rebase(start);
+    mda_draw_hline(&p0, &p1, blank);    // exposed top row, overlaps only the old bottom row
+    crtc_load_start(start);
+    MDA_TRACE_LEAVE();
+}
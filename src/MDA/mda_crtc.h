@@ -0,0 +1,120 @@
+/**
+ * @file mda_crtc.h
+ * @brief MDA/Hercules 6845 CRT Controller Access and Hardware Scrolling
+ * @details The 6845 fetches the displayed text page starting at the word
+ * address held in its start-address registers (R12/R13). The MDA has 4 KB
+ * of text memory (2048 cells) which the CRTC addresses modulo 2048 and the
+ * bus mirrors across the whole B000h window, so the visible 80x25 page can
+ * start at any cell and wrap past the end of the 4 KB without a seam.
+ *
+ * Hardware scrolling advances the start address by one row (80 cells) and
+ * clears only the newly exposed row, instead of moving 3840 bytes.
+ *
+ * Every drawing primitive addresses cells relative to the current start
+ * address via mda_vram_base, so callers keep using screen coordinates.
+ * Offsets can reach base + 4000 < 8 KB, which on the MDA lands in the
+ * mirror; no explicit wrap is needed on the hot path.
+ *
+ * @warning Hercules cards decode 64 KB at B000h and do not mirror the text
+ *          page, so hardware scrolling must stay disabled on them.
+ *
+ * On the host build the CRTC is a software model holding the register file
+ * and the 4 KB page followed by its mirror, so the wraparound arithmetic can
+ * be exercised on Linux and the primitives address it exactly as on the MDA.
+ *
+ * @author Jeremy Thornton
+ */
+#ifndef MDA_CRTC_H
+#define MDA_CRTC_H
+
+#include "mda_cell.h"
+#include "mda_constants.h"
+#include "mda_types.h"
+#include <stdint.h>
+
+#define MDA_CRTC_INDEX          0x3B4   /**< 6845 register select port */
+#define MDA_CRTC_DATA           0x3B5   /**< 6845 register data port */
+#define MDA_CRTC_CURSOR_START   0x0A    /**< R10 cursor start scan line */
+#define MDA_CRTC_CURSOR_END     0x0B    /**< R11 cursor end scan line */
+#define MDA_CRTC_START_HI       0x0C    /**< R12 display start address (high) */
+#define MDA_CRTC_START_LO       0x0D    /**< R13 display start address (low) */
+#define MDA_CRTC_CURSOR_HI      0x0E    /**< R14 cursor address (high) */
+#define MDA_CRTC_CURSOR_LO      0x0F    /**< R15 cursor address (low) */
+#define MDA_CRTC_REGISTERS      18      /**< R0..R17 */
+#define MDA_CRTC_PAGE_WORDS     2048    /**< Cells of text memory on the card */
+#define MDA_CRTC_PAGE_BYTES     4096    /**< Bytes of text memory on the card */
+#define MDA_CRTC_WORD_MASK      0x07FF  /**< Wrap a cell address to the page */
+#define MDA_CRTC_BYTE_MASK      0x0FFF  /**< Wrap a byte offset to the page */
+
+/**
+ * @brief Byte offset of displayed cell (0,0) from B000:0000.
+ * @details Always start address * 2; read by every primitive before drawing.
+ */
+extern uint16_t mda_vram_base;
+
+/**
+ * @brief Write one 6845 register.
+ */
+void mda_crtc_write(uint8_t reg, uint8_t value);
+
+/**
+ * @brief Program the display start address and rebase the primitives.
+ * @param start Cell address of the top left of the screen (wrapped to 0..2047).
+ */
+void mda_crtc_set_start(uint16_t start);
+
+/**
+ * @brief Current display start address in cells.
+ */
+static inline uint16_t mda_crtc_start(void) {
+    return mda_vram_base >> 1;
+}
+
+/**
+ * @brief Place the hardware cursor over screen cell (x,y), relative to the start address.
+ * @note The BIOS assumes a start address of 0; use this after moving the
+ *       BIOS cursor whenever hardware scrolling is in use.
+ */
+void mda_crtc_set_cursor(uint8_t x, uint8_t y);
+
+/**
+ * @brief Byte offset of screen cell (x,y) within the 4 KB text page.
+ * @details The C reference for the addressing the primitives perform; the
+ * mask is what the mirror provides for free on real hardware.
+ */
+static inline uint16_t mda_crtc_offset(const mda_point_t* point) {
+    return (mda_vram_base + (point->y * MDA_COLUMNS + point->x) * 2) & MDA_CRTC_BYTE_MASK;
+}
+
+/**
+ * @defgroup hw_scrolling_ops Hardware Scrolling Operations
+ * @brief Full screen scrolls by moving the display start address.
+ * @details The exposed row is cleared before the start address moves. With
+ * only 48 spare cells in the page it overlaps the row that is scrolling off,
+ * never a row that stays visible, so no stale row is ever displayed.
+ * @{
+ */
+void mda_hw_scroll_up(const mda_cell_t* blank);     ///< Scroll the whole screen up by one line
+void mda_hw_scroll_down(const mda_cell_t* blank);   ///< Scroll the whole screen down by one line
+///@}
+
+#ifndef __DOS__
+/**
+ * @struct mda_crtc_model_t
+ * @brief Host stand-in for the 6845 and its 4 KB of text memory.
+ */
+typedef struct {
+    mda_cell_t vram[MDA_CRTC_PAGE_WORDS * 2];   /**< Text page, then its mirror */
+    uint8_t index;                              /**< Last register selected */
+    uint8_t regs[MDA_CRTC_REGISTERS];           /**< Register file */
+} mda_crtc_model_t;
+
+extern mda_crtc_model_t mda_crtc_model;
+
+/**
+ * @brief Cell the model would display at screen (x,y), following the start address registers.
+ */
+mda_cell_t mda_crtc_model_cell(uint8_t x, uint8_t y);
+#endif
+
+#endif /* MDA_CRTC_H */
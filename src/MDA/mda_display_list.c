@@ -0,0 +1,213 @@
+/**
+ * @file mda_display_list.c
+ * @brief Implementation of the Deferred Display List
+ * @details Culled commands are marked with a zero width and squeezed out
+ * while merging. Row composition tracks coverage with a per-column stamp
+ * (row number + 1), so the coverage mask never needs clearing between rows.
+ * @author Jeremy Thornton
+ */
+#include "mda_display_list.h"
+#include "mda_primitives.h"
+#include "../CONTRACT/contract.h"
+#include <stdbool.h>
+#include <string.h>
+
+/**
+ * @brief true if rect a lies entirely inside rect b.
+ */
+static bool dl_covers(const mda_rect_t* b, const mda_rect_t* a) {
+    return a->x >= b->x && a->y >= b->y &&
+           a->x + a->w <= b->x + b->w && a->y + a->h <= b->y + b->h;
+}
+
+/**
+ * @brief Append a normalized command, flushing first if the buffer is full.
+ */
+static void dl_record(mda_display_list_t* dl, uint8_t x, uint8_t y, uint8_t w, uint8_t h, const mda_cell_t* cell) {
+    require_address(dl, "NULL display list!");
+    require_address(cell, "NULL cell!");
+    require(w > 0 && h > 0, "EMPTY command!");
+    if (dl->count == dl->capacity) {
+        mda_display_list_submit(dl);
+    }
+    mda_draw_cmd_t* cmd = &dl->cmds[dl->count++];
+    cmd->rect = mda_rect_make(x, y, w, h);
+    cmd->cell = *cell;
+}
+
+/**
+ * @brief Mark every command that a later command paints over completely.
+ */
+static void dl_cull(mda_display_list_t* dl) {
+    for (uint16_t i = 0; i + 1 < dl->count; ++i) {
+        for (uint16_t j = i + 1; j < dl->count; ++j) {
+            if (dl->cmds[j].rect.w > 0 && dl_covers(&dl->cmds[j].rect, &dl->cmds[i].rect)) {
+                dl->cmds[i].rect.w = 0;
+                break;
+            }
+        }
+    }
+}
+
+/**
+ * @brief Try to grow a into the union of a and b.
+ * @return true if a and b share a cell and together form a rectangle.
+ */
+static bool dl_merge(mda_draw_cmd_t* a, const mda_draw_cmd_t* b) {
+    mda_rect_t* r = &a->rect;
+    const mda_rect_t* s = &b->rect;
+    if (a->cell.packed != b->cell.packed) {
+        return false;
+    }
+    if (r->y == s->y && r->h == s->h) {         // side by side
+        if (r->x + r->w == s->x) {
+            r->w += s->w;
+            return true;
+        }
+        if (s->x + s->w == r->x) {
+            r->x = s->x;
+            r->w += s->w;
+            return true;
+        }
+    }
+    if (r->x == s->x && r->w == s->w) {         // stacked
+        if (r->y + r->h == s->y) {
+            r->h += s->h;
+            return true;
+        }
+        if (s->y + s->h == r->y) {
+            r->y = s->y;
+            r->h += s->h;
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Drop culled commands and merge consecutive survivors in place.
+ * @details Only neighbours in submission order are merged, so painter's
+ * order is preserved.
+ */
+static void dl_compact(mda_display_list_t* dl) {
+    uint16_t n = 0;
+    for (uint16_t i = 0; i < dl->count; ++i) {
+        if (dl->cmds[i].rect.w == 0) {
+            continue;
+        }
+        if (n > 0 && dl_merge(&dl->cmds[n - 1], &dl->cmds[i])) {
+            continue;
+        }
+        dl->cmds[n++] = dl->cmds[i];
+    }
+    dl->count = n;
+}
+
+/**
+ * @brief Compose each touched row in painter's order and commit its covered runs.
+ */
+static void dl_execute(const mda_display_list_t* dl) {
+    mda_cell_t row[MDA_COLUMNS];
+    uint8_t stamp[MDA_COLUMNS];
+    uint8_t top = MDA_ROWS;
+    uint8_t bottom = 0;
+    for (uint16_t i = 0; i < dl->count; ++i) {
+        const mda_rect_t* r = &dl->cmds[i].rect;
+        if (r->y < top) {
+            top = r->y;
+        }
+        if (r->y + r->h > bottom) {
+            bottom = r->y + r->h;
+        }
+    }
+    memset(stamp, 0, sizeof(stamp));
+    for (uint8_t y = top; y < bottom; ++y) {
+        uint8_t mark = y + 1;
+        uint8_t left = MDA_COLUMNS;
+        uint8_t right = 0;
+        for (uint16_t i = 0; i < dl->count; ++i) {
+            const mda_draw_cmd_t* cmd = &dl->cmds[i];
+            if (y < cmd->rect.y || y >= cmd->rect.y + cmd->rect.h) {
+                continue;
+            }
+            uint8_t end = cmd->rect.x + cmd->rect.w;
+            for (uint8_t x = cmd->rect.x; x < end; ++x) {
+                row[x] = cmd->cell;
+                stamp[x] = mark;
+            }
+            if (cmd->rect.x < left) {
+                left = cmd->rect.x;
+            }
+            if (end > right) {
+                right = end;
+            }
+        }
+        uint8_t x = left;
+        while (x < right) {                     // one write per covered run
+            if (stamp[x] != mark) {
+                x++;
+                continue;
+            }
+            uint8_t start = x;
+            while (x < right && stamp[x] == mark) {
+                x++;
+            }
+            mda_point_t p = mda_point_make(start, y);
+            mda_write_cells(&p, &row[start], x - start);
+        }
+    }
+}
+
+void mda_display_list_init(mda_display_list_t* dl, mda_draw_cmd_t* cmds, uint16_t capacity) {
+    require_address(dl, "NULL display list!");
+    require_address(cmds, "NULL command buffer!");
+    require(capacity > 0, "EMPTY command buffer!");
+    dl->cmds = cmds;
+    dl->capacity = capacity;
+    dl->count = 0;
+}
+
+void mda_display_list_plot(mda_display_list_t* dl, const mda_point_t* point, const mda_cell_t* cell) {
+    require_address(point, "NULL point!");
+    dl_record(dl, point->x, point->y, 1, 1, cell);
+}
+
+void mda_display_list_hline(mda_display_list_t* dl, const mda_point_t* p0, const mda_point_t* p1, const mda_cell_t* cell) {
+    require_address(p0, "NULL point!");
+    require_address(p1, "NULL point!");
+    dl_record(dl, p0->x, p0->y, p1->x - p0->x + 1, 1, cell);
+}
+
+void mda_display_list_vline(mda_display_list_t* dl, const mda_point_t* p0, const mda_point_t* p1, const mda_cell_t* cell) {
+    require_address(p0, "NULL point!");
+    require_address(p1, "NULL point!");
+    dl_record(dl, p0->x, p0->y, 1, p1->y - p0->y + 1, cell);
+}
+
+void mda_display_list_rect(mda_display_list_t* dl, const mda_rect_t* rect, const mda_cell_t* cell) {
+    require_address(rect, "NULL rectangle!");
+    dl_record(dl, rect->x, rect->y, rect->w, 1, cell);  // top
+    if (rect->h > 2) {  // sides
+        dl_record(dl, rect->x, rect->y + 1, 1, rect->h - 2, cell);
+        dl_record(dl, rect->x + rect->w - 1, rect->y + 1, 1, rect->h - 2, cell);
+    }
+    if (rect->h > 1) {  // bottom
+        dl_record(dl, rect->x, rect->y + rect->h - 1, rect->w, 1, cell);
+    }
+}
+
+void mda_display_list_fill_rect(mda_display_list_t* dl, const mda_rect_t* rect, const mda_cell_t* cell) {
+    require_address(rect, "NULL rectangle!");
+    dl_record(dl, rect->x, rect->y, rect->w, rect->h, cell);
+}
+
+void mda_display_list_submit(mda_display_list_t* dl) {
+    require_address(dl, "NULL display list!");
+    if (dl->count == 0) {
+        return;
+    }
+    dl_cull(dl);
+    dl_compact(dl);
+    dl_execute(dl);
+    dl->count = 0;
+}
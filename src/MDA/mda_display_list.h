@@ -0,0 +1,73 @@
+/**
+ * @file mda_display_list.h
+ * @brief Deferred Display List of Drawing Primitives
+ * @details Records plots, lines and rectangles into a caller supplied
+ * command buffer instead of drawing them immediately. Every primitive is
+ * normalized to a rectangle filled with one cell, so a command is 6 bytes.
+ *
+ * On submit the list is optimized and executed in a single pass:
+ * - commands fully covered by a later command are culled;
+ * - consecutive commands with the same cell that abut horizontally or
+ *   vertically and form a rectangle are merged;
+ * - the screen is composed row by row in painter's order into a row buffer,
+ *   and each covered run is committed with one mda_write_cells().
+ *
+ * Each cell is therefore written to VRAM at most once per submit, however
+ * many commands overlap it, and ES/address setup happens once per run.
+ *
+ * @note Like the primitives, commands are unbounded — caller must clip.
+ * @author Jeremy Thornton
+ */
+#ifndef MDA_DISPLAY_LIST_H
+#define MDA_DISPLAY_LIST_H
+
+#include "mda_cell.h"
+#include "mda_constants.h"
+#include "mda_types.h"
+#include <stdint.h>
+
+/**
+ * @struct mda_draw_cmd_t
+ * @brief One recorded command: fill rect with cell.
+ */
+typedef struct {
+    mda_rect_t rect;        /**< Area covered */
+    mda_cell_t cell;        /**< Character:attribute written to every cell */
+} mda_draw_cmd_t;
+
+/**
+ * @struct mda_display_list_t
+ * @brief Command buffer; flushed automatically when full.
+ */
+typedef struct {
+    mda_draw_cmd_t* cmds;   /**< Caller supplied command storage */
+    uint16_t capacity;      /**< Commands that fit in cmds */
+    uint16_t count;         /**< Commands recorded since the last submit */
+} mda_display_list_t;
+
+/**
+ * @brief Initialize an empty display list over caller storage.
+ * @param dl       List to initialize.
+ * @param cmds     Command storage.
+ * @param capacity Number of commands in cmds.
+ */
+void mda_display_list_init(mda_display_list_t* dl, mda_draw_cmd_t* cmds, uint16_t capacity);
+
+/**
+ * @defgroup display_list_record Recording
+ * @brief Same arguments and results as the immediate primitives, deferred.
+ * @{
+ */
+void mda_display_list_plot(mda_display_list_t* dl, const mda_point_t* point, const mda_cell_t* cell);
+void mda_display_list_hline(mda_display_list_t* dl, const mda_point_t* p0, const mda_point_t* p1, const mda_cell_t* cell);
+void mda_display_list_vline(mda_display_list_t* dl, const mda_point_t* p0, const mda_point_t* p1, const mda_cell_t* cell);
+void mda_display_list_rect(mda_display_list_t* dl, const mda_rect_t* rect, const mda_cell_t* cell);      ///< Outline, as mda_draw_rect()
+void mda_display_list_fill_rect(mda_display_list_t* dl, const mda_rect_t* rect, const mda_cell_t* cell); ///< Solid, as mda_fill_rect()
+///@}
+
+/**
+ * @brief Cull, merge and execute every recorded command, then empty the list.
+ */
+void mda_display_list_submit(mda_display_list_t* dl);
+
+#endif /* MDA_DISPLAY_LIST_H */
@@ -0,0 +1,456 @@
+/**
+ * @file mda_editor.c
+ * @brief Implementation of the Gap-Buffer Text Editor Widget
+ * @details Every edit first moves the index split just below the cursor
+ * line and the gap to the cursor; from then on inserting or deleting a
+ * byte is a single store or pointer bump, and only a line break adds or
+ * removes an index entry.
+ * @author Jeremy Thornton
+ */
+#include "mda_editor.h"
+#include "mda_constants.h"
+#include "mda_crtc.h"
+#include "mda_primitives.h"
+#include "../BIOS/bios_keyboard_constants.h"
+#include "../CONTRACT/contract.h"
+#include <stdio.h>
+#include <string.h>
+
+uint16_t mda_editor_length(const mda_editor_t* ed) {
+    require_address(ed, "NULL editor!");
+    return ed->capacity - (ed->gap_end - ed->gap_start);
+}
+
+static uint16_t editor_line_start(const mda_editor_t* ed, uint16_t i) {
+    return (i < ed->split) ? ed->lines[i] : mda_editor_length(ed) - ed->lines[i];
+}
+
+/**
+ * @brief Bytes of line i, excluding its '\n'.
+ */
+static uint16_t editor_line_length(const mda_editor_t* ed, uint16_t i) {
+    uint16_t end = (i + 1 < ed->line_count) ? editor_line_start(ed, i + 1) - 1 : mda_editor_length(ed);
+    return end - editor_line_start(ed, i);
+}
+
+/**
+ * @brief Move the index split to k; an entry switches between counting
+ *        from the start and from the end of the text as it crosses.
+ */
+static void editor_split(mda_editor_t* ed, uint16_t k) {
+    uint16_t length = mda_editor_length(ed);
+    while (ed->split < k) {
+        ed->lines[ed->split] = length - ed->lines[ed->split];
+        ed->split++;
+    }
+    while (ed->split > k) {
+        ed->split--;
+        ed->lines[ed->split] = length - ed->lines[ed->split];
+    }
+}
+
+/**
+ * @brief Move the gap to text offset pos, shifting only the bytes between.
+ */
+static void editor_move_gap(mda_editor_t* ed, uint16_t pos) {
+    if (pos < ed->gap_start) {
+        uint16_t n = ed->gap_start - pos;
+        memmove(ed->buffer + ed->gap_end - n, ed->buffer + pos, n);
+        ed->gap_start -= n;
+        ed->gap_end -= n;
+    }
+    else if (pos > ed->gap_start) {
+        uint16_t n = pos - ed->gap_start;
+        memmove(ed->buffer + ed->gap_start, ed->buffer + ed->gap_end, n);
+        ed->gap_start += n;
+        ed->gap_end += n;
+    }
+}
+
+/**
+ * @brief Prepare an edit at the cursor: split below its line, gap at the cursor.
+ */
+static void editor_prepare(mda_editor_t* ed) {
+    editor_split(ed, ed->row + 1);
+    editor_move_gap(ed, editor_line_start(ed, ed->row) + ed->col);
+    ed->modified = true;
+}
+
+/**
+ * @brief Rebuild the index over the first length bytes of the buffer.
+ */
+static bool editor_index(mda_editor_t* ed, uint16_t length) {
+    ed->gap_start = length;
+    ed->gap_end = ed->capacity;
+    ed->lines[0] = 0;
+    ed->line_count = 1;
+    for (uint16_t i = 0; i < length; ++i) {
+        if (ed->buffer[i] == '\n') {
+            if (ed->line_count == ed->line_capacity) {
+                return false;
+            }
+            ed->lines[ed->line_count++] = i + 1;
+        }
+    }
+    ed->split = ed->line_count;
+    ed->row = ed->col = ed->goal = 0;
+    ed->top = ed->left = 0;
+    ed->modified = false;
+    return true;
+}
+
+/**
+ * @brief Draw screen row r of the view.
+ */
+static void editor_draw_row(const mda_editor_t* ed, uint8_t r) {
+    mda_cell_t row[MDA_COLUMNS];
+    uint8_t w = ed->bounds.w;
+    for (uint8_t x = 0; x < w; ++x) {
+        row[x] = ed->blank;
+    }
+    uint16_t li = ed->top + r;
+    if (li < ed->line_count) {
+        uint16_t length = editor_line_length(ed, li);
+        if (length > ed->left) {
+            uint16_t pos = editor_line_start(ed, li) + ed->left;
+            uint8_t n = (length - ed->left < w) ? (uint8_t)(length - ed->left) : w;
+            uint16_t attr = ed->blank.packed & 0xFF00;
+            uint16_t gap = ed->gap_end - ed->gap_start;
+            const char* src = ed->buffer + pos + ((pos >= ed->gap_start) ? gap : 0);
+            for (uint8_t x = 0; x < n; ++x) {
+                row[x].packed = attr | (uint8_t)((*src == '\t') ? ' ' : *src);
+                src++;
+                if (++pos == ed->gap_start) {   // continue after the gap
+                    src += gap;
+                }
+            }
+        }
+    }
+    mda_point_t p = mda_point_make(ed->bounds.x, ed->bounds.y + r);
+    mda_write_cells(&p, row, w);
+}
+
+static void editor_draw_rows(const mda_editor_t* ed, uint8_t from, uint8_t to) {
+    for (uint8_t r = from; r <= to; ++r) {
+        editor_draw_row(ed, r);
+    }
+}
+
+/**
+ * @brief Scroll screen rows from..h-1 of the view by one row.
+ * @return false if the region is a single row (the caller draws it instead).
+ */
+static bool editor_scroll(const mda_editor_t* ed, uint8_t from, bool up) {
+    if (ed->bounds.h - from < 2) {
+        return false;
+    }
+    mda_rect_t region = mda_rect_make(ed->bounds.x, ed->bounds.y + from, ed->bounds.w, ed->bounds.h - from);
+    if (up) {
+        mda_scroll_up(&region, &ed->blank);
+    }
+    else {
+        mda_scroll_down(&region, &ed->blank);
+    }
+    return true;
+}
+
+/**
+ * @brief Keep the cursor in view, scrolling one line incrementally where
+ *        possible, and place the hardware cursor.
+ */
+static void editor_follow(mda_editor_t* ed) {
+    uint8_t h = ed->bounds.h;
+    uint8_t w = ed->bounds.w;
+    bool repaint = false;
+    if (ed->col < ed->left) {
+        ed->left = ed->col;
+        repaint = true;
+    }
+    else if (ed->col >= ed->left + w) {
+        ed->left = ed->col - w + 1;
+        repaint = true;
+    }
+    if (ed->row < ed->top) {
+        if (ed->top - ed->row == 1 && !repaint && editor_scroll(ed, 0, false)) {
+            ed->top--;
+            editor_draw_row(ed, 0);
+        }
+        else {
+            ed->top = ed->row;
+            repaint = true;
+        }
+    }
+    else if (ed->row >= ed->top + h) {
+        if (ed->row == ed->top + h && !repaint && editor_scroll(ed, 0, true)) {
+            ed->top++;
+            editor_draw_row(ed, h - 1);
+        }
+        else {
+            ed->top = ed->row - h + 1;
+            repaint = true;
+        }
+    }
+    if (repaint) {
+        editor_draw_rows(ed, 0, h - 1);
+    }
+    mda_crtc_set_cursor(ed->bounds.x + (uint8_t)(ed->col - ed->left), ed->bounds.y + (uint8_t)(ed->row - ed->top));
+}
+
+/**
+ * @brief Line at screen row s was split: open a row below it.
+ */
+static void editor_opened(const mda_editor_t* ed, uint8_t s) {
+    uint8_t h = ed->bounds.h;
+    editor_draw_row(ed, s);
+    if (s + 1 < h) {
+        editor_scroll(ed, s + 1, false);
+        editor_draw_row(ed, s + 1);
+    }
+}
+
+/**
+ * @brief The line below screen row s was joined into it: close that row.
+ */
+static void editor_joined(const mda_editor_t* ed, uint8_t s) {
+    uint8_t h = ed->bounds.h;
+    editor_draw_row(ed, s);
+    if (s + 1 < h) {
+        editor_scroll(ed, s + 1, true);
+        editor_draw_row(ed, h - 1);
+    }
+}
+
+/**
+ * @brief Join line l onto line l-1 by deleting the '\n' between them.
+ */
+static void editor_join(mda_editor_t* ed, uint16_t l) {
+    editor_split(ed, l + 1);
+    editor_move_gap(ed, editor_line_start(ed, l));
+    ed->gap_start--;
+    memmove(&ed->lines[l], &ed->lines[l + 1], (ed->line_count - l - 1) * sizeof(uint16_t));
+    ed->line_count--;
+    ed->split = l;      // the entries that moved down count from the end
+    ed->modified = true;
+}
+
+static bool editor_newline(mda_editor_t* ed) {
+    if (ed->gap_start == ed->gap_end || ed->line_count == ed->line_capacity) {
+        return false;
+    }
+    editor_prepare(ed);
+    ed->buffer[ed->gap_start++] = '\n';
+    uint16_t i = ed->row + 1;
+    memmove(&ed->lines[i + 1], &ed->lines[i], (ed->line_count - i) * sizeof(uint16_t));
+    ed->lines[i] = ed->gap_start;
+    ed->line_count++;
+    ed->split = i + 1;
+    uint8_t s = (uint8_t)(ed->row - ed->top);
+    ed->row = i;
+    ed->col = ed->goal = 0;
+    if (ed->left == 0) {    // otherwise follow repaints anyway
+        editor_opened(ed, s);
+    }
+    editor_follow(ed);
+    return true;
+}
+
+void mda_editor_init(mda_editor_t* ed, const mda_rect_t* bounds, const mda_cell_t* blank,
+                     char* buffer, uint16_t capacity, uint16_t* lines, uint16_t line_capacity) {
+    require_address(ed, "NULL editor!");
+    require_address(bounds, "NULL bounds!");
+    require_address(blank, "NULL blank!");
+    require_address(buffer, "NULL buffer!");
+    require_address(lines, "NULL lines!");
+    require(line_capacity > 0, "INVALID line capacity!");
+    require(bounds->w > 0 && bounds->h > 0, "INVALID editor bounds!");
+    ed->bounds = *bounds;
+    ed->blank = *blank;
+    ed->buffer = buffer;
+    ed->capacity = capacity;
+    ed->lines = lines;
+    ed->line_capacity = line_capacity;
+    editor_index(ed, 0);
+}
+
+bool mda_editor_set_text(mda_editor_t* ed, const char* text, uint16_t length) {
+    require_address(ed, "NULL editor!");
+    require_address(text, "NULL text!");
+    if (length > ed->capacity) {
+        editor_index(ed, 0);
+        return false;
+    }
+    memmove(ed->buffer, text, length);
+    if (!editor_index(ed, length)) {
+        editor_index(ed, 0);
+        return false;
+    }
+    return true;
+}
+
+bool mda_editor_load(mda_editor_t* ed, const char* path) {
+    require_address(ed, "NULL editor!");
+    require_address(path, "NULL path!");
+    FILE* f = fopen(path, "r");
+    if (!f) {
+        return false;
+    }
+    uint16_t length = (uint16_t)fread(ed->buffer, 1, ed->capacity, f);
+    bool fits = !ferror(f) && fgetc(f) == EOF;
+    fclose(f);
+    if (!fits || !editor_index(ed, length)) {
+        editor_index(ed, 0);
+        return false;
+    }
+    return true;
+}
+
+bool mda_editor_save(mda_editor_t* ed, const char* path) {
+    require_address(ed, "NULL editor!");
+    require_address(path, "NULL path!");
+    FILE* f = fopen(path, "w");
+    if (!f) {
+        return false;
+    }
+    uint16_t tail = ed->capacity - ed->gap_end;
+    bool ok = fwrite(ed->buffer, 1, ed->gap_start, f) == ed->gap_start
+              && fwrite(ed->buffer + ed->gap_end, 1, tail, f) == tail;
+    ok = (fclose(f) == 0) && ok;
+    if (ok) {
+        ed->modified = false;
+    }
+    return ok;
+}
+
+bool mda_editor_insert(mda_editor_t* ed, char chr) {
+    require_address(ed, "NULL editor!");
+    if (chr == '\n') {
+        return editor_newline(ed);
+    }
+    if (ed->gap_start == ed->gap_end) {
+        return false;
+    }
+    editor_prepare(ed);
+    ed->buffer[ed->gap_start++] = chr;
+    ed->goal = ++ed->col;
+    editor_draw_row(ed, (uint8_t)(ed->row - ed->top));
+    editor_follow(ed);
+    return true;
+}
+
+bool mda_editor_backspace(mda_editor_t* ed) {
+    require_address(ed, "NULL editor!");
+    if (ed->col > 0) {
+        editor_prepare(ed);
+        ed->gap_start--;
+        ed->goal = --ed->col;
+        editor_draw_row(ed, (uint8_t)(ed->row - ed->top));
+        editor_follow(ed);
+        return true;
+    }
+    if (ed->row == 0) {
+        return false;
+    }
+    uint16_t col = editor_line_length(ed, ed->row - 1);
+    editor_join(ed, ed->row);
+    ed->row--;
+    ed->col = ed->goal = col;
+    if (ed->row < ed->top) {    // joined into the line above the view
+        ed->top = ed->row;
+        editor_draw_rows(ed, 0, ed->bounds.h - 1);
+    }
+    else {
+        editor_joined(ed, (uint8_t)(ed->row - ed->top));
+    }
+    editor_follow(ed);
+    return true;
+}
+
+bool mda_editor_delete(mda_editor_t* ed) {
+    require_address(ed, "NULL editor!");
+    if (ed->col < editor_line_length(ed, ed->row)) {
+        editor_prepare(ed);
+        ed->gap_end++;
+        editor_draw_row(ed, (uint8_t)(ed->row - ed->top));
+        return true;
+    }
+    if (ed->row + 1 >= ed->line_count) {
+        return false;
+    }
+    editor_join(ed, ed->row + 1);
+    editor_joined(ed, (uint8_t)(ed->row - ed->top));
+    return true;
+}
+
+void mda_editor_goto(mda_editor_t* ed, uint16_t row, uint16_t col) {
+    require_address(ed, "NULL editor!");
+    ed->row = (row < ed->line_count) ? row : ed->line_count - 1;
+    uint16_t length = editor_line_length(ed, ed->row);
+    ed->col = ed->goal = (col < length) ? col : length;
+    editor_follow(ed);
+}
+
+void mda_editor_move(mda_editor_t* ed, int16_t rows, int16_t cols) {
+    require_address(ed, "NULL editor!");
+    bool across = (cols != 0);
+    if (rows != 0) {
+        int32_t row = (int32_t)ed->row + rows;
+        ed->row = (row < 0) ? 0 : (row >= ed->line_count) ? ed->line_count - 1 : (uint16_t)row;
+        uint16_t length = editor_line_length(ed, ed->row);
+        ed->col = (ed->goal < length) ? ed->goal : length;
+    }
+    for (; cols < 0; ++cols) {
+        if (ed->col > 0) {
+            ed->col--;
+        }
+        else if (ed->row > 0) {
+            ed->row--;
+            ed->col = editor_line_length(ed, ed->row);
+        }
+    }
+    for (; cols > 0; --cols) {
+        if (ed->col < editor_line_length(ed, ed->row)) {
+            ed->col++;
+        }
+        else if (ed->row + 1 < ed->line_count) {
+            ed->row++;
+            ed->col = 0;
+        }
+    }
+    if (across) {
+        ed->goal = ed->col;
+    }
+    editor_follow(ed);
+}
+
+bool mda_editor_key(mda_editor_t* ed, uint16_t key) {
+    require_address(ed, "NULL editor!");
+    int16_t page = ed->bounds.h;
+    switch (BIOS_KEY_SCAN(key)) {
+        case BIOS_SCAN_UP:        mda_editor_move(ed, -1, 0); return true;
+        case BIOS_SCAN_DOWN:      mda_editor_move(ed, 1, 0); return true;
+        case BIOS_SCAN_LEFT:      mda_editor_move(ed, 0, -1); return true;
+        case BIOS_SCAN_RIGHT:     mda_editor_move(ed, 0, 1); return true;
+        case BIOS_SCAN_PGUP:      mda_editor_move(ed, -page, 0); return true;
+        case BIOS_SCAN_PGDN:      mda_editor_move(ed, page, 0); return true;
+        case BIOS_SCAN_HOME:      mda_editor_goto(ed, ed->row, 0); return true;
+        case BIOS_SCAN_END:       mda_editor_goto(ed, ed->row, 0xFFFF); return true;
+        case BIOS_SCAN_DEL:       mda_editor_delete(ed); return true;
+        case BIOS_SCAN_BACKSPACE: mda_editor_backspace(ed); return true;
+        case BIOS_SCAN_ENTER:     mda_editor_insert(ed, '\n'); return true;
+        case BIOS_SCAN_TAB:       mda_editor_insert(ed, '\t'); return true;
+        default:
+            break;
+    }
+    uint8_t chr = (uint8_t)BIOS_KEY_ASCII(key);
+    if (chr < ' ' || chr == 0x7F) {
+        return false;
+    }
+    mda_editor_insert(ed, (char)chr);
+    return true;
+}
+
+void mda_editor_draw(mda_editor_t* ed) {
+    require_address(ed, "NULL editor!");
+    editor_draw_rows(ed, 0, ed->bounds.h - 1);
+    editor_follow(ed);
+}
@@ -0,0 +1,119 @@
+/**
+ * @file mda_editor.h
+ * @brief Gap-Buffer Text Editor Widget
+ * @details An in-place editor for small text files such as configuration
+ * files, viewed through a rectangle that scrolls over text larger than
+ * the screen.
+ *
+ * The text lives in a gap buffer: the free space sits at the cursor, so
+ * typing and deleting move no text at all and moving the cursor moves
+ * only the bytes it passes. A line-start index keeps the start offset of
+ * every line, itself split at the cursor line: starts above the cursor
+ * are stored from the beginning of the text and starts below it from the
+ * end, so an edit inside a line updates no index entry.
+ *
+ * Redraw is incremental:
+ * - typing or deleting within a line redraws that row only;
+ * - splitting a line scrolls the rows below it down one with
+ *   mda_scroll_down() and draws the two rows involved;
+ * - joining lines scrolls the rows below up with mda_scroll_up() and
+ *   draws the joined row and the newly exposed bottom row;
+ * - moving the viewport by one line scrolls and draws one row.
+ * Only horizontal scrolling and long jumps repaint the whole view.
+ *
+ * Tabs are shown as a single space so a column is always a byte.
+ *
+ * @author Jeremy Thornton
+ */
+#ifndef MDA_EDITOR_H
+#define MDA_EDITOR_H
+
+#include "mda_cell.h"
+#include "mda_types.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * @struct mda_editor_t
+ * @brief Gap buffer, line index, cursor and viewport of one editor.
+ */
+typedef struct {
+    mda_rect_t bounds;          /**< Screen rectangle of the view */
+    mda_cell_t blank;           /**< Background; its attribute is used for the text */
+    char* buffer;               /**< Caller supplied text storage */
+    uint16_t capacity;          /**< Bytes in buffer */
+    uint16_t gap_start;         /**< First byte of the gap = cursor offset after an edit */
+    uint16_t gap_end;           /**< First byte after the gap */
+    uint16_t* lines;            /**< Caller supplied line-start index */
+    uint16_t line_capacity;     /**< Entries in lines */
+    uint16_t line_count;        /**< Lines in the text (at least 1) */
+    uint16_t split;             /**< lines[< split] = offset from start, lines[>= split] = offset from end */
+    uint16_t row;               /**< Cursor line */
+    uint16_t col;               /**< Cursor column */
+    uint16_t goal;              /**< Column the cursor tries to keep moving up and down */
+    uint16_t top;               /**< First line shown */
+    uint16_t left;              /**< First column shown */
+    bool modified;              /**< Edited since load or save */
+} mda_editor_t;
+
+/**
+ * @brief Initialize an empty editor over caller storage.
+ * @param buffer        Text storage; its size bounds the file size.
+ * @param lines         Line index storage; its size bounds the line count.
+ */
+void mda_editor_init(mda_editor_t* ed, const mda_rect_t* bounds, const mda_cell_t* blank,
+                     char* buffer, uint16_t capacity, uint16_t* lines, uint16_t line_capacity);
+
+/**
+ * @brief Replace the text and put the cursor at the start.
+ * @return false, leaving the editor empty, if the text does not fit the buffer or the line index.
+ */
+bool mda_editor_set_text(mda_editor_t* ed, const char* text, uint16_t length);
+
+/**
+ * @defgroup editor_files File Access
+ * @brief Text mode: CR LF line ends are read and written on DOS.
+ * @return false on I/O error or if the file does not fit.
+ * @{
+ */
+bool mda_editor_load(mda_editor_t* ed, const char* path);
+bool mda_editor_save(mda_editor_t* ed, const char* path);
+///@}
+
+/**
+ * @brief Bytes of text held.
+ */
+uint16_t mda_editor_length(const mda_editor_t* ed);
+
+/**
+ * @defgroup editor_edit Editing at the Cursor
+ * @return false if nothing changed (buffer full, nothing to delete).
+ * @{
+ */
+bool mda_editor_insert(mda_editor_t* ed, char chr);     ///< Insert a character ('\n' splits the line)
+bool mda_editor_backspace(mda_editor_t* ed);            ///< Delete before the cursor, joining lines at column 0
+bool mda_editor_delete(mda_editor_t* ed);               ///< Delete at the cursor, joining lines at the line end
+///@}
+
+/**
+ * @brief Move the cursor by lines and columns; columns wrap across line ends.
+ */
+void mda_editor_move(mda_editor_t* ed, int16_t rows, int16_t cols);
+
+/**
+ * @brief Move the cursor to line row, column col (clamped to the text).
+ */
+void mda_editor_goto(mda_editor_t* ed, uint16_t row, uint16_t col);
+
+/**
+ * @brief Handle one BIOS keystroke (scan code : ASCII).
+ * @return false if the key is not an editing key (e.g. Esc, function keys).
+ */
+bool mda_editor_key(mda_editor_t* ed, uint16_t key);
+
+/**
+ * @brief Repaint the whole view and place the hardware cursor.
+ */
+void mda_editor_draw(mda_editor_t* ed);
+
+#endif /* MDA_EDITOR_H */
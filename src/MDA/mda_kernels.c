@@ -0,0 +1,508 @@
+/**
+ * @file mda_kernels.c
+ * @brief 80186 and 80386 Primitive Kernels and their Dispatch
+ * @details Addressing on the 80186+ uses immediate shifts:
+ * y * 80 = ((y << 2) + y) << 4, three instructions in place of eight.
+ * `imul reg, reg, imm` is also available from the 80186, but at 21+ clocks
+ * on the 80186/80286 it loses to the shift form.
+ *
+ * The 80386 kernels double the cell (EAX = cell:cell) and move two cells
+ * per `rep stosd` / `rep movsd` iteration, finishing an odd width with a
+ * single word. Only EAX's high half is touched; 16-bit code never keeps
+ * state there.
+ *
+ * Every kernel scrolls forward row by row (rows never overlap), so unlike
+ * the 8086 scroll_down no `std` pass is needed, and a one-row rect simply
+ * blanks that row.
+ * @author Jeremy Thornton
+ */
+#include "mda_kernels.h"
+#include "mda_primitives.h"
+#include "mda_constants.h"
+#include "mda_crtc.h"
+#include "mda_trace.h"
+#include "../CONTRACT/contract.h"
+
+mda_kernels_t mda_kernels = {
+    mda_fill_rect_8086,
+    mda_write_cells_8086,
+    mda_fill_screen_8086,
+    mda_scroll_up_8086,
+    mda_scroll_down_8086
+};
+
+void mda_install_kernels(cpu_type_t cpu) {
+#ifdef __DOS__
+    if (cpu >= CPU_80386) {
+        mda_kernels.fill_rect = mda_fill_rect_386;
+        mda_kernels.write_cells = mda_write_cells_386;
+        mda_kernels.fill_screen = mda_fill_screen_386;
+        mda_kernels.scroll_up = mda_scroll_up_386;
+        mda_kernels.scroll_down = mda_scroll_down_386;
+    }
+    else if (cpu >= CPU_80186) {    // 80286 has nothing further to offer in real mode text
+        mda_kernels.fill_rect = mda_fill_rect_186;
+        mda_kernels.write_cells = mda_write_cells_186;
+        mda_kernels.fill_screen = mda_fill_screen_8086;
+        mda_kernels.scroll_up = mda_scroll_up_186;
+        mda_kernels.scroll_down = mda_scroll_down_186;
+    }
+    else {
+        mda_kernels.fill_rect = mda_fill_rect_8086;
+        mda_kernels.write_cells = mda_write_cells_8086;
+        mda_kernels.fill_screen = mda_fill_screen_8086;
+        mda_kernels.scroll_up = mda_scroll_up_8086;
+        mda_kernels.scroll_down = mda_scroll_down_8086;
+    }
+#else
+    (void)cpu;      // host build: the table keeps the C kernels of mda_primitives.c
+#endif
+}
+
+void mda_fill_rect(const mda_rect_t* rect, const mda_cell_t* cell) {
+    MDA_TRACE_CALL(MDA_TRACE_FILL_RECT, rect, 4, cell, 2, NULL, 0);
+    mda_kernels.fill_rect(rect, cell);
+    MDA_TRACE_LEAVE();
+}
+
+void mda_write_cells(const mda_point_t* point, const mda_cell_t* cells, uint8_t count) {
+    MDA_TRACE_CALL(MDA_TRACE_WRITE_CELLS, point, 2, &count, 1, cells, count * 2);
+    mda_kernels.write_cells(point, cells, count);
+    MDA_TRACE_LEAVE();
+}
+
+void mda_fill_screen(const mda_cell_t* cell) {
+    MDA_TRACE_CALL(MDA_TRACE_FILL_SCREEN, cell, 2, NULL, 0, NULL, 0);
+    mda_kernels.fill_screen(cell);
+    MDA_TRACE_LEAVE();
+}
+
+void mda_scroll_up(const mda_rect_t* rect, const mda_cell_t* blank) {
+    MDA_TRACE_CALL(MDA_TRACE_SCROLL_UP, rect, 4, blank, 2, NULL, 0);
+    mda_kernels.scroll_up(rect, blank);
+    MDA_TRACE_LEAVE();
+}
+
+void mda_scroll_down(const mda_rect_t* rect, const mda_cell_t* blank) {
+    MDA_TRACE_CALL(MDA_TRACE_SCROLL_DOWN, rect, 4, blank, 2, NULL, 0);
+    mda_kernels.scroll_down(rect, blank);
+    MDA_TRACE_LEAVE();
+}
+
+#ifdef __DOS__
+
+void mda_fill_rect_186(const mda_rect_t* rect, const mda_cell_t* cell) {
+    uint16_t base = mda_vram_base;
+    __asm {
+        .186
+        // 1. register & flag setup
+        pushf
+        cld                 ; inc str ops
+        mov ax, MDA_SEGMENT
+        mov es, ax          ; ES:DI *VRAM
+        lds si, rect        ; DS:SI *rect
+        lodsb               ; AL = rect.x
+        xor ah, ah          ; AX = rect.x
+        mov bl, ds:[si]     ; BL = rect.y
+        xor bh, bh          ; BX = rect.y
+        mov cl, ds:[si+1]   ; CL = rect.w
+        xor ch, ch          ; CX = width
+        mov dl, ds:[si+2]   ; DL = rect.h
+        xor dh, dh          ; DX = height
+        // 2. DI = y * 80
+        mov  di, bx
+        shl  di, 2          ; y * 4
+        add  di, bx         ; y * 5
+        shl  di, 4          ; y * 5 * 16
+        add  di, ax         ; y*80 + x
+        shl  di, 1          ; word offset ES:DI *VRAM (x,y)
+        add  di, base       ; start address relative
+        // 3. setup cell
+        lds  si, cell       ; DS:SI *cell
+        lodsw               ; AX = char:attribute pair
+        // 4. calculate next line offset
+        mov si, MDA_ROW_BYTES   ; SI = 160
+        sub si, cx          ; SI = 160 - (width * 2)
+        sub si, cx
+        mov bx, cx          ; BX copy of width
+        // 5. draw horizontal lines length CX height times
+NEXT:   mov cx, bx          ; restore width
+        rep stosw           ; draw hline
+        add di, si          ; next line *VRAM + 160 - width
+        dec dx
+        jnz NEXT
+        popf                ; restore flags
+    }
+}
+
+void mda_write_cells_186(const mda_point_t* point, const mda_cell_t* cells, uint8_t count) {
+    uint16_t base = mda_vram_base;
+    __asm {
+        .186
+        // 1. register & flag setup
+        pushf
+        cld                 ; inc str ops
+        mov ax, MDA_SEGMENT
+        mov es, ax          ; ES:DI *VRAM
+        lds si, point       ; DS:SI *point
+        lodsb               ; AL = x
+        xor ah, ah          ; AX = x
+        mov bl, ds:[si]     ; BL = y
+        xor bh, bh          ; BX = y
+        mov cl, count       ; CL = count
+        xor ch, ch          ; CX = count
+        // 2. DI = y * 80
+        mov  di, bx
+        shl  di, 2          ; y * 4
+        add  di, bx         ; y * 5
+        shl  di, 4          ; y * 5 * 16
+        add  di, ax         ; y*80 + x
+        shl  di, 1          ; word offset ES:DI *VRAM (x,y)
+        add  di, base       ; start address relative
+        // 3. copy run of cells
+        lds  si, cells      ; DS:SI *cells
+        rep  movsw          ; *ES:DI++ = *DS:SI++
+        popf                ; restore flags
+    }
+}
+
+void mda_scroll_up_186(const mda_rect_t* rect, const mda_cell_t* blank) {
+    uint16_t base = mda_vram_base;
+    __asm {
+        .186
+        // 1. register & flag setup
+        pushf
+        cld                 ; inc str ops
+        mov ax, MDA_SEGMENT
+        mov es, ax          ; ES:DI *VRAM
+        lds si, rect        ; DS:SI *rect
+        lodsb               ; AL = rect.x
+        xor ah, ah          ; AX = rect.x
+        mov bl, ds:[si]     ; BL = rect.y
+        xor bh, bh          ; BX = rect.y
+        mov cl, ds:[si+1]   ; CL = rect.w
+        xor ch, ch          ; CX = width
+        mov dl, ds:[si+2]   ; DL = rect.h
+        xor dh, dh          ; DX = height
+        // 2. DI = y * 80
+        mov  di, bx
+        shl  di, 2          ; y * 4
+        add  di, bx         ; y * 5
+        shl  di, 4          ; y * 5 * 16
+        add  di, ax         ; y*80 + x
+        shl  di, 1          ; word offset ES:DI *VRAM (x,y)
+        add  di, base       ; start address relative
+        // 3. register setup
+        mov  bx, cx         ; BX copy width
+        lds  si, blank
+        push word ptr ds:[si]   ; stack blank attrib:char
+        mov  ax, MDA_SEGMENT
+        mov  ds, ax
+        mov  si, di
+        add  si, MDA_ROW_BYTES  ; DS:SI* is now 1 line down
+        mov  ax, MDA_ROW_BYTES
+        sub  ax, cx         ; next line offset
+        sub  ax, cx         ; 160 - (2 * width)
+        // 4. move successive rows up 1
+        dec  dx             ; height -1
+        jz   LAST           ; single row: just blank it
+NEXT:   mov  cx, bx         ; restore width counter
+        rep  movsw          ; copy row cells upwards left to right
+        add  si, ax         ; next line down
+        add  di, ax
+        dec  dx
+        jnz  NEXT           ; loop until all rows moved up 1
+LAST:   pop  ax             ; AX = blank attrib:char
+        mov  cx, bx
+        rep  stosw          ; bottom blank line
+        popf                ; restore flags
+    }
+}
+
+void mda_scroll_down_186(const mda_rect_t* rect, const mda_cell_t* blank) {
+    uint16_t base = mda_vram_base;
+    __asm {
+        .186
+        // 1. register & flag setup
+        pushf
+        cld                 ; inc str ops
+        mov ax, MDA_SEGMENT
+        mov es, ax          ; ES:DI *VRAM
+        lds si, rect        ; DS:SI *rect
+        lodsb               ; AL = rect.x
+        xor ah, ah          ; AX = rect.x
+        mov bl, ds:[si]     ; BL = rect.y
+        xor bh, bh          ; BX = rect.y
+        mov cl, ds:[si+1]   ; CL = rect.w
+        xor ch, ch          ; CX = width
+        mov dl, ds:[si+2]   ; DL = rect.h
+        xor dh, dh          ; DX = height
+        add bx, dx          ; move y to bottom
+        dec bx              ; BX = rect.y + rect.h - 1
+        // 2. DI = y * 80
+        mov  di, bx
+        shl  di, 2          ; y * 4
+        add  di, bx         ; y * 5
+        shl  di, 4          ; y * 5 * 16
+        add  di, ax         ; y*80 + x
+        shl  di, 1          ; word offset ES:DI *VRAM (x,y) bottom left
+        add  di, base       ; start address relative
+        // 3. register setup
+        mov  bx, cx         ; BX copy width
+        lds  si, blank
+        push word ptr ds:[si]   ; stack blank attrib:char
+        mov  ax, MDA_SEGMENT
+        mov  ds, ax
+        mov  si, di
+        sub  si, MDA_ROW_BYTES  ; DS:SI* is now 1 line up
+        mov  ax, MDA_ROW_BYTES
+        add  ax, cx         ; previous line offset
+        add  ax, cx         ; 160 + (2 * width)
+        // 4. move successive rows down 1, bottom row first
+        dec  dx             ; height -1
+        jz   LAST           ; single row: just blank it
+NEXT:   mov  cx, bx         ; restore width counter
+        rep  movsw          ; copy row cells downwards left to right
+        sub  si, ax         ; next line up
+        sub  di, ax
+        dec  dx
+        jnz  NEXT           ; loop until all rows moved down 1
+LAST:   pop  ax             ; AX = blank attrib:char
+        mov  cx, bx
+        rep  stosw          ; top blank line
+        popf                ; restore flags
+    }
+}
+
+void mda_fill_rect_386(const mda_rect_t* rect, const mda_cell_t* cell) {
+    uint16_t base = mda_vram_base;
+    __asm {
+        .386
+        // 1. register & flag setup
+        pushf
+        cld                 ; inc str ops
+        mov ax, MDA_SEGMENT
+        mov es, ax          ; ES:DI *VRAM
+        lds si, rect        ; DS:SI *rect
+        lodsb               ; AL = rect.x
+        xor ah, ah          ; AX = rect.x
+        mov bl, ds:[si]     ; BL = rect.y
+        xor bh, bh          ; BX = rect.y
+        mov cl, ds:[si+1]   ; CL = rect.w
+        xor ch, ch          ; CX = width
+        mov dl, ds:[si+2]   ; DL = rect.h
+        xor dh, dh          ; DX = height
+        // 2. DI = y * 80
+        mov  di, bx
+        shl  di, 2          ; y * 4
+        add  di, bx         ; y * 5
+        shl  di, 4          ; y * 5 * 16
+        add  di, ax         ; y*80 + x
+        shl  di, 1          ; word offset ES:DI *VRAM (x,y)
+        add  di, base       ; start address relative
+        // 3. setup cell pair
+        lds  si, cell       ; DS:SI *cell
+        lodsw               ; AX = char:attribute pair
+        mov  bx, ax
+        shl  eax, 16
+        mov  ax, bx         ; EAX = cell:cell
+        // 4. calculate next line offset
+        mov si, MDA_ROW_BYTES   ; SI = 160
+        sub si, cx          ; SI = 160 - (width * 2)
+        sub si, cx
+        mov bx, cx          ; BX copy of width
+        // 5. draw horizontal lines two cells at a time
+NEXT:   mov cx, bx          ; restore width
+        shr cx, 1           ; CX = cell pairs, CF = odd cell
+        rep stosd           ; draw pairs (flags untouched)
+        jnc EVEN
+        stosw               ; odd cell
+EVEN:   add di, si          ; next line *VRAM + 160 - width
+        dec dx
+        jnz NEXT
+        popf                ; restore flags
+    }
+}
+
+void mda_write_cells_386(const mda_point_t* point, const mda_cell_t* cells, uint8_t count) {
+    uint16_t base = mda_vram_base;
+    __asm {
+        .386
+        // 1. register & flag setup
+        pushf
+        cld                 ; inc str ops
+        mov ax, MDA_SEGMENT
+        mov es, ax          ; ES:DI *VRAM
+        lds si, point       ; DS:SI *point
+        lodsb               ; AL = x
+        xor ah, ah          ; AX = x
+        mov bl, ds:[si]     ; BL = y
+        xor bh, bh          ; BX = y
+        mov cl, count       ; CL = count
+        xor ch, ch          ; CX = count
+        // 2. DI = y * 80
+        mov  di, bx
+        shl  di, 2          ; y * 4
+        add  di, bx         ; y * 5
+        shl  di, 4          ; y * 5 * 16
+        add  di, ax         ; y*80 + x
+        shl  di, 1          ; word offset ES:DI *VRAM (x,y)
+        add  di, base       ; start address relative
+        // 3. copy run of cells two at a time
+        lds  si, cells      ; DS:SI *cells
+        shr  cx, 1          ; CX = cell pairs, CF = odd cell
+        rep  movsd          ; *ES:DI++ = *DS:SI++ (pairs)
+        jnc  DONE
+        movsw               ; odd cell
+DONE:   popf                ; restore flags
+    }
+}
+
+void mda_fill_screen_386(const mda_cell_t* cell) {
+    uint16_t base = mda_vram_base;
+    __asm {
+        .386
+        // 1. register & flag setup
+        pushf
+        cld                 ; inc str ops
+        mov ax, MDA_SEGMENT
+        mov es, ax          ; ES:DI *VRAM
+        mov di, base        ; ES:DI *VRAM displayed (0,0)
+        lds si, cell        ; DS:SI *cell
+        lodsw               ; AX = attribut:char pair
+        mov bx, ax
+        shl eax, 16
+        mov ax, bx          ; EAX = cell:cell
+        mov cx, MDA_SCREEN_WORDS / 2
+        rep stosd           ; fill VRAM text page two cells at a time
+        popf                ; restore flags
+    }
+}
+
+void mda_scroll_up_386(const mda_rect_t* rect, const mda_cell_t* blank) {
+    uint16_t base = mda_vram_base;
+    __asm {
+        .386
+        // 1. register & flag setup
+        pushf
+        cld                 ; inc str ops
+        mov ax, MDA_SEGMENT
+        mov es, ax          ; ES:DI *VRAM
+        lds si, rect        ; DS:SI *rect
+        lodsb               ; AL = rect.x
+        xor ah, ah          ; AX = rect.x
+        mov bl, ds:[si]     ; BL = rect.y
+        xor bh, bh          ; BX = rect.y
+        mov cl, ds:[si+1]   ; CL = rect.w
+        xor ch, ch          ; CX = width
+        mov dl, ds:[si+2]   ; DL = rect.h
+        xor dh, dh          ; DX = height
+        // 2. DI = y * 80
+        mov  di, bx
+        shl  di, 2          ; y * 4
+        add  di, bx         ; y * 5
+        shl  di, 4          ; y * 5 * 16
+        add  di, ax         ; y*80 + x
+        shl  di, 1          ; word offset ES:DI *VRAM (x,y)
+        add  di, base       ; start address relative
+        // 3. register setup
+        mov  bx, cx         ; BX copy width
+        lds  si, blank
+        push word ptr ds:[si]   ; stack blank attrib:char
+        mov  ax, MDA_SEGMENT
+        mov  ds, ax
+        mov  si, di
+        add  si, MDA_ROW_BYTES  ; DS:SI* is now 1 line down
+        mov  ax, MDA_ROW_BYTES
+        sub  ax, cx         ; next line offset
+        sub  ax, cx         ; 160 - (2 * width)
+        // 4. move successive rows up 1, two cells at a time
+        dec  dx             ; height -1
+        jz   LAST           ; single row: just blank it
+NEXT:   mov  cx, bx         ; restore width counter
+        shr  cx, 1          ; CX = cell pairs, CF = odd cell
+        rep  movsd          ; copy row cells upwards left to right
+        jnc  EVEN
+        movsw               ; odd cell
+EVEN:   add  si, ax         ; next line down
+        add  di, ax
+        dec  dx
+        jnz  NEXT           ; loop until all rows moved up 1
+LAST:   pop  ax             ; AX = blank attrib:char
+        mov  dx, ax
+        shl  eax, 16
+        mov  ax, dx         ; EAX = blank:blank
+        mov  cx, bx
+        shr  cx, 1
+        rep  stosd          ; bottom blank line
+        jnc  DONE
+        stosw
+DONE:   popf                ; restore flags
+    }
+}
+
+void mda_scroll_down_386(const mda_rect_t* rect, const mda_cell_t* blank) {
+    uint16_t base = mda_vram_base;
+    __asm {
+        .386
+        // 1. register & flag setup
+        pushf
+        cld                 ; inc str ops
+        mov ax, MDA_SEGMENT
+        mov es, ax          ; ES:DI *VRAM
+        lds si, rect        ; DS:SI *rect
+        lodsb               ; AL = rect.x
+        xor ah, ah          ; AX = rect.x
+        mov bl, ds:[si]     ; BL = rect.y
+        xor bh, bh          ; BX = rect.y
+        mov cl, ds:[si+1]   ; CL = rect.w
+        xor ch, ch          ; CX = width
+        mov dl, ds:[si+2]   ; DL = rect.h
+        xor dh, dh          ; DX = height
+        add bx, dx          ; move y to bottom
+        dec bx              ; BX = rect.y + rect.h - 1
+        // 2. DI = y * 80
+        mov  di, bx
+        shl  di, 2          ; y * 4
+        add  di, bx         ; y * 5
+        shl  di, 4          ; y * 5 * 16
+        add  di, ax         ; y*80 + x
+        shl  di, 1          ; word offset ES:DI *VRAM (x,y) bottom left
+        add  di, base       ; start address relative
+        // 3. register setup
+        mov  bx, cx         ; BX copy width
+        lds  si, blank
+        push word ptr ds:[si]   ; stack blank attrib:char
+        mov  ax, MDA_SEGMENT
+        mov  ds, ax
+        mov  si, di
+        sub  si, MDA_ROW_BYTES  ; DS:SI* is now 1 line up
+        mov  ax, MDA_ROW_BYTES
+        add  ax, cx         ; previous line offset
+        add  ax, cx         ; 160 + (2 * width)
+        // 4. move successive rows down 1, bottom row first, two cells at a time
+        dec  dx             ; height -1
+        jz   LAST           ; single row: just blank it
+NEXT:   mov  cx, bx         ; restore width counter
+        shr  cx, 1          ; CX = cell pairs, CF = odd cell
+        rep  movsd          ; copy row cells downwards left to right
+        jnc  EVEN
+        movsw               ; odd cell
+EVEN:   sub  si, ax         ; next line up
+        sub  di, ax
+        dec  dx
+        jnz  NEXT           ; loop until all rows moved down 1
+LAST:   pop  ax             ; AX = blank attrib:char
+        mov  dx, ax
+        shl  eax, 16
+        mov  ax, dx         ; EAX = blank:blank
+        mov  cx, bx
+        shr  cx, 1
+        rep  stosd          ; top blank line
+        jnc  DONE
+        stosw
+DONE:   popf                ; restore flags
+    }
+}
+
+#endif
@@ -0,0 +1,77 @@
+/**
+ * @file mda_kernels.h
+ * @brief CPU-Tuned Primitive Kernels
+ * @details The bulk primitives (fills, cell runs and vertical scrolls)
+ * dispatch through the mda_kernels table. It starts out holding the 8086
+ * kernels and is switched once at startup to the fastest set the detected
+ * processor can run:
+ * - 8086:   shift-by-one addressing chains, word string ops.
+ * - 80186+: `shl reg, imm` addressing (also used on the 80286).
+ * - 80386+: as 80186, with cells moved in pairs by `rep stosd` / `rep movsd`.
+ *
+ * The build stays pinned to 8086 code generation; newer instructions only
+ * appear inside kernels selected after cpu_detect(). The host build has only
+ * the 8086 set, written in C.
+ *
+ * @author Jeremy Thornton
+ */
+#ifndef MDA_KERNELS_H
+#define MDA_KERNELS_H
+
+#include "mda_cell.h"
+#include "mda_types.h"
+#include "../CPU/cpu.h"
+
+/**
+ * @struct mda_kernels_t
+ * @brief Function table behind the dispatching primitives.
+ */
+typedef struct {
+    void (*fill_rect)(const mda_rect_t* rect, const mda_cell_t* cell);
+    void (*write_cells)(const mda_point_t* point, const mda_cell_t* cells, uint8_t count);
+    void (*fill_screen)(const mda_cell_t* cell);
+    void (*scroll_up)(const mda_rect_t* rect, const mda_cell_t* blank);
+    void (*scroll_down)(const mda_rect_t* rect, const mda_cell_t* blank);
+} mda_kernels_t;
+
+extern mda_kernels_t mda_kernels;
+
+/**
+ * @brief Install the kernel set best suited to a processor.
+ */
+void mda_install_kernels(cpu_type_t cpu);
+
+/**
+ * @defgroup kernels_8086 8086 Kernels
+ * @brief Baseline implementations in mda_primitives.c.
+ * @{
+ */
+void mda_fill_rect_8086(const mda_rect_t* rect, const mda_cell_t* cell);
+void mda_write_cells_8086(const mda_point_t* point, const mda_cell_t* cells, uint8_t count);
+void mda_fill_screen_8086(const mda_cell_t* cell);
+void mda_scroll_up_8086(const mda_rect_t* rect, const mda_cell_t* blank);
+void mda_scroll_down_8086(const mda_rect_t* rect, const mda_cell_t* blank);
+///@}
+
+/**
+ * @defgroup kernels_186 80186 Kernels
+ * @{
+ */
+void mda_fill_rect_186(const mda_rect_t* rect, const mda_cell_t* cell);
+void mda_write_cells_186(const mda_point_t* point, const mda_cell_t* cells, uint8_t count);
+void mda_scroll_up_186(const mda_rect_t* rect, const mda_cell_t* blank);
+void mda_scroll_down_186(const mda_rect_t* rect, const mda_cell_t* blank);
+///@}
+
+/**
+ * @defgroup kernels_386 80386 Kernels
+ * @{
+ */
+void mda_fill_rect_386(const mda_rect_t* rect, const mda_cell_t* cell);
+void mda_write_cells_386(const mda_point_t* point, const mda_cell_t* cells, uint8_t count);
+void mda_fill_screen_386(const mda_cell_t* cell);
+void mda_scroll_up_386(const mda_rect_t* rect, const mda_cell_t* blank);
+void mda_scroll_down_386(const mda_rect_t* rect, const mda_cell_t* blank);
+///@}
+
+#endif /* MDA_KERNELS_H */
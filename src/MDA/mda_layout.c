@@ -0,0 +1,210 @@
+/**
+ * @file mda_layout.c
+ * @brief Implementation of the Word-Wrap and Alignment Layout Engine
+ * @details Breaking scans at most one line width ahead of the current
+ * position, remembering the last space, so each byte is visited at most
+ * twice however long the text is.
+ * @author Jeremy Thornton
+ */
+#include "mda_layout.h"
+#include "mda_constants.h"
+#include "mda_primitives.h"
+#include "../CONTRACT/contract.h"
+
+#define LAYOUT_CLEAN    0xFFFF  // dirty value: nothing to redraw
+
+/**
+ * @brief Skip spaces and at most one '\n' after a soft break.
+ * @return Position of the next line; *last set if a '\n' was consumed.
+ */
+static uint16_t layout_skip(const mda_layout_t* layout, uint16_t pos, bool* last) {
+    while (pos < layout->length && layout->text[pos] == ' ') {
+        pos++;
+    }
+    if (pos < layout->length && layout->text[pos] == '\n') {
+        *last = true;
+        pos++;
+    }
+    return pos;
+}
+
+/**
+ * @brief Break the text greedily from pos, filling the table from line index on.
+ */
+static void layout_break(mda_layout_t* layout, uint16_t index, uint16_t pos) {
+    const char* text = layout->text;
+    uint16_t end = layout->length;
+    uint8_t width = layout->rect.w;
+    while (pos < end && index < layout->capacity) {
+        mda_layout_line_t* line = &layout->lines[index++];
+        uint16_t limit = (end - pos > width) ? pos + width : end;
+        uint16_t space = pos;
+        uint16_t next = limit;
+        uint16_t i;
+        line->start = pos;
+        line->last = false;
+        for (i = pos; i < limit && text[i] != '\n'; ++i) {
+            if (text[i] == ' ') {
+                space = i;
+            }
+        }
+        if (i < limit) {                            // hard break
+            line->length = (uint8_t)(i - pos);
+            line->last = true;
+            next = i + 1;
+        }
+        else if (limit == end) {                    // the rest fits
+            line->length = (uint8_t)(end - pos);
+            line->last = true;
+        }
+        else if (text[limit] == ' ' || text[limit] == '\n') {  // the break falls exactly at the edge
+            line->length = width;
+            next = layout_skip(layout, limit, &line->last);
+        }
+        else if (space > pos) {                     // break at the last space
+            line->length = (uint8_t)(space - pos);
+            next = layout_skip(layout, space, &line->last);
+        }
+        else {                                      // split an overlong word
+            line->length = width;
+        }
+        while (line->length > 0 && text[pos + line->length - 1] == ' ') {
+            line->length--;
+        }
+        pos = next;
+    }
+    layout->count = index;
+    layout->overflow = pos < end;
+}
+
+/**
+ * @brief Compose line into row (w cells, already blank), aligned.
+ * @param cut End the line in "..." as more text follows.
+ */
+static void layout_compose(const mda_layout_t* layout, const mda_layout_line_t* line, bool cut, mda_cell_t* row) {
+    const char* chars = layout->text + line->start;
+    uint8_t width = layout->rect.w;
+    uint8_t length = line->length;
+    uint16_t attr = layout->blank.packed & 0xFF00;
+    mda_align_t align = layout->align;
+    if (cut && width > 3) {
+        if (length > width - 3) {
+            length = width - 3;
+        }
+        for (uint8_t i = 0; i < 3; ++i) {
+            row[length + i].packed = attr | '.';
+        }
+        align = MDA_ALIGN_LEFT;
+    }
+    uint8_t gaps = 0;
+    uint8_t offset = 0;
+    switch (align) {
+        case MDA_ALIGN_CENTER:
+            offset = (width - length) >> 1;
+            break;
+        case MDA_ALIGN_RIGHT:
+            offset = width - length;
+            break;
+        case MDA_ALIGN_JUSTIFY:
+            for (uint8_t i = 0; i < length && !line->last; ++i) {
+                gaps += (chars[i] == ' ');
+            }
+            break;
+        default:
+            break;
+    }
+    row += offset;
+    if (gaps == 0) {
+        for (uint8_t i = 0; i < length; ++i) {
+            (row++)->packed = attr | (uint8_t)chars[i];
+        }
+        return;
+    }
+    uint8_t extra = width - length;    // spread over the gaps, the first ones take the remainder
+    uint8_t spread = extra / gaps;
+    uint8_t wider = extra % gaps;
+    for (uint8_t i = 0; i < length; ++i) {
+        (row++)->packed = attr | (uint8_t)chars[i];
+        if (chars[i] == ' ') {
+            row += spread + (wider > 0);
+            if (wider > 0) {
+                wider--;
+            }
+        }
+    }
+}
+
+void mda_layout_init(mda_layout_t* layout, const mda_rect_t* rect, mda_align_t align, const mda_cell_t* blank,
+                     mda_layout_line_t* lines, uint16_t capacity) {
+    require_address(layout, "NULL layout!");
+    require_address(rect, "NULL rect!");
+    require_address(blank, "NULL blank!");
+    require_address(lines, "NULL lines!");
+    require(rect->w > 0 && rect->w <= MDA_COLUMNS, "INVALID layout width!");
+    layout->text = "";
+    layout->length = 0;
+    layout->rect = *rect;
+    layout->align = align;
+    layout->blank = *blank;
+    layout->ellipsis = true;
+    layout->lines = lines;
+    layout->capacity = capacity;
+    layout->count = 0;
+    layout->overflow = false;
+    layout->top = 0;
+    layout->dirty = 0;
+}
+
+void mda_layout_set_text(mda_layout_t* layout, const char* text, uint16_t length) {
+    require_address(layout, "NULL layout!");
+    require_address(text, "NULL text!");
+    layout->text = text;
+    layout->length = length;
+    layout->top = 0;
+    layout->dirty = 0;
+    layout_break(layout, 0, 0);
+}
+
+void mda_layout_edit(mda_layout_t* layout, const char* text, uint16_t length, uint16_t at) {
+    require_address(layout, "NULL layout!");
+    require_address(text, "NULL text!");
+    uint16_t i = 0;
+    while (i + 1 < layout->count && layout->lines[i + 1].start <= at) {
+        i++;
+    }
+    while (i > 0 && !layout->lines[i - 1].last) {   // back to the paragraph start
+        i--;
+    }
+    uint16_t pos = (i < layout->count) ? layout->lines[i].start : 0;
+    layout->text = text;
+    layout->length = length;
+    layout_break(layout, i, (pos < length) ? pos : length);
+    if (i < layout->dirty) {
+        layout->dirty = i;
+    }
+}
+
+void mda_layout_scroll_to(mda_layout_t* layout, uint16_t top) {
+    require_address(layout, "NULL layout!");
+    layout->top = top;
+    layout->dirty = top;
+}
+
+void mda_layout_draw(mda_layout_t* layout) {
+    require_address(layout, "NULL layout!");
+    mda_cell_t row[MDA_COLUMNS];
+    uint16_t first = (layout->dirty > layout->top) ? layout->dirty : layout->top;
+    for (uint16_t li = first; li < layout->top + layout->rect.h; ++li) {
+        for (uint8_t x = 0; x < layout->rect.w; ++x) {
+            row[x] = layout->blank;
+        }
+        if (li < layout->count) {
+            bool cut = layout->ellipsis && li + 1 == layout->top + layout->rect.h
+                       && (li + 1 < layout->count || layout->overflow);
+            layout_compose(layout, &layout->lines[li], cut, row);
+        }
+        mda_point_t p = mda_point_make(layout->rect.x, layout->rect.y + (uint8_t)(li - layout->top));
+        mda_write_cells(&p, row, layout->rect.w);
+    }
+    layout->dirty = LAYOUT_CLEAN;
+}
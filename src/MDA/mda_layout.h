@@ -0,0 +1,100 @@
+/**
+ * @file mda_layout.h
+ * @brief Word-Wrap and Alignment Layout Engine
+ * @details Lays a block of text out in a rectangle. One linear pass
+ * computes greedy word-wrap breaks into a caller supplied line table;
+ * paragraphs are separated by '\n' and words longer than the width are
+ * split. Drawing composes each row in a cell buffer — aligned left,
+ * centred, right or justified (the last line of a paragraph is left
+ * aligned) — and commits it with one mda_write_cells().
+ *
+ * When the text has more lines than the rectangle shows, the last visible
+ * row can end in "..." to mark the truncation.
+ *
+ * Editing is incremental: mda_layout_edit() re-breaks only from the start
+ * of the edited paragraph onward, since earlier lines cannot change, and
+ * mda_layout_draw() redraws only the rows from there down.
+ *
+ * @note The text is referenced, not copied, and must outlive the layout.
+ * @author Jeremy Thornton
+ */
+#ifndef MDA_LAYOUT_H
+#define MDA_LAYOUT_H
+
+#include "mda_cell.h"
+#include "mda_types.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * @enum mda_align_t
+ * @brief Horizontal alignment of each line.
+ */
+typedef enum {
+    MDA_ALIGN_LEFT = 0,
+    MDA_ALIGN_CENTER,
+    MDA_ALIGN_RIGHT,
+    MDA_ALIGN_JUSTIFY       /**< Stretch gaps to fill the width */
+} mda_align_t;
+
+/**
+ * @struct mda_layout_line_t
+ * @brief One wrapped line: a byte range of the text.
+ */
+typedef struct {
+    uint16_t start;     /**< First byte */
+    uint8_t length;     /**< Bytes shown (trailing spaces trimmed) */
+    bool last;          /**< Ends a paragraph (never justified) */
+} mda_layout_line_t;
+
+/**
+ * @struct mda_layout_t
+ * @brief Text, geometry, style and line table of one text block.
+ */
+typedef struct {
+    const char* text;           /**< Text laid out (not owned) */
+    uint16_t length;            /**< Bytes of text */
+    mda_rect_t rect;            /**< Screen area */
+    mda_align_t align;          /**< Line alignment */
+    mda_cell_t blank;           /**< Background; its attribute is used for the text */
+    bool ellipsis;              /**< End the last visible row in "..." when text is cut off */
+    mda_layout_line_t* lines;   /**< Caller supplied line table */
+    uint16_t capacity;          /**< Lines that fit in the table */
+    uint16_t count;             /**< Lines laid out */
+    bool overflow;              /**< The table filled up before the text ended */
+    uint16_t top;               /**< First line shown */
+    uint16_t dirty;             /**< First line needing a redraw */
+} mda_layout_t;
+
+/**
+ * @brief Initialize an empty layout.
+ * @param lines    Line table storage.
+ * @param capacity Lines in the table; text beyond it is cut off.
+ */
+void mda_layout_init(mda_layout_t* layout, const mda_rect_t* rect, mda_align_t align, const mda_cell_t* blank,
+                     mda_layout_line_t* lines, uint16_t capacity);
+
+/**
+ * @brief Lay out new text from scratch.
+ */
+void mda_layout_set_text(mda_layout_t* layout, const char* text, uint16_t length);
+
+/**
+ * @brief Text was edited at byte at: re-break from that paragraph onward.
+ * @param text   Edited text (may have moved).
+ * @param length New length.
+ * @param at     First byte that changed.
+ */
+void mda_layout_edit(mda_layout_t* layout, const char* text, uint16_t length, uint16_t at);
+
+/**
+ * @brief Show lines from top on; everything is redrawn.
+ */
+void mda_layout_scroll_to(mda_layout_t* layout, uint16_t top);
+
+/**
+ * @brief Redraw the rows from the first dirty line down.
+ */
+void mda_layout_draw(mda_layout_t* layout);
+
+#endif /* MDA_LAYOUT_H */
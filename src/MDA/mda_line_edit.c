@@ -0,0 +1,297 @@
+/**
+ * @file mda_line_edit.c
+ * @brief Implementation of the Single-Line Input Editor
+ * @details Every change to the text goes through line_splice(), which
+ * reports the first byte it changed; line_sync() then scrolls the field if
+ * the cursor left it and redraws from that byte (or from the field start
+ * after a scroll) to the field end.
+ * @author Jeremy Thornton
+ */
+#include "mda_line_edit.h"
+#include "mda_constants.h"
+#include "mda_crtc.h"
+#include "mda_primitives.h"
+#include "../BIOS/bios_keyboard_constants.h"
+#include "../CONTRACT/contract.h"
+#include <string.h>
+
+#define LINE_CLEAN              0xFF    // dirty value: nothing to redraw
+#define LINE_CURSOR_INSERT      0x0B    // cursor start scan line: underline
+#define LINE_CURSOR_OVERWRITE   0x06    // cursor start scan line: half block
+#define LINE_CURSOR_END         0x0C    // cursor end scan line
+
+/**
+ * @brief Scroll the field to show the cursor, redraw from byte dirty on and place the cursor.
+ */
+static void line_sync(mda_line_edit_t* le, uint8_t dirty) {
+    uint8_t half = le->width >> 1;
+    uint8_t left = le->left;
+    if (le->cursor < left) {
+        left = (le->cursor > half) ? le->cursor - half : 0;
+    }
+    else if (le->cursor >= left + le->width) {
+        left = le->cursor - le->width + half + 1;
+    }
+    if (left != le->left) {
+        le->left = left;
+        dirty = left;
+    }
+    if (dirty < left) {
+        dirty = left;
+    }
+    if (dirty != LINE_CLEAN && dirty < left + le->width) {
+        mda_cell_t row[MDA_COLUMNS];
+        uint16_t attr = le->blank.packed & 0xFF00;
+        uint8_t n = left + le->width - dirty;
+        for (uint8_t i = 0; i < n; ++i) {
+            uint8_t at = dirty + i;
+            row[i].packed = (at < le->length) ? attr | (uint8_t)le->text[at] : le->blank.packed;
+        }
+        mda_point_t p = mda_point_make(le->origin.x + (dirty - left), le->origin.y);
+        mda_write_cells(&p, row, n);
+    }
+    mda_crtc_set_cursor(le->origin.x + (le->cursor - left), le->origin.y);
+}
+
+/**
+ * @brief Replace remove bytes at at with n bytes of chars, cursor after them.
+ * @return false if the result does not fit.
+ */
+static bool line_splice(mda_line_edit_t* le, uint8_t at, uint8_t remove, const char* chars, uint8_t n) {
+    if (le->length - remove + n >= MDA_LINE_MAX) {
+        return false;
+    }
+    le->cursor = at + n;
+    while (n > 0 && remove > 0 && le->text[at] == *chars) {   // an unchanged lead needs no redraw
+        at++;
+        chars++;
+        n--;
+        remove--;
+    }
+    memmove(le->text + at + n, le->text + at + remove, le->length - at - remove + 1);
+    memcpy(le->text + at, chars, n);
+    le->length = le->length - remove + n;
+    line_sync(le, at);
+    return true;
+}
+
+/**
+ * @brief Replace the whole text with line, cursor at the end.
+ */
+static void line_replace(mda_line_edit_t* le, const char* line) {
+    size_t n = strlen(line);
+    if (n >= MDA_LINE_MAX) {
+        n = MDA_LINE_MAX - 1;
+    }
+    line_splice(le, 0, le->length, line, (uint8_t)n);
+}
+
+/**
+ * @brief Step through the history: older if up, newer otherwise.
+ */
+static void line_recall(mda_line_edit_t* le, bool up) {
+    if (le->history == NULL) {
+        return;
+    }
+    if (up) {
+        uint8_t age = (le->recall == MDA_LINE_LIVE) ? 0 : le->recall + 1;
+        const char* entry = mda_line_history_get(le->history, age);
+        if (entry == NULL) {
+            return;
+        }
+        if (le->recall == MDA_LINE_LIVE) {
+            memcpy(le->draft, le->text, le->length + 1);
+        }
+        le->recall = age;
+        line_replace(le, entry);
+    }
+    else if (le->recall == 0) {
+        le->recall = MDA_LINE_LIVE;
+        line_replace(le, le->draft);
+    }
+    else if (le->recall != MDA_LINE_LIVE) {
+        le->recall--;
+        line_replace(le, mda_line_history_get(le->history, le->recall));
+    }
+}
+
+/**
+ * @brief Complete the word before the cursor, or cycle to the next candidate.
+ */
+static void line_complete(mda_line_edit_t* le) {
+    if (le->complete == NULL) {
+        return;
+    }
+    uint8_t index = le->candidate;
+    if (index == 0) {                               // first Tab: the word becomes the stem
+        le->word = le->cursor;
+        while (le->word > 0 && le->text[le->word - 1] != ' ') {
+            le->word--;
+        }
+        le->stem_length = le->cursor - le->word;
+        if (le->stem_length >= MDA_LINE_WORD) {
+            return;
+        }
+        memcpy(le->stem, le->text + le->word, le->stem_length);
+    }
+    const char* match = le->complete(le->stem, le->stem_length, index, le->user);
+    if (match == NULL && index > 0) {               // candidates exhausted: start over
+        index = 0;
+        match = le->complete(le->stem, le->stem_length, 0, le->user);
+    }
+    if (match == NULL) {
+        le->candidate = 0;
+        return;
+    }
+    size_t n = strlen(match);
+    if (n < MDA_LINE_MAX && line_splice(le, le->word, le->cursor - le->word, match, (uint8_t)n)) {
+        le->candidate = index + 1;
+    }
+}
+
+void mda_line_history_init(mda_line_history_t* history) {
+    require_address(history, "NULL history!");
+    history->head = 0;
+    history->count = 0;
+}
+
+void mda_line_history_push(mda_line_history_t* history, const char* line) {
+    require_address(history, "NULL history!");
+    require_address(line, "NULL line!");
+    const char* newest = mda_line_history_get(history, 0);
+    if (*line == '\0' || (newest != NULL && strcmp(newest, line) == 0)) {
+        return;
+    }
+    char* entry = history->entries[history->head];
+    strncpy(entry, line, MDA_LINE_MAX - 1);
+    entry[MDA_LINE_MAX - 1] = '\0';
+    history->head = (history->head + 1) % MDA_LINE_HISTORY;
+    if (history->count < MDA_LINE_HISTORY) {
+        history->count++;
+    }
+}
+
+const char* mda_line_history_get(const mda_line_history_t* history, uint8_t age) {
+    require_address(history, "NULL history!");
+    if (age >= history->count) {
+        return NULL;
+    }
+    return history->entries[(history->head + MDA_LINE_HISTORY - 1 - age) % MDA_LINE_HISTORY];
+}
+
+void mda_line_edit_init(mda_line_edit_t* le, const mda_point_t* origin, uint8_t width, const mda_cell_t* blank,
+                        mda_line_history_t* history, mda_line_complete_t complete, void* user) {
+    require_address(le, "NULL line editor!");
+    require_address(origin, "NULL origin!");
+    require_address(blank, "NULL blank!");
+    require(width > 0 && origin->x + width <= MDA_COLUMNS, "INVALID field width!");
+    le->origin = *origin;
+    le->width = width;
+    le->blank = *blank;
+    le->text[0] = '\0';
+    le->length = 0;
+    le->cursor = 0;
+    le->left = 0;
+    le->overwrite = false;
+    le->history = history;
+    le->recall = MDA_LINE_LIVE;
+    le->draft[0] = '\0';
+    le->complete = complete;
+    le->user = user;
+    le->word = 0;
+    le->stem_length = 0;
+    le->candidate = 0;
+}
+
+void mda_line_edit_set_text(mda_line_edit_t* le, const char* text) {
+    require_address(le, "NULL line editor!");
+    require_address(text, "NULL text!");
+    size_t n = strlen(text);
+    if (n >= MDA_LINE_MAX) {
+        n = MDA_LINE_MAX - 1;
+    }
+    memcpy(le->text, text, n);
+    le->text[n] = '\0';
+    le->length = le->cursor = (uint8_t)n;
+    le->left = 0;
+    le->recall = MDA_LINE_LIVE;
+    le->candidate = 0;
+    line_sync(le, 0);
+}
+
+mda_line_status_t mda_line_edit_key(mda_line_edit_t* le, uint16_t key) {
+    require_address(le, "NULL line editor!");
+    uint8_t scan = BIOS_KEY_SCAN(key);
+    if (scan != BIOS_SCAN_TAB) {
+        le->candidate = 0;
+    }
+    switch (scan) {
+        case BIOS_SCAN_LEFT:
+            if (le->cursor > 0) {
+                le->cursor--;
+            }
+            line_sync(le, LINE_CLEAN);
+            return MDA_LINE_EDITING;
+        case BIOS_SCAN_RIGHT:
+            if (le->cursor < le->length) {
+                le->cursor++;
+            }
+            line_sync(le, LINE_CLEAN);
+            return MDA_LINE_EDITING;
+        case BIOS_SCAN_HOME:
+            le->cursor = 0;
+            line_sync(le, LINE_CLEAN);
+            return MDA_LINE_EDITING;
+        case BIOS_SCAN_END:
+            le->cursor = le->length;
+            line_sync(le, LINE_CLEAN);
+            return MDA_LINE_EDITING;
+        case BIOS_SCAN_BACKSPACE:
+            if (le->cursor > 0) {
+                line_splice(le, le->cursor - 1, 1, "", 0);
+            }
+            return MDA_LINE_EDITING;
+        case BIOS_SCAN_DEL:
+            if (le->cursor < le->length) {
+                line_splice(le, le->cursor, 1, "", 0);
+            }
+            return MDA_LINE_EDITING;
+        case BIOS_SCAN_INS:
+            le->overwrite = !le->overwrite;
+            mda_crtc_write(MDA_CRTC_CURSOR_START, le->overwrite ? LINE_CURSOR_OVERWRITE : LINE_CURSOR_INSERT);
+            mda_crtc_write(MDA_CRTC_CURSOR_END, LINE_CURSOR_END);
+            return MDA_LINE_EDITING;
+        case BIOS_SCAN_UP:
+            line_recall(le, true);
+            return MDA_LINE_EDITING;
+        case BIOS_SCAN_DOWN:
+            line_recall(le, false);
+            return MDA_LINE_EDITING;
+        case BIOS_SCAN_TAB:
+            line_complete(le);
+            return MDA_LINE_EDITING;
+        case BIOS_SCAN_ENTER:
+            if (le->history != NULL) {
+                mda_line_history_push(le->history, le->text);
+            }
+            le->recall = MDA_LINE_LIVE;
+            return MDA_LINE_DONE;
+        case BIOS_SCAN_ESC:
+            le->recall = MDA_LINE_LIVE;
+            return MDA_LINE_CANCEL;
+        default:
+            break;
+    }
+    char chr = (char)BIOS_KEY_ASCII(key);
+    if ((uint8_t)chr < ' ' || chr == 0x7F) {
+        return MDA_LINE_IGNORED;
+    }
+    bool replace = le->overwrite && le->cursor < le->length;
+    line_splice(le, le->cursor, replace, &chr, 1);
+    return MDA_LINE_EDITING;
+}
+
+void mda_line_edit_draw(mda_line_edit_t* le) {
+    require_address(le, "NULL line editor!");
+    line_sync(le, 0);
+}
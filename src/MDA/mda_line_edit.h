@@ -0,0 +1,130 @@
+/**
+ * @file mda_line_edit.h
+ * @brief Single-Line Input Editor with History and Completion
+ * @details A command line editor drawn straight into video memory, for
+ * input longer than the field that holds it. The field is one row of a
+ * rectangle; text wider than the field scrolls horizontally inside it.
+ *
+ * Each keystroke redraws only the changed suffix of the field — from the
+ * first changed character to the field end, with one mda_write_cells() —
+ * and then moves the hardware cursor once. Moving the cursor redraws
+ * nothing unless the field has to scroll, in which case it jumps by half a
+ * field so that scrolling repaints are rare while typing.
+ *
+ * Keys:
+ * - Left, Right, Home, End move; Backspace and Del delete;
+ * - Ins toggles insert and overwrite (the cursor grows to a half block);
+ * - Up and Down recall older and newer lines from the history ring, the
+ *   line being typed is kept and comes back below the newest entry;
+ * - Tab asks the completion callback to complete the word before the
+ *   cursor; pressing Tab again cycles through further candidates.
+ *
+ * @author Jeremy Thornton
+ */
+#ifndef MDA_LINE_EDIT_H
+#define MDA_LINE_EDIT_H
+
+#include "mda_cell.h"
+#include "mda_types.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+#define MDA_LINE_MAX            128     /**< Bytes of a line including the terminating NUL */
+#define MDA_LINE_HISTORY        16      /**< Lines kept in a history ring */
+#define MDA_LINE_WORD           32      /**< Longest word offered for completion */
+#define MDA_LINE_LIVE           0xFF    /**< recall value: editing the live line, not a history entry */
+
+/**
+ * @enum mda_line_status_t
+ * @brief Result of one keystroke.
+ */
+typedef enum {
+    MDA_LINE_EDITING = 0,   /**< Keep reading keys */
+    MDA_LINE_DONE,          /**< Enter: the line is complete and was added to the history */
+    MDA_LINE_CANCEL,        /**< Esc: input abandoned */
+    MDA_LINE_IGNORED        /**< Not an editing key, passed back to the caller */
+} mda_line_status_t;
+
+/**
+ * @struct mda_line_history_t
+ * @brief Ring of the most recent completed lines, shareable between editors.
+ */
+typedef struct {
+    char entries[MDA_LINE_HISTORY][MDA_LINE_MAX];
+    uint8_t head;           /**< Slot of the next entry */
+    uint8_t count;          /**< Entries held */
+} mda_line_history_t;
+
+/**
+ * @brief Completion callback.
+ * @param word   Start of the word before the cursor (not NUL terminated).
+ * @param length Bytes in word.
+ * @param index  0 for the first Tab, incremented by each further Tab.
+ * @param user   Caller context given to mda_line_edit_init().
+ * @return Full replacement for the word, or NULL when there are no more candidates.
+ */
+typedef const char* (*mda_line_complete_t)(const char* word, uint8_t length, uint8_t index, void* user);
+
+/**
+ * @struct mda_line_edit_t
+ * @brief Text, cursor, field and recall state of one line editor.
+ */
+typedef struct {
+    mda_point_t origin;             /**< Left end of the field */
+    uint8_t width;                  /**< Cells in the field */
+    mda_cell_t blank;               /**< Background; its attribute is used for the text */
+    char text[MDA_LINE_MAX];        /**< Line being edited, NUL terminated */
+    uint8_t length;                 /**< Bytes of text */
+    uint8_t cursor;                 /**< Insertion point */
+    uint8_t left;                   /**< First byte shown in the field */
+    bool overwrite;                 /**< Typing replaces instead of inserting */
+    mda_line_history_t* history;    /**< Optional history ring */
+    uint8_t recall;                 /**< Age of the history entry shown, or MDA_LINE_LIVE */
+    char draft[MDA_LINE_MAX];       /**< Live line parked while browsing the history */
+    mda_line_complete_t complete;   /**< Optional completion callback */
+    void* user;                     /**< Passed to complete */
+    uint8_t word;                   /**< Start of the word being completed */
+    char stem[MDA_LINE_WORD];       /**< The word as typed before the first Tab */
+    uint8_t stem_length;            /**< Bytes in stem */
+    uint8_t candidate;              /**< Index of the next candidate, 0 when not completing */
+} mda_line_edit_t;
+
+/**
+ * @brief Empty a history ring.
+ */
+void mda_line_history_init(mda_line_history_t* history);
+
+/**
+ * @brief Add a line as the newest entry; empty lines and repeats of the newest are skipped.
+ */
+void mda_line_history_push(mda_line_history_t* history, const char* line);
+
+/**
+ * @brief Entry age lines back (0 = newest), or NULL past the oldest.
+ */
+const char* mda_line_history_get(const mda_line_history_t* history, uint8_t age);
+
+/**
+ * @brief Initialize an empty editor over a field of width cells at origin.
+ * @param history  History ring, or NULL for none.
+ * @param complete Completion callback, or NULL for none.
+ */
+void mda_line_edit_init(mda_line_edit_t* le, const mda_point_t* origin, uint8_t width, const mda_cell_t* blank,
+                        mda_line_history_t* history, mda_line_complete_t complete, void* user);
+
+/**
+ * @brief Replace the text, put the cursor at its end and redraw the field.
+ */
+void mda_line_edit_set_text(mda_line_edit_t* le, const char* text);
+
+/**
+ * @brief Handle one BIOS keystroke (scan code : ASCII).
+ */
+mda_line_status_t mda_line_edit_key(mda_line_edit_t* le, uint16_t key);
+
+/**
+ * @brief Repaint the whole field and place the hardware cursor.
+ */
+void mda_line_edit_draw(mda_line_edit_t* le);
+
+#endif /* MDA_LINE_EDIT_H */
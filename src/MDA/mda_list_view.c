@@ -0,0 +1,179 @@
+/**
+ * @file mda_list_view.c
+ * @brief Implementation of the Virtualized List View Widget
+ * @details Rows are rendered once into the cache with the normal attribute
+ * and committed to VRAM with mda_write_cells(). The selection highlight is
+ * applied afterwards with mda_write_attr(), so the cached cells never carry
+ * selection state and moving the selection only touches attribute bytes.
+ * @author Jeremy Thornton
+ */
+#include "mda_list_view.h"
+#include "mda_primitives.h"
+#include "../CONTRACT/contract.h"
+
+/**
+ * @brief Fetch the rendered cells for a record, asking the provider on a cache miss.
+ */
+static mda_cell_t* list_row(mda_list_view_t* view, uint32_t index) {
+    uint8_t slot = (uint8_t)(index & (MDA_LIST_CACHE_ROWS - 1));
+    mda_cell_t* cells = view->rows[slot];
+    if (view->tags[slot] != index) {
+        char text[MDA_COLUMNS + 1];
+        uint8_t i;
+        text[0] = '\0';
+        view->provider(index, text, view->bounds.w, view->user);
+        for (i = 0; i < view->bounds.w && text[i] != '\0'; ++i) {
+            cells[i].chr = text[i];
+            cells[i].attr = view->normal;
+        }
+        for (; i < view->bounds.w; ++i) {   // pad to full width
+            cells[i] = view->blank;
+        }
+        view->tags[slot] = index;
+    }
+    return cells;
+}
+
+/**
+ * @brief Render viewport row r (0 = top) from the cache.
+ */
+static void list_draw_row(mda_list_view_t* view, uint8_t r) {
+    mda_point_t p = mda_point_make(view->bounds.x, view->bounds.y + r);
+    uint32_t index = view->top + r;
+    if (index < view->count) {
+        mda_write_cells(&p, list_row(view, index), view->bounds.w);
+        if (index == view->selected) {
+            mda_write_attr(&p, view->highlight, view->bounds.w);
+        }
+    }
+    else {  // past the last record
+        mda_point_t p1 = mda_point_make(p.x + view->bounds.w - 1, p.y);
+        mda_draw_hline(&p, &p1, &view->blank);
+    }
+}
+
+/**
+ * @brief Rewrite the attribute of a record's row, if it is visible.
+ */
+static void list_set_attr(mda_list_view_t* view, uint32_t index, uint8_t attr) {
+    if (index >= view->top && index < view->top + view->bounds.h) {
+        mda_point_t p = mda_point_make(view->bounds.x, view->bounds.y + (uint8_t)(index - view->top));
+        mda_write_attr(&p, attr, view->bounds.w);
+    }
+}
+
+void mda_list_view_init(mda_list_view_t* view, const mda_rect_t* bounds, uint32_t count,
+                        mda_list_row_provider_t provider, void* user) {
+    require_address(view, "NULL list view!");
+    require_address(bounds, "NULL bounds!");
+    require_address(provider, "NULL row provider!");
+    require(bounds->w > 0 && bounds->w <= MDA_COLUMNS, "INVALID list view width!");
+    require(bounds->h > 0, "INVALID list view height!");
+    view->bounds = *bounds;
+    view->count = count;
+    view->top = 0;
+    view->selected = 0;
+    view->normal = MDA_NORMAL;
+    view->highlight = MDA_REVERSE;
+    view->blank = mda_cell_make(' ', MDA_NORMAL);
+    view->provider = provider;
+    view->user = user;
+    mda_list_view_invalidate(view);
+}
+
+void mda_list_view_invalidate(mda_list_view_t* view) {
+    require_address(view, "NULL list view!");
+    for (uint8_t i = 0; i < MDA_LIST_CACHE_ROWS; ++i) {
+        view->tags[i] = MDA_LIST_NO_ROW;
+    }
+}
+
+void mda_list_view_draw(mda_list_view_t* view) {
+    require_address(view, "NULL list view!");
+    for (uint8_t r = 0; r < view->bounds.h; ++r) {
+        list_draw_row(view, r);
+    }
+}
+
+void mda_list_view_select(mda_list_view_t* view, uint32_t index) {
+    require_address(view, "NULL list view!");
+    uint8_t h = view->bounds.h;
+    uint32_t old = view->selected;
+    if (view->count == 0) {
+        return;
+    }
+    if (index >= view->count) {
+        index = view->count - 1;
+    }
+    if (index == old) {
+        return;
+    }
+    view->selected = index;
+    if (index >= view->top && index < view->top + h) {  // within viewport: two attribute runs
+        list_set_attr(view, old, view->normal);
+        list_set_attr(view, index, view->highlight);
+    }
+    else if (h > 1 && index == view->top + h) {        // one past the bottom: scroll up a line
+        list_set_attr(view, old, view->normal);
+        mda_scroll_up(&view->bounds, &view->blank);
+        view->top++;
+        list_draw_row(view, h - 1);
+    }
+    else if (h > 1 && index + 1 == view->top) {        // one above the top: scroll down a line
+        list_set_attr(view, old, view->normal);
+        mda_scroll_down(&view->bounds, &view->blank);
+        view->top--;
+        list_draw_row(view, 0);
+    }
+    else {                                              // jump: reposition and redraw
+        view->top = (index < view->top) ? index : index - h + 1;
+        mda_list_view_draw(view);
+    }
+}
+
+void mda_list_view_set_count(mda_list_view_t* view, uint32_t count) {
+    require_address(view, "NULL list view!");
+    view->count = count;
+    if (view->selected >= count) {
+        view->selected = (count > 0) ? count - 1 : 0;
+    }
+    if (view->top > view->selected) {
+        view->top = view->selected;
+    }
+    mda_list_view_draw(view);
+}
+
+void mda_list_view_up(mda_list_view_t* view) {
+    require_address(view, "NULL list view!");
+    if (view->selected > 0) {
+        mda_list_view_select(view, view->selected - 1);
+    }
+}
+
+void mda_list_view_down(mda_list_view_t* view) {
+    require_address(view, "NULL list view!");
+    mda_list_view_select(view, view->selected + 1);
+}
+
+void mda_list_view_page_up(mda_list_view_t* view) {
+    require_address(view, "NULL list view!");
+    uint8_t h = view->bounds.h;
+    mda_list_view_select(view, (view->selected > h) ? view->selected - h : 0);
+}
+
+void mda_list_view_page_down(mda_list_view_t* view) {
+    require_address(view, "NULL list view!");
+    mda_list_view_select(view, view->selected + view->bounds.h);
+}
+
+void mda_list_view_home(mda_list_view_t* view) {
+    require_address(view, "NULL list view!");
+    mda_list_view_select(view, 0);
+}
+
+void mda_list_view_end(mda_list_view_t* view) {
+    require_address(view, "NULL list view!");
+    if (view->count > 0) {
+        mda_list_view_select(view, view->count - 1);
+    }
+}
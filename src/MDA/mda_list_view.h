@@ -0,0 +1,100 @@
+/**
+ * @file mda_list_view.h
+ * @brief Virtualized List View Widget
+ * @details Displays an arbitrarily long list of records inside a rectangle
+ * by asking a row-provider callback for visible rows only. Rendered rows are
+ * kept in a small direct-mapped cache so that scrolling back and forth does
+ * not re-query the provider.
+ *
+ * Moving the selection by one row either swaps the highlight attribute on
+ * two rows, or scrolls the viewport by one line with mda_scroll_up() /
+ * mda_scroll_down() and renders just the newly exposed row.
+ *
+ * @author Jeremy Thornton
+ */
+#ifndef MDA_LIST_VIEW_H
+#define MDA_LIST_VIEW_H
+
+#include "mda_constants.h"
+#include "mda_types.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+#define MDA_LIST_CACHE_ROWS     32          /**< Rendered rows kept (power of 2, >= MDA_ROWS) */
+#define MDA_LIST_NO_ROW         0xFFFFFFFFUL /**< Cache tag for an empty slot */
+
+/**
+ * @brief Row-provider callback.
+ * @param index Record index to render (0 to count-1).
+ * @param text  Destination buffer of width+1 chars, to be NUL terminated.
+ * @param width Maximum number of characters the row can display.
+ * @param user  Opaque pointer supplied to mda_list_view_init().
+ */
+typedef void (*mda_list_row_provider_t)(uint32_t index, char* text, uint8_t width, void* user);
+
+/**
+ * @struct mda_list_view_t
+ * @brief State of one list view, including its rendered row cache.
+ */
+typedef struct {
+    mda_rect_t bounds;                  /**< Screen rectangle of the viewport */
+    uint32_t count;                     /**< Total number of records */
+    uint32_t top;                       /**< Index of the record in the top row */
+    uint32_t selected;                  /**< Index of the highlighted record */
+    uint8_t normal;                     /**< Attribute for unselected rows */
+    uint8_t highlight;                  /**< Attribute for the selected row */
+    mda_cell_t blank;                   /**< Cell used to clear exposed rows */
+    mda_list_row_provider_t provider;   /**< Row text source */
+    void* user;                         /**< Provider context */
+    uint32_t tags[MDA_LIST_CACHE_ROWS]; /**< Record index held in each cache slot */
+    mda_cell_t rows[MDA_LIST_CACHE_ROWS][MDA_COLUMNS]; /**< Rendered rows (normal attribute) */
+} mda_list_view_t;
+
+/**
+ * @brief Initialize a list view; nothing is drawn until mda_list_view_draw().
+ * @param view     List view to initialize.
+ * @param bounds   Screen rectangle (caller clipped to 80x25).
+ * @param count    Number of records.
+ * @param provider Row-provider callback.
+ * @param user     Opaque pointer passed to the provider.
+ */
+void mda_list_view_init(mda_list_view_t* view, const mda_rect_t* bounds, uint32_t count,
+                        mda_list_row_provider_t provider, void* user);
+
+/**
+ * @brief Redraw every visible row.
+ */
+void mda_list_view_draw(mda_list_view_t* view);
+
+/**
+ * @brief Move the selection to index, scrolling as little as possible.
+ * @details One-row moves off either edge scroll the viewport by one line and
+ * render one row; moves within the viewport only rewrite two attribute runs.
+ * Larger jumps fall back to a full redraw.
+ */
+void mda_list_view_select(mda_list_view_t* view, uint32_t index);
+
+/**
+ * @brief Drop all cached rows, e.g. after the underlying records change.
+ */
+void mda_list_view_invalidate(mda_list_view_t* view);
+
+/**
+ * @brief Change the record count, clamping the selection, and redraw.
+ */
+void mda_list_view_set_count(mda_list_view_t* view, uint32_t count);
+
+/**
+ * @defgroup list_view_nav List View Navigation
+ * @brief Convenience wrappers around mda_list_view_select().
+ * @{
+ */
+void mda_list_view_up(mda_list_view_t* view);         ///< Select previous record
+void mda_list_view_down(mda_list_view_t* view);       ///< Select next record
+void mda_list_view_page_up(mda_list_view_t* view);    ///< Select one page back
+void mda_list_view_page_down(mda_list_view_t* view);  ///< Select one page forward
+void mda_list_view_home(mda_list_view_t* view);       ///< Select first record
+void mda_list_view_end(mda_list_view_t* view);        ///< Select last record
+///@}
+
+#endif /* MDA_LIST_VIEW_H */
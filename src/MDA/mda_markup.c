@@ -0,0 +1,227 @@
+/**
+ * @file mda_markup.c
+ * @brief Implementation of the Rich-Text Markup Compiler
+ * @details Compilation keeps a nesting count per tag and re-derives the
+ * attribute only when a tag opens or closes; a run is extended while the
+ * attribute is unchanged. Rendering locates the first run by binary
+ * search and then streams runs in order.
+ * @author Jeremy Thornton
+ */
+#include "mda_markup.h"
+#include "mda_attributes.h"
+#include "mda_primitives.h"
+#include "../CONTRACT/contract.h"
+
+/**
+ * @enum markup_tag_t
+ * @brief Index of each tag's nesting count.
+ */
+typedef enum {
+    MARKUP_BOLD = 0,
+    MARKUP_UNDERLINE,
+    MARKUP_REVERSE,
+    MARKUP_FLASH,
+    MARKUP_TAGS
+} markup_tag_t;
+
+static const char markup_names[MARKUP_TAGS] = { 'b', 'u', 'r', 'f' };
+
+/**
+ * @brief Attribute of base modified by the open tags.
+ */
+static uint8_t markup_attr(uint8_t base, const uint8_t* open) {
+    uint8_t attr = base;
+    if (open[MARKUP_REVERSE]) {
+        attr = (attr & (MDA_BOLD | MDA_BLINK)) | MDA_REVERSE;
+    }
+    else if (open[MARKUP_UNDERLINE]) {
+        attr = (attr & 0xF8) | MDA_UNDERLINE;
+    }
+    if (open[MARKUP_BOLD]) {
+        attr |= MDA_BOLD;
+    }
+    if (open[MARKUP_FLASH]) {
+        attr |= MDA_BLINK;
+    }
+    return attr;
+}
+
+/**
+ * @brief Recognize {x} or {/x} at source.
+ * @return Tag index, or MARKUP_TAGS if source is not a tag, a '{' or "{/" ending the source included.
+ */
+static markup_tag_t markup_tag(const char* source, bool* close, uint8_t* size) {
+    *close = (source[1] == '/');
+    const char* name = source + 1 + *close;
+    if (*name == '\0' || name[1] != '}') {
+        return MARKUP_TAGS;
+    }
+    for (uint8_t t = 0; t < MARKUP_TAGS; ++t) {
+        if (markup_names[t] == *name) {
+            *size = 3 + *close;
+            return (markup_tag_t)t;
+        }
+    }
+    return MARKUP_TAGS;
+}
+
+void mda_markup_init(mda_markup_t* markup, char* text, uint16_t text_capacity,
+                     mda_markup_run_t* runs, uint16_t run_capacity) {
+    require_address(markup, "NULL markup!");
+    require_address(text, "NULL text!");
+    require_address(runs, "NULL runs!");
+    markup->text = text;
+    markup->text_capacity = text_capacity;
+    markup->length = 0;
+    markup->runs = runs;
+    markup->run_capacity = run_capacity;
+    markup->run_count = 0;
+}
+
+bool mda_markup_compile(mda_markup_t* markup, const char* source, uint8_t base) {
+    require_address(markup, "NULL markup!");
+    require_address(source, "NULL source!");
+    uint8_t open[MARKUP_TAGS] = { 0 };
+    uint8_t attr = base;
+    markup->length = 0;
+    markup->run_count = 0;
+    while (*source != '\0') {
+        char c = *source;
+        if (c == '{') {
+            bool close;
+            uint8_t size;
+            markup_tag_t tag = markup_tag(source, &close, &size);
+            if (tag != MARKUP_TAGS) {
+                if (!close) {
+                    open[tag]++;
+                }
+                else if (open[tag] > 0) {
+                    open[tag]--;
+                }
+                attr = markup_attr(base, open);
+                source += size;
+                continue;
+            }
+            if (source[1] == '{') {     // escaped brace
+                source++;
+            }
+        }
+        source++;
+        if (markup->length == markup->text_capacity) {
+            return false;
+        }
+        mda_markup_run_t* run = markup->runs + markup->run_count;
+        if (markup->run_count == 0 || (--run)->attr != attr) {
+            if (markup->run_count == markup->run_capacity) {
+                return false;
+            }
+            run = markup->runs + markup->run_count++;
+            run->start = markup->length;
+            run->length = 0;
+            run->attr = attr;
+        }
+        run->length++;
+        markup->text[markup->length++] = c;
+    }
+    return true;
+}
+
+uint16_t mda_markup_render(const mda_markup_t* markup, uint16_t from, uint16_t count, mda_cell_t* dst) {
+    require_address(markup, "NULL markup!");
+    require_address(dst, "NULL destination!");
+    if (from >= markup->length) {
+        return 0;
+    }
+    if (count > markup->length - from) {
+        count = markup->length - from;
+    }
+    uint16_t lo = 0;                        // last run starting at or before from
+    uint16_t hi = markup->run_count;
+    while (hi - lo > 1) {
+        uint16_t mid = (lo + hi) >> 1;
+        if (markup->runs[mid].start <= from) {
+            lo = mid;
+        }
+        else {
+            hi = mid;
+        }
+    }
+    const mda_markup_run_t* run = &markup->runs[lo];
+    const char* text = markup->text + from;
+    uint16_t left = count;
+    uint16_t skip = from - run->start;
+    while (left > 0) {
+        uint16_t n = run->length - skip;
+        if (n > left) {
+            n = left;
+        }
+        uint16_t attr = (uint16_t)run->attr << 8;
+        left -= n;
+        while (n-- > 0) {
+            (dst++)->packed = attr | (uint8_t)*text++;
+        }
+        run++;
+        skip = 0;
+    }
+    return count;
+}
+
+uint16_t mda_markup_wrap(const mda_markup_t* markup, uint16_t from, uint8_t width, uint16_t* next) {
+    require_address(markup, "NULL markup!");
+    require_address(next, "NULL next!");
+    require(width > 0, "INVALID wrap width!");
+    const char* text = markup->text;
+    uint16_t end = markup->length;
+    uint16_t limit = (end - from > width) ? from + width : end;
+    uint16_t space = from;
+    for (uint16_t i = from; i < limit; ++i) {
+        if (text[i] == '\n') {              // hard break
+            *next = i + 1;
+            return i - from;
+        }
+        if (text[i] == ' ') {
+            space = i;
+        }
+    }
+    if (limit == end) {                     // the rest fits
+        *next = end;
+        return end - from;
+    }
+    uint16_t n = width;                     // split an overlong word
+    if (text[limit] == ' ' || text[limit] == '\n') {
+        space = limit;
+    }
+    if (space > from) {                     // break at the last space
+        n = space - from;
+        limit = space;
+    }
+    while (limit < end && text[limit] == ' ') {
+        limit++;
+    }
+    if (limit < end && text[limit] == '\n') {
+        limit++;                            // the line already ended here
+    }
+    *next = limit;
+    return n;
+}
+
+uint16_t mda_markup_draw(const mda_markup_t* markup, uint16_t from, const mda_rect_t* rect, const mda_cell_t* blank) {
+    require_address(markup, "NULL markup!");
+    require_address(rect, "NULL rect!");
+    require_address(blank, "NULL blank!");
+    mda_point_t p = mda_point_make(rect->x, rect->y);
+    for (uint8_t y = 0; y < rect->h; ++y, ++p.y) {
+        mda_cell_t* vram = mda_as_pointer(&p);
+        uint16_t n = 0;
+        if (from < markup->length) {
+            uint16_t next;
+            n = mda_markup_wrap(markup, from, rect->w, &next);
+            mda_markup_render(markup, from, n, vram);
+            from = next;
+        }
+        for (vram += n; n < rect->w; ++n) {
+            *vram++ = *blank;
+        }
+    }
+    return from;
+}
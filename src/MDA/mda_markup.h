@@ -0,0 +1,92 @@
+/**
+ * @file mda_markup.h
+ * @brief Rich-Text Markup Compiled to Attribute Runs
+ * @details Mixed-attribute text is written with inline tags and compiled
+ * once into plain text plus a list of runs, each an attribute and the
+ * byte range of text it covers. Rendering then walks the runs and stores
+ * each one straight into cells — no tag parsing and no attribute
+ * switching per character — so a compiled help screen or form can be
+ * cached and redrawn at the cost of a cell copy.
+ *
+ * Tags (nestable, each closed by its slash form):
+ * - {b} ... {/b}  bold (intensity)
+ * - {u} ... {/u}  underline
+ * - {r} ... {/r}  reverse video
+ * - {f} ... {/f}  flashing (blink)
+ * - {{            a literal '{'
+ *
+ * MDA cannot underline reversed text, so reverse wins where both apply.
+ * Any other brace sequence is kept as text. A '\n' in the text is a
+ * hard line break for mda_markup_draw().
+ *
+ * Rendering takes a byte range of the compiled text, so lines produced
+ * by wrapping and fields clipped to a width both work directly on the
+ * run list.
+ *
+ * @author Jeremy Thornton
+ */
+#ifndef MDA_MARKUP_H
+#define MDA_MARKUP_H
+
+#include "mda_cell.h"
+#include "mda_types.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * @struct mda_markup_run_t
+ * @brief Attribute of text[start .. start + length).
+ */
+typedef struct {
+    uint16_t start;     /**< First byte of the run */
+    uint16_t length;    /**< Bytes in the run */
+    uint8_t attr;       /**< Attribute of every cell in the run */
+} mda_markup_run_t;
+
+/**
+ * @struct mda_markup_t
+ * @brief Compiled markup over caller supplied storage.
+ */
+typedef struct {
+    char* text;                 /**< Tag free text */
+    uint16_t text_capacity;     /**< Bytes available in text */
+    uint16_t length;            /**< Bytes of text compiled */
+    mda_markup_run_t* runs;     /**< Run storage */
+    uint16_t run_capacity;      /**< Runs available */
+    uint16_t run_count;         /**< Runs compiled */
+} mda_markup_t;
+
+/**
+ * @brief Attach storage to an empty markup.
+ */
+void mda_markup_init(mda_markup_t* markup, char* text, uint16_t text_capacity,
+                     mda_markup_run_t* runs, uint16_t run_capacity);
+
+/**
+ * @brief Compile markup source into text and runs.
+ * @param base Attribute of untagged text; tags modify it.
+ * @return false if the text or run storage overflowed (the result is truncated).
+ */
+bool mda_markup_compile(mda_markup_t* markup, const char* source, uint8_t base);
+
+/**
+ * @brief Render text[from .. from + count) into cells.
+ * @return Cells written (count clipped to the end of the text).
+ */
+uint16_t mda_markup_render(const mda_markup_t* markup, uint16_t from, uint16_t count, mda_cell_t* dst);
+
+/**
+ * @brief Bytes of the line starting at from that fit width, breaking after
+ *        the last space or at '\n'; a word longer than width is split.
+ * @param next Receives where the following line starts (past the break).
+ */
+uint16_t mda_markup_wrap(const mda_markup_t* markup, uint16_t from, uint8_t width, uint16_t* next);
+
+/**
+ * @brief Draw wrapped into rect from byte from, blanking the rest of each line.
+ * @param blank Cell for the unused part of rect.
+ * @return Where the text not fitting rect starts (markup->length if it all fit).
+ */
+uint16_t mda_markup_draw(const mda_markup_t* markup, uint16_t from, const mda_rect_t* rect, const mda_cell_t* blank);
+
+#endif /* MDA_MARKUP_H */
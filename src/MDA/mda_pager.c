@@ -0,0 +1,442 @@
+/**
+ * @file mda_pager.c
+ * @brief Implementation of the Streaming Text Pager Widget
+ * @details All file access goes through pager_block(), which returns a
+ * pointer to one block of the file: from the block cache on DOS, or
+ * straight from the mapping on the host. Line scanning works a block at a
+ * time so the inner loops stay within a single far segment.
+ * @author Jeremy Thornton
+ */
+#include "mda_pager.h"
+#include "mda_primitives.h"
+#include "../CONTRACT/contract.h"
+#include <string.h>
+
+#ifndef __DOS__
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#define PAGER_BLOCK_MASK    ((uint32_t)MDA_PAGER_BLOCK_SIZE - 1)
+
+#ifdef __DOS__
+
+static void pager_load(mda_pager_t* pager, uint32_t block) {
+    uint8_t slot = (uint8_t)(block % MDA_PAGER_BLOCKS);
+    pager->lengths[slot] = (uint16_t)fread(pager->blocks[slot], 1, MDA_PAGER_BLOCK_SIZE, pager->file);
+    pager->tags[slot] = block;
+}
+
+/**
+ * @brief Return one block of the file, reading it (and the next block) on a miss.
+ */
+static const char* pager_block(mda_pager_t* pager, uint32_t block, uint16_t* length) {
+    uint8_t slot = (uint8_t)(block % MDA_PAGER_BLOCKS);
+    if (pager->tags[slot] != block) {
+        uint8_t ahead = (uint8_t)((block + 1) % MDA_PAGER_BLOCKS);
+        fseek(pager->file, (long)(block << MDA_PAGER_BLOCK_SHIFT), SEEK_SET);
+        pager_load(pager, block);
+        if (pager->tags[ahead] != block + 1) {  // read-ahead: stream is already positioned
+            pager_load(pager, block + 1);
+        }
+    }
+    *length = pager->lengths[slot];
+    return pager->blocks[slot];
+}
+
+#else
+
+/**
+ * @brief Return one block of the file directly from the mapping.
+ */
+static const char* pager_block(mda_pager_t* pager, uint32_t block, uint16_t* length) {
+    uint32_t start = block << MDA_PAGER_BLOCK_SHIFT;
+    uint32_t remaining = (start < pager->size) ? pager->size - start : 0;
+    *length = (uint16_t)((remaining < MDA_PAGER_BLOCK_SIZE) ? remaining : MDA_PAGER_BLOCK_SIZE);
+    return pager->map + start;
+}
+
+#endif
+
+/**
+ * @brief Offset of the line following the line that contains offset.
+ * @return pager->size if there is no further line.
+ */
+static uint32_t pager_next_line(mda_pager_t* pager, uint32_t offset) {
+    while (offset < pager->size) {
+        uint16_t length;
+        uint32_t block = offset >> MDA_PAGER_BLOCK_SHIFT;
+        uint16_t i = (uint16_t)(offset & PAGER_BLOCK_MASK);
+        const char* data = pager_block(pager, block, &length);
+        const char* nl = (i < length) ? memchr(data + i, '\n', length - i) : NULL;
+        if (nl) {
+            return (block << MDA_PAGER_BLOCK_SHIFT) + (uint16_t)(nl - data) + 1;
+        }
+        offset = (block + 1) << MDA_PAGER_BLOCK_SHIFT;
+    }
+    return pager->size;
+}
+
+/**
+ * @brief Start offset of the line that contains the byte before offset.
+ * @details If offset is itself a line start, offset is returned.
+ */
+static uint32_t pager_line_start(mda_pager_t* pager, uint32_t offset) {
+    while (offset > 0) {
+        uint16_t length;
+        uint32_t block = (offset - 1) >> MDA_PAGER_BLOCK_SHIFT;
+        uint16_t i = (uint16_t)((offset - 1) & PAGER_BLOCK_MASK) + 1;   // bytes [0, i) to search
+        const char* data = pager_block(pager, block, &length);
+        while (i > 0) {
+            if (data[i - 1] == '\n') {
+                return (block << MDA_PAGER_BLOCK_SHIFT) + i;
+            }
+            --i;
+        }
+        offset = block << MDA_PAGER_BLOCK_SHIFT;
+    }
+    return 0;
+}
+
+/**
+ * @brief Start offset of the line before the line starting at offset.
+ */
+static uint32_t pager_prev_line(mda_pager_t* pager, uint32_t offset) {
+    return (offset > 0) ? pager_line_start(pager, offset - 1) : 0;
+}
+
+/**
+ * @brief Record that line starts at offset, extending the sparse index.
+ * @details Only contiguous progress from the known frontier is recorded, so
+ * index[k] always holds the start of line k * stride.
+ */
+static void pager_learn(mda_pager_t* pager, uint32_t line, uint32_t offset) {
+    if (line != pager->known_line + 1) {
+        return;
+    }
+    pager->known_line = line;
+    pager->known_offset = offset;
+    if (line & (pager->stride - 1)) {
+        return;
+    }
+    if (pager->index_count == MDA_PAGER_INDEX_SIZE) {   // full: halve density
+        for (uint16_t k = 0; k < MDA_PAGER_INDEX_SIZE / 2; ++k) {
+            pager->index[k] = pager->index[k * 2];
+        }
+        pager->index_count = MDA_PAGER_INDEX_SIZE / 2;
+        pager->stride <<= 1;
+        if (line & (pager->stride - 1)) {
+            return;
+        }
+    }
+    pager->index[pager->index_count++] = offset;
+}
+
+/**
+ * @brief Line number of the line starting at offset, if within the indexed region.
+ */
+static uint32_t pager_line_of(mda_pager_t* pager, uint32_t offset) {
+    if (offset > pager->known_offset) {
+        return MDA_PAGER_LINE_UNKNOWN;
+    }
+    uint16_t lo = 0;
+    uint16_t hi = pager->index_count;
+    while (hi - lo > 1) {   // last checkpoint <= offset
+        uint16_t mid = (lo + hi) / 2;
+        if (pager->index[mid] <= offset) {
+            lo = mid;
+        }
+        else {
+            hi = mid;
+        }
+    }
+    uint32_t line = (uint32_t)lo * pager->stride;
+    uint32_t at = pager->index[lo];
+    while (at < offset) {
+        at = pager_next_line(pager, at);
+        line++;
+    }
+    return line;
+}
+
+/**
+ * @brief Lay out the visible rows from the top row offset.
+ */
+static void pager_fill(mda_pager_t* pager, uint32_t top) {
+    uint32_t offset = top;
+    for (uint8_t r = 0; r < pager->bounds.h; ++r) {
+        pager->rows[r] = offset;
+        if (pager->top_line != MDA_PAGER_LINE_UNKNOWN && offset < pager->size) {
+            pager_learn(pager, pager->top_line + r, offset);
+        }
+        offset = (offset < pager->size) ? pager_next_line(pager, offset) : pager->size;
+    }
+}
+
+/**
+ * @brief Render viewport row r as one cell run, expanding tabs and clipping at the right edge.
+ */
+static void pager_draw_row(mda_pager_t* pager, uint8_t r) {
+    mda_cell_t row[MDA_COLUMNS];
+    mda_point_t p = mda_point_make(pager->bounds.x, pager->bounds.y + r);
+    uint8_t w = pager->bounds.w;
+    uint8_t x = 0;
+    uint32_t offset = pager->rows[r];
+    while (x < w && offset < pager->size) {
+        uint16_t length;
+        uint16_t i = (uint16_t)(offset & PAGER_BLOCK_MASK);
+        const char* data = pager_block(pager, offset >> MDA_PAGER_BLOCK_SHIFT, &length);
+        for (; i < length && x < w; ++i) {
+            char c = data[i];
+            if (c == '\n') {
+                offset = pager->size;   // end of line
+                break;
+            }
+            if (c == '\t') {
+                do {
+                    row[x].chr = ' ';
+                    row[x++].attr = pager->attr;
+                } while (x < w && x % MDA_DEFAULT_HTAB);
+            }
+            else if (c != '\r') {
+                row[x].chr = c;
+                row[x++].attr = pager->attr;
+            }
+        }
+        if (offset < pager->size) {
+            offset = ((offset >> MDA_PAGER_BLOCK_SHIFT) + 1) << MDA_PAGER_BLOCK_SHIFT;
+        }
+    }
+    for (; x < w; ++x) {
+        row[x].chr = ' ';
+        row[x].attr = pager->attr;
+    }
+    mda_write_cells(&p, row, w);
+}
+
+/**
+ * @brief Reposition the viewport at a line start and redraw; the line number
+ * is looked up in the index if the line start is inside it.
+ */
+static void pager_jump(mda_pager_t* pager, uint32_t top) {
+    pager->top_line = pager_line_of(pager, top);
+    pager_fill(pager, top);
+    mda_pager_draw(pager);
+}
+
+bool mda_pager_open(mda_pager_t* pager, const char* path, const mda_rect_t* bounds) {
+    require_address(pager, "NULL pager!");
+    require_address(path, "NULL path!");
+    require_address(bounds, "NULL bounds!");
+    require(bounds->w > 0 && bounds->w <= MDA_COLUMNS, "INVALID pager width!");
+    require(bounds->h > 0 && bounds->h <= MDA_ROWS, "INVALID pager height!");
+#ifdef __DOS__
+    pager->file = fopen(path, "rb");
+    if (!pager->file) {
+        return false;
+    }
+    fseek(pager->file, 0L, SEEK_END);
+    pager->size = (uint32_t)ftell(pager->file);
+    for (uint8_t i = 0; i < MDA_PAGER_BLOCKS; ++i) {
+        pager->tags[i] = 0xFFFFFFFFUL;
+    }
+#else
+    struct stat st;
+    pager->fd = open(path, O_RDONLY);
+    if (pager->fd < 0) {
+        return false;
+    }
+    if (fstat(pager->fd, &st) != 0) {
+        close(pager->fd);
+        return false;
+    }
+    pager->size = (uint32_t)st.st_size;
+    pager->map = NULL;
+    if (pager->size > 0) {
+        void* map = mmap(NULL, pager->size, PROT_READ, MAP_PRIVATE, pager->fd, 0);
+        if (map == MAP_FAILED) {
+            close(pager->fd);
+            return false;
+        }
+        pager->map = (const char*)map;
+    }
+#endif
+    pager->bounds = *bounds;
+    pager->attr = MDA_NORMAL;
+    pager->known_line = 0;
+    pager->known_offset = 0;
+    pager->stride = MDA_PAGER_INDEX_STRIDE;
+    pager->index[0] = 0;
+    pager->index_count = 1;
+    pager->top_line = 0;
+    pager_fill(pager, 0);
+    return true;
+}
+
+void mda_pager_close(mda_pager_t* pager) {
+    require_address(pager, "NULL pager!");
+#ifdef __DOS__
+    if (pager->file) {
+        fclose(pager->file);
+        pager->file = NULL;
+    }
+#else
+    if (pager->map) {
+        munmap((void*)pager->map, pager->size);
+        pager->map = NULL;
+    }
+    if (pager->fd >= 0) {
+        close(pager->fd);
+        pager->fd = -1;
+    }
+#endif
+}
+
+void mda_pager_draw(mda_pager_t* pager) {
+    require_address(pager, "NULL pager!");
+    for (uint8_t r = 0; r < pager->bounds.h; ++r) {
+        pager_draw_row(pager, r);
+    }
+}
+
+void mda_pager_line_down(mda_pager_t* pager) {
+    require_address(pager, "NULL pager!");
+    uint8_t last = pager->bounds.h - 1;
+    if (pager->rows[last] >= pager->size) {
+        return;
+    }
+    uint32_t next = pager_next_line(pager, pager->rows[last]);
+    if (next >= pager->size) {  // bottom row already shows the last line
+        return;
+    }
+    for (uint8_t r = 0; r < last; ++r) {
+        pager->rows[r] = pager->rows[r + 1];
+    }
+    pager->rows[last] = next;
+    if (pager->top_line != MDA_PAGER_LINE_UNKNOWN) {
+        pager->top_line++;
+        pager_learn(pager, pager->top_line + last, next);
+    }
+    if (last > 0) {
+        mda_cell_t blank = mda_cell_make(' ', pager->attr);
+        mda_scroll_up(&pager->bounds, &blank);
+    }
+    pager_draw_row(pager, last);
+}
+
+void mda_pager_line_up(mda_pager_t* pager) {
+    require_address(pager, "NULL pager!");
+    uint8_t last = pager->bounds.h - 1;
+    if (pager->rows[0] == 0) {
+        return;
+    }
+    for (uint8_t r = last; r > 0; --r) {
+        pager->rows[r] = pager->rows[r - 1];
+    }
+    pager->rows[0] = pager_prev_line(pager, pager->rows[0]);
+    if (pager->top_line != MDA_PAGER_LINE_UNKNOWN) {
+        pager->top_line--;
+    }
+    else {                      // known again once back inside the indexed region
+        pager->top_line = pager_line_of(pager, pager->rows[0]);
+    }
+    if (last > 0) {
+        mda_cell_t blank = mda_cell_make(' ', pager->attr);
+        mda_scroll_down(&pager->bounds, &blank);
+    }
+    pager_draw_row(pager, 0);
+}
+
+void mda_pager_page_down(mda_pager_t* pager) {
+    require_address(pager, "NULL pager!");
+    uint8_t last = pager->bounds.h - 1;
+    uint32_t bottom = pager->rows[last];
+    if (bottom >= pager->size || pager_next_line(pager, bottom) >= pager->size) {
+        return;
+    }
+    if (last == 0) {    // single row viewport: the bottom row is the top row
+        bottom = pager_next_line(pager, bottom);
+        last = 1;
+    }
+    if (pager->top_line != MDA_PAGER_LINE_UNKNOWN) {
+        pager->top_line += last;
+    }
+    pager_fill(pager, bottom);
+    mda_pager_draw(pager);
+}
+
+void mda_pager_page_up(mda_pager_t* pager) {
+    require_address(pager, "NULL pager!");
+    uint32_t top = pager->rows[0];
+    for (uint8_t r = 1; r < pager->bounds.h && top > 0; ++r) {
+        top = pager_prev_line(pager, top);
+    }
+    pager_jump(pager, top);
+}
+
+void mda_pager_home(mda_pager_t* pager) {
+    require_address(pager, "NULL pager!");
+    pager_jump(pager, 0);
+}
+
+void mda_pager_end(mda_pager_t* pager) {
+    require_address(pager, "NULL pager!");
+    uint32_t top = pager->size;
+    if (top > 0) {
+        uint16_t length;
+        uint32_t block = (top - 1) >> MDA_PAGER_BLOCK_SHIFT;
+        const char* data = pager_block(pager, block, &length);
+        if (data[(uint16_t)((top - 1) & PAGER_BLOCK_MASK)] == '\n') {
+            top--;  // ignore the terminator of the last line
+        }
+        top = pager_line_start(pager, top);
+    }
+    for (uint8_t r = 1; r < pager->bounds.h && top > 0; ++r) {
+        top = pager_prev_line(pager, top);
+    }
+    pager_jump(pager, top);
+}
+
+void mda_pager_seek_percent(mda_pager_t* pager, uint8_t percent) {
+    require_address(pager, "NULL pager!");
+    require(percent <= 100, "INVALID percentage!");
+    if (percent == 100) {
+        mda_pager_end(pager);
+        return;
+    }
+    uint32_t offset = (pager->size / 100) * percent + ((pager->size % 100) * percent) / 100;
+    pager_jump(pager, pager_line_start(pager, offset));
+}
+
+void mda_pager_goto_line(mda_pager_t* pager, uint32_t line) {
+    require_address(pager, "NULL pager!");
+    uint32_t at;
+    uint32_t offset;
+    if (line <= pager->known_line) {    // start from the nearest checkpoint
+        uint16_t k = (uint16_t)(line / pager->stride);
+        at = (uint32_t)k * pager->stride;
+        offset = pager->index[k];
+    }
+    else {                              // stream forward from the frontier
+        at = pager->known_line;
+        offset = pager->known_offset;
+    }
+    while (at < line) {
+        uint32_t next = pager_next_line(pager, offset);
+        if (next >= pager->size) {
+            break;
+        }
+        offset = next;
+        pager_learn(pager, ++at, offset);
+    }
+    pager->top_line = at;
+    pager_fill(pager, offset);
+    mda_pager_draw(pager);
+}
+
+uint32_t mda_pager_top_line(const mda_pager_t* pager) {
+    require_address(pager, "NULL pager!");
+    return pager->top_line;
+}
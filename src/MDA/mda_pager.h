@@ -0,0 +1,105 @@
+/**
+ * @file mda_pager.h
+ * @brief Streaming Text Pager Widget
+ * @details Views text files far larger than conventional memory inside a
+ * rectangle. The file is read in fixed-size blocks through a small
+ * direct-mapped block cache, so only the visible window plus a block of
+ * read-ahead is ever resident.
+ *
+ * Line numbers are discovered lazily: as the user scrolls forward from the
+ * start of the file, every stride-th line start is recorded in a sparse
+ * index. When the index fills up, every other checkpoint is dropped and the
+ * stride doubles, so the index never grows beyond MDA_PAGER_INDEX_SIZE.
+ * Jumps to the end or to a percentage seek straight to the byte offset and
+ * resynchronize on the enclosing line start. The line number is looked up
+ * in the index whenever a jump, or a scroll back, lands inside the indexed
+ * region, and is unknown only beyond it.
+ *
+ * On the host build the file is memory mapped and blocks are served
+ * straight from the mapping without copying.
+ *
+ * @author Jeremy Thornton
+ */
+#ifndef MDA_PAGER_H
+#define MDA_PAGER_H
+
+#include "mda_constants.h"
+#include "mda_types.h"
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#define MDA_PAGER_BLOCK_SHIFT   9                       /**< log2 of the block size */
+#define MDA_PAGER_BLOCK_SIZE    (1 << MDA_PAGER_BLOCK_SHIFT) /**< Bytes per file block */
+#define MDA_PAGER_BLOCKS        8                       /**< Cached blocks (window + read-ahead) */
+#define MDA_PAGER_INDEX_SIZE    256                     /**< Sparse line index checkpoints */
+#define MDA_PAGER_INDEX_STRIDE  16                      /**< Initial lines per checkpoint */
+#define MDA_PAGER_LINE_UNKNOWN  0xFFFFFFFFUL            /**< Line number not yet known */
+
+/**
+ * @struct mda_pager_t
+ * @brief State of one pager: file access, block cache, line index and viewport.
+ */
+typedef struct {
+    mda_rect_t bounds;                          /**< Screen rectangle of the viewport */
+    uint8_t attr;                               /**< Text attribute */
+    uint32_t size;                              /**< File size in bytes */
+    uint32_t top_line;                          /**< Line number of the top row, or MDA_PAGER_LINE_UNKNOWN */
+    uint32_t rows[MDA_ROWS];                    /**< Line start offset per visible row (size = past EOF) */
+    uint32_t known_line;                        /**< Furthest line reached contiguously from line 0 */
+    uint32_t known_offset;                      /**< Start offset of known_line */
+    uint32_t stride;                            /**< Lines between index checkpoints */
+    uint16_t index_count;                       /**< Checkpoints in use */
+    uint32_t index[MDA_PAGER_INDEX_SIZE];       /**< index[k] = start offset of line k * stride */
+#ifdef __DOS__
+    FILE* file;                                 /**< Open file stream */
+    uint32_t tags[MDA_PAGER_BLOCKS];            /**< Block number held in each cache slot */
+    uint16_t lengths[MDA_PAGER_BLOCKS];         /**< Valid bytes in each cache slot */
+    char blocks[MDA_PAGER_BLOCKS][MDA_PAGER_BLOCK_SIZE]; /**< Block cache */
+#else
+    int fd;                                     /**< Open file descriptor */
+    const char* map;                            /**< Read-only mapping of the whole file */
+#endif
+} mda_pager_t;
+
+/**
+ * @brief Open a file for paging; nothing is drawn until mda_pager_draw().
+ * @param pager  Pager to initialize.
+ * @param path   File to view.
+ * @param bounds Screen rectangle (caller clipped to 80x25).
+ * @return true on success, false if the file cannot be opened.
+ */
+bool mda_pager_open(mda_pager_t* pager, const char* path, const mda_rect_t* bounds);
+
+/**
+ * @brief Release the file and any mapping held by the pager.
+ */
+void mda_pager_close(mda_pager_t* pager);
+
+/**
+ * @brief Redraw every visible row.
+ */
+void mda_pager_draw(mda_pager_t* pager);
+
+/**
+ * @defgroup pager_nav Pager Navigation
+ * @brief Single-line moves scroll the viewport and render one row;
+ * all other moves reposition and redraw.
+ * @{
+ */
+void mda_pager_line_down(mda_pager_t* pager);   ///< Scroll forward one line
+void mda_pager_line_up(mda_pager_t* pager);     ///< Scroll back one line
+void mda_pager_page_down(mda_pager_t* pager);   ///< Scroll forward one page
+void mda_pager_page_up(mda_pager_t* pager);     ///< Scroll back one page
+void mda_pager_home(mda_pager_t* pager);        ///< Jump to the first line
+void mda_pager_end(mda_pager_t* pager);         ///< Jump to the last page without reading the file through
+void mda_pager_seek_percent(mda_pager_t* pager, uint8_t percent); ///< Jump to a byte position (0-100%)
+void mda_pager_goto_line(mda_pager_t* pager, uint32_t line);      ///< Jump to a line, extending the index as needed
+///@}
+
+/**
+ * @brief Line number of the top row, or MDA_PAGER_LINE_UNKNOWN after a seek.
+ */
+uint32_t mda_pager_top_line(const mda_pager_t* pager);
+
+#endif /* MDA_PAGER_H */
@@ -0,0 +1,109 @@
+/**
+ * @file mda_pattern.c
+ * @brief Implementation of Tiled Pattern and Shade Gradient Fills
+ * @details A row buffer is seeded with one period of the pattern (already
+ * phase shifted to the rectangle's x) and then doubled with memcpy until
+ * it spans the rectangle: log2(w / pw) block copies per distinct row.
+ * @author Jeremy Thornton
+ */
+#include "mda_pattern.h"
+#include "mda_primitives.h"
+#include "cp437_constants.h"
+#include "../CONTRACT/contract.h"
+#include <string.h>
+
+static const char pattern_shades[MDA_SHADE_LEVELS] = {
+    ' ', CP437_LIGHT_SHADE, CP437_MEDIUM_SHADE, CP437_DARK_SHADE, CP437_FULL_BLOCK
+};
+
+static mda_cell_t pattern_rows[MDA_PATTERN_MAX_ROWS][MDA_COLUMNS];  // static: spares the small DOS stack
+
+/**
+ * @brief Repeat the first period cells of row until it holds count cells.
+ */
+static void pattern_double(mda_cell_t* row, uint8_t period, uint8_t count) {
+    uint8_t n = period;
+    while (n < count) {
+        uint8_t k = (n < count - n) ? n : count - n;
+        memcpy(row + n, row, k * sizeof(mda_cell_t));
+        n += k;
+    }
+}
+
+/**
+ * @brief Shade level of step i of n ramping from..to, rounded to nearest.
+ */
+static uint8_t pattern_level(uint8_t i, uint8_t n, uint8_t from, uint8_t to) {
+    if (n < 2) {
+        return from;
+    }
+    uint16_t span = n - 1;
+    return (uint8_t)((from * (span - i) + to * i + span / 2) / span);
+}
+
+mda_cell_t mda_shade_cell(uint8_t level, uint8_t attr) {
+    require(level < MDA_SHADE_LEVELS, "INVALID shade level!");
+    return mda_cell_make(pattern_shades[level], attr);
+}
+
+void mda_fill_pattern(const mda_rect_t* rect, const mda_cell_t* pattern, uint8_t pw, uint8_t ph) {
+    require_address(rect, "NULL rect!");
+    require_address(pattern, "NULL pattern!");
+    require(pw > 0 && pw <= MDA_COLUMNS, "INVALID pattern width!");
+    require(ph > 0 && ph <= MDA_PATTERN_MAX_ROWS, "INVALID pattern height!");
+    if (rect->w == 0 || rect->h == 0) {
+        return;
+    }
+    uint8_t rows = (ph < rect->h) ? ph : rect->h;
+    uint8_t phase = rect->x % pw;               // anchored to the screen origin
+    for (uint8_t r = 0; r < rows; ++r) {        // expand each distinct row once
+        const mda_cell_t* src = pattern + ((rect->y + r) % ph) * pw;
+        mda_cell_t* row = pattern_rows[r];
+        uint8_t period = (pw < rect->w) ? pw : rect->w;
+        for (uint8_t i = 0; i < period; ++i) {
+            row[i] = src[(phase + i) % pw];
+        }
+        pattern_double(row, period, rect->w);
+    }
+    mda_point_t p = mda_point_make(rect->x, rect->y);
+    for (uint8_t r = 0, i = 0; i < rect->h; ++i, ++p.y) {
+        mda_write_cells(&p, pattern_rows[r], rect->w);
+        if (++r == rows) {
+            r = 0;
+        }
+    }
+}
+
+void mda_fill_hgradient(const mda_rect_t* rect, uint8_t from, uint8_t to, uint8_t attr) {
+    require_address(rect, "NULL rect!");
+    require(from < MDA_SHADE_LEVELS && to < MDA_SHADE_LEVELS, "INVALID shade level!");
+    mda_cell_t* row = pattern_rows[0];
+    for (uint8_t i = 0; i < rect->w; ++i) {
+        row[i] = mda_cell_make(pattern_shades[pattern_level(i, rect->w, from, to)], attr);
+    }
+    mda_point_t p = mda_point_make(rect->x, rect->y);
+    for (uint8_t i = 0; i < rect->h; ++i, ++p.y) {
+        mda_write_cells(&p, row, rect->w);
+    }
+}
+
+void mda_fill_vgradient(const mda_rect_t* rect, uint8_t from, uint8_t to, uint8_t attr) {
+    require_address(rect, "NULL rect!");
+    require(from < MDA_SHADE_LEVELS && to < MDA_SHADE_LEVELS, "INVALID shade level!");
+    if (rect->w == 0 || rect->h == 0) {
+        return;
+    }
+    mda_rect_t band = mda_rect_make(rect->x, rect->y, rect->w, 0);
+    uint8_t level = pattern_level(0, rect->h, from, to);
+    for (uint8_t i = 0; i <= rect->h; ++i) {    // one fill per band of equal shade
+        uint8_t next = (i < rect->h) ? pattern_level(i, rect->h, from, to) : MDA_SHADE_LEVELS;
+        if (next != level) {
+            mda_cell_t cell = mda_shade_cell(level, attr);
+            mda_fill_rect(&band, &cell);
+            band.y += band.h;
+            band.h = 0;
+            level = next;
+        }
+        band.h++;
+    }
+}
@@ -0,0 +1,53 @@
+/**
+ * @file mda_pattern.h
+ * @brief Tiled Pattern and Shade Gradient Fills
+ * @details Fills rectangles with textures instead of a single cell:
+ * - pattern fills tile a small pw x ph block of cells (a 2x2 checker of
+ *   shades, a 4x1 stripe, ...) anchored to the screen origin, so adjacent
+ *   fills line up seamlessly;
+ * - gradients step through the CP437 shade ramp ( ░ ▒ ▓ █) across or
+ *   down the rectangle.
+ *
+ * Each distinct pattern row is expanded once into a row buffer, by
+ * doubling block copies, and every scanline is then a single
+ * mda_write_cells() block move — so a textured fill costs about the same
+ * as a solid one. Vertical gradients need no buffer at all: each band of
+ * rows sharing a shade is one mda_fill_rect().
+ *
+ * @note Like the primitives, unbounded — caller must clip.
+ * @author Jeremy Thornton
+ */
+#ifndef MDA_PATTERN_H
+#define MDA_PATTERN_H
+
+#include "mda_cell.h"
+#include "mda_constants.h"
+#include "mda_types.h"
+#include <stdint.h>
+
+#define MDA_PATTERN_MAX_ROWS    4   /**< Pattern height limit */
+#define MDA_SHADE_LEVELS        5   /**< Shade ramp: blank, light, medium, dark, full */
+
+/**
+ * @brief Cell of shade level 0 (blank) .. MDA_SHADE_LEVELS - 1 (full block).
+ */
+mda_cell_t mda_shade_cell(uint8_t level, uint8_t attr);
+
+/**
+ * @brief Tile a pattern over rect.
+ * @param pattern pw x ph cells, row major.
+ * @param pw      Pattern width (1..MDA_COLUMNS).
+ * @param ph      Pattern height (1..MDA_PATTERN_MAX_ROWS).
+ */
+void mda_fill_pattern(const mda_rect_t* rect, const mda_cell_t* pattern, uint8_t pw, uint8_t ph);
+
+/**
+ * @defgroup shade_gradients Shade Gradients
+ * @brief Ramp linearly from shade level from to level to (inclusive).
+ * @{
+ */
+void mda_fill_hgradient(const mda_rect_t* rect, uint8_t from, uint8_t to, uint8_t attr);   ///< Left to right
+void mda_fill_vgradient(const mda_rect_t* rect, uint8_t from, uint8_t to, uint8_t attr);   ///< Top to bottom
+///@}
+
+#endif /* MDA_PATTERN_H */
@@ -0,0 +1,225 @@
+/**
+ * @file mda_player.c
+ * @brief Implementation of the Screen Session Player
+ * @details Play time is the sum of the forward steps between recorded
+ * timestamps, so it only ever grows; the index and the step loop compute
+ * it identically, which is what lets a seek resume from a keyframe.
+ * @author Jeremy Thornton
+ */
+#include "mda_player.h"
+#include "mda_clock.h"
+#include "mda_primitives.h"
+#include "mda_recorder.h"
+#include "../CONTRACT/contract.h"
+#include <string.h>
+
+#define PLAYER_BLANK    0x0720      // normal attribute space
+
+static uint8_t player_payload[MDA_SCREEN_BYTES];
+
+/**
+ * @brief Read a record header.
+ * @return false at the end of the file.
+ */
+static bool player_header(FILE* file, uint8_t* tag, uint32_t* stamp, uint16_t* length) {
+    uint8_t header[MDA_RECORD_HEADER];
+    if (fread(header, 1, MDA_RECORD_HEADER, file) != MDA_RECORD_HEADER) {
+        return false;
+    }
+    *tag = header[0];
+    *stamp = header[1] | ((uint32_t)header[2] << 8) | ((uint32_t)header[3] << 16) | ((uint32_t)header[4] << 24);
+    *length = header[5] | ((uint16_t)header[6] << 8);
+    return true;
+}
+
+/**
+ * @brief Play time of a record stamped stamp, after one at time stamped last.
+ */
+static uint32_t player_advance(uint32_t time, uint32_t last, uint32_t stamp) {
+    return (stamp >= last) ? time + (stamp - last) : time;     // a new session adds no delay
+}
+
+/**
+ * @brief Read a record payload into the screen image.
+ * @return false if the record is cut short or malformed.
+ */
+static bool player_apply(mda_player_t* player, uint8_t tag, uint16_t length) {
+    if (tag == MDA_RECORD_KEYFRAME) {
+        if (length != MDA_SCREEN_BYTES || fread(player->screen, 1, length, player->file) != length) {
+            return false;
+        }
+        player->dirty = MDA_RECORD_ALL_ROWS;
+        return true;
+    }
+    if (tag != MDA_RECORD_DELTA) {                      // unknown record: skip it
+        return fseek(player->file, length, SEEK_CUR) == 0;
+    }
+    if (length >= MDA_SCREEN_BYTES || fread(player_payload, 1, length, player->file) != length) {
+        return false;
+    }
+    const uint8_t* span = player_payload;
+    const uint8_t* end = player_payload + length;
+    while (span + MDA_RECORD_SPAN <= end) {
+        uint16_t offset = span[0] | ((uint16_t)span[1] << 8);
+        uint8_t count = span[2];
+        span += MDA_RECORD_SPAN;
+        if (offset >= MDA_SCREEN_WORDS || count > MDA_SCREEN_WORDS - offset || span + count * 2 > end) {
+            return false;
+        }
+        memcpy(player->screen + offset, span, count * 2);
+        span += count * 2;
+        player->dirty |= 1UL << (offset / MDA_COLUMNS);
+    }
+    return true;
+}
+
+/**
+ * @brief Rewind to the first record with a blank screen image.
+ */
+static void player_rewind(mda_player_t* player) {
+    fseek(player->file, player->data, SEEK_SET);
+    for (uint16_t i = 0; i < MDA_SCREEN_WORDS; ++i) {
+        player->screen[i].packed = PLAYER_BLANK;
+    }
+    player->time = 0;
+    player->stamp = 0;
+    player->dirty = MDA_RECORD_ALL_ROWS;
+}
+
+bool mda_player_open(mda_player_t* player, const char* path, mda_player_key_t* keys, uint16_t capacity) {
+    require_address(player, "NULL player!");
+    require_address(path, "NULL path!");
+    require_address(keys, "NULL keys!");
+    uint8_t header[MDA_RECORD_FILE_HEADER];
+    player->file = fopen(path, "rb");
+    if (player->file == NULL) {
+        return false;
+    }
+    if (fread(header, 1, MDA_RECORD_FILE_HEADER, player->file) != MDA_RECORD_FILE_HEADER
+        || memcmp(header, MDA_RECORD_MAGIC, 4) != 0 || header[4] != MDA_RECORD_VERSION
+        || header[5] != MDA_COLUMNS || header[6] != MDA_ROWS) {
+        fclose(player->file);
+        return false;
+    }
+    player->data = ftell(player->file);
+    player->keys = keys;
+    player->key_capacity = capacity;
+    player->key_count = 0;
+    uint32_t time = 0;
+    uint32_t last = 0;
+    long offset = player->data;
+    uint8_t tag;
+    uint32_t stamp;
+    uint16_t length;
+    while (player_header(player->file, &tag, &stamp, &length)) {
+        time = player_advance(time, last, stamp);
+        last = stamp;
+        if (tag == MDA_RECORD_KEYFRAME && player->key_count < capacity) {
+            mda_player_key_t* key = &keys[player->key_count++];
+            key->time = time;
+            key->stamp = stamp;
+            key->offset = offset;
+        }
+        if (fseek(player->file, length, SEEK_CUR) != 0) {
+            break;
+        }
+        offset += MDA_RECORD_HEADER + length;
+    }
+    player->duration = time;
+    player_rewind(player);
+    return true;
+}
+
+void mda_player_close(mda_player_t* player) {
+    require_address(player, "NULL player!");
+    fclose(player->file);
+    player->file = NULL;
+}
+
+bool mda_player_step(mda_player_t* player) {
+    require_address(player, "NULL player!");
+    uint8_t tag;
+    uint32_t stamp;
+    uint16_t length;
+    if (!player_header(player->file, &tag, &stamp, &length) || !player_apply(player, tag, length)) {
+        return false;
+    }
+    player->time = player_advance(player->time, player->stamp, stamp);
+    player->stamp = stamp;
+    return true;
+}
+
+void mda_player_seek(mda_player_t* player, uint32_t time) {
+    require_address(player, "NULL player!");
+    uint16_t k = player->key_count;
+    while (k > 0 && player->keys[k - 1].time > time) {
+        k--;
+    }
+    if (k == 0) {
+        player_rewind(player);
+    }
+    else {
+        const mda_player_key_t* key = &player->keys[k - 1];
+        fseek(player->file, key->offset, SEEK_SET);
+        player->time = key->time;
+        player->stamp = key->stamp;
+    }
+    for (;;) {
+        long offset = ftell(player->file);
+        uint8_t tag;
+        uint32_t stamp;
+        uint16_t length;
+        if (!player_header(player->file, &tag, &stamp, &length)) {
+            break;
+        }
+        uint32_t due = player_advance(player->time, player->stamp, stamp);
+        if (due > time || !player_apply(player, tag, length)) {
+            fseek(player->file, offset, SEEK_SET);
+            break;
+        }
+        player->time = due;
+        player->stamp = stamp;
+    }
+    player->dirty = MDA_RECORD_ALL_ROWS;
+}
+
+void mda_player_show(mda_player_t* player) {
+    require_address(player, "NULL player!");
+    mda_point_t p = mda_point_make(0, 0);
+    for (uint32_t rows = player->dirty; p.y < MDA_ROWS; ++p.y, rows >>= 1) {
+        if (rows & 1) {
+            mda_write_cells(&p, player->screen + p.y * MDA_COLUMNS, MDA_COLUMNS);
+        }
+    }
+    player->dirty = 0;
+}
+
+bool mda_player_play(mda_player_t* player, uint16_t speed, mda_player_poll_t poll, void* user) {
+    require_address(player, "NULL player!");
+    require(speed > 0, "INVALID speed!");
+    uint32_t start = mda_clock_ms();
+    uint32_t from = player->time;
+    for (;;) {
+        long offset = ftell(player->file);
+        uint8_t tag;
+        uint32_t stamp;
+        uint16_t length;
+        if (!player_header(player->file, &tag, &stamp, &length)) {
+            return true;
+        }
+        uint32_t due = player_advance(player->time, player->stamp, stamp) - from;
+        due = (due / speed) * MDA_PLAYER_REAL_TIME + (due % speed) * MDA_PLAYER_REAL_TIME / speed;
+        while (mda_clock_ms() - start < due) {
+            if (poll != NULL && !poll(user)) {
+                fseek(player->file, offset, SEEK_SET);
+                return false;
+            }
+        }
+        if (!player_apply(player, tag, length)) {
+            return true;
+        }
+        player->time = player_advance(player->time, player->stamp, stamp);
+        player->stamp = stamp;
+        mda_player_show(player);
+    }
+}
@@ -0,0 +1,100 @@
+/**
+ * @file mda_player.h
+ * @brief Screen Session Player
+ * @details Replays a recording made with mda_recorder.h into a screen
+ * image, at real time or faster, and shows it with mda_write_cells().
+ * Only the rows a record changed are written to the screen.
+ *
+ * Opening a recording scans its record headers once — payloads are
+ * skipped with fseek() — to find its length and the position of each
+ * keyframe. A seek restores the nearest keyframe at or before the target
+ * and replays the deltas from there.
+ *
+ * Recordings holding several sessions play back to back: a timestamp
+ * that goes backwards starts a new session and adds no delay.
+ *
+ * The player uses only stdio, so recordings made on DOS can be replayed
+ * by the host build.
+ *
+ * @author Jeremy Thornton
+ */
+#ifndef MDA_PLAYER_H
+#define MDA_PLAYER_H
+
+#include "mda_cell.h"
+#include "mda_constants.h"
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#define MDA_PLAYER_REAL_TIME    100     /**< Speed in percent */
+
+/**
+ * @struct mda_player_key_t
+ * @brief Where a keyframe is and when it plays.
+ */
+typedef struct {
+    uint32_t time;          /**< Play time (ms from the start of the recording) */
+    uint32_t stamp;         /**< Time recorded in the keyframe */
+    long offset;            /**< File position of the record */
+} mda_player_key_t;
+
+/**
+ * @brief Called while the player waits for the next frame.
+ * @return false to stop playing.
+ */
+typedef bool (*mda_player_poll_t)(void* user);
+
+/**
+ * @struct mda_player_t
+ * @brief Recording, keyframe index and reconstructed screen of one player.
+ */
+typedef struct {
+    FILE* file;                             /**< Recording */
+    long data;                              /**< File position of the first record */
+    mda_player_key_t* keys;                 /**< Caller supplied keyframe index */
+    uint16_t key_capacity;                  /**< Entries in keys; later keyframes are not indexed */
+    uint16_t key_count;                     /**< Keyframes indexed */
+    uint32_t duration;                      /**< Play time of the last record */
+    uint32_t time;                          /**< Play time of the last record applied */
+    uint32_t stamp;                         /**< Time recorded in the last record applied */
+    uint32_t dirty;                         /**< Bit y set if row y changed since the last show */
+    mda_cell_t screen[MDA_SCREEN_WORDS];    /**< Screen as of time */
+} mda_player_t;
+
+/**
+ * @brief Open a recording, index its keyframes and rewind to the start.
+ * @return false if the file cannot be opened or is not a recording.
+ */
+bool mda_player_open(mda_player_t* player, const char* path, mda_player_key_t* keys, uint16_t capacity);
+
+/**
+ * @brief Close the recording.
+ */
+void mda_player_close(mda_player_t* player);
+
+/**
+ * @brief Apply the next record to the screen image.
+ * @return false at the end of the recording.
+ */
+bool mda_player_step(mda_player_t* player);
+
+/**
+ * @brief Rebuild the screen image as it was at play time.
+ */
+void mda_player_seek(mda_player_t* player, uint32_t time);
+
+/**
+ * @brief Write the rows changed since the last show to the screen.
+ */
+void mda_player_show(mda_player_t* player);
+
+/**
+ * @brief Play from the current position to the end, showing each frame when due.
+ * @param speed Percent of real time, e.g. MDA_PLAYER_REAL_TIME or 400 for 4x.
+ * @param poll  Called while waiting, or NULL.
+ * @return false if poll stopped playback.
+ */
+bool mda_player_play(mda_player_t* player, uint16_t speed, mda_player_poll_t poll, void* user);
+
+#endif /* MDA_PLAYER_H */
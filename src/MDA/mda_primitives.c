@@ -7,16 +7,26 @@
  *
  * All functions assume caller has clipped coordinates to 80x25 or context bounds.
  *
+ * The host build replaces each assembly routine with a C equivalent drawing
+ * into the CRTC model (mda_crtc.h), with the same addressing.
+ *
  * @note Hand-tuned for minimal instruction count and cycle usage.
  * @author Jeremy Thornton
  */
 #include "mda_primitives.h"
 #include "mda_cell.h"
 #include "mda_constants.h"
+#include "mda_crtc.h"
+#include "mda_kernels.h"
+#include "mda_trace.h"
+#include <string.h>
+
+#ifdef __DOS__
 
 mda_cell_t* mda_as_pointer(const mda_point_t* point) {
     mda_cell_t* pcell = 0;
     mda_cell_t** ppcell = &pcell;
+    uint16_t base = mda_vram_base;
     __asm {
         .8086
         // 1. register setup (no flags used)
@@ -36,6 +46,7 @@ mda_cell_t* mda_as_pointer(const mda_point_t* point) {
         shl  dx, 1
         add  dx, ax          ; ax = y*80 + x
         shl  dx, 1           ; word offset ES:DI *VRAM (x,y)
+        add  dx, base        ; start address relative
         // 3. setup ptr
         les  di, ppcell
         mov  es:[di], dx
@@ -45,6 +56,8 @@ mda_cell_t* mda_as_pointer(const mda_point_t* point) {
 }
 
 void mda_plot(const mda_point_t* point, const mda_cell_t* cell) {
+    MDA_TRACE_CALL(MDA_TRACE_PLOT, point, 2, cell, 2, NULL, 0);
+    uint16_t base = mda_vram_base;
     __asm {
         .8086
         // 1. register setup (no flags used)
@@ -66,13 +79,17 @@ void mda_plot(const mda_point_t* point, const mda_cell_t* cell) {
         shl  di, 1
         add  di, ax          ; ax = y*80 + x
         shl  di, 1           ; word offset ES:DI *VRAM (x,y)
+        add  di, base        ; start address relative
         // 3. plot char:attribute
         lds  si, cell        ; DS:SI *cell
         movsw                ; *VRAM = *cell
     }
+    MDA_TRACE_LEAVE();
 }
 
 void mda_draw_hline(const mda_point_t* p0, const mda_point_t* p1, const mda_cell_t* cell) {
+    MDA_TRACE_CALL(MDA_TRACE_HLINE, p0, 2, p1, 2, cell, 2);
+    uint16_t base = mda_vram_base;
     __asm {
         .8086
         // 1. register & flag setup
@@ -101,6 +118,7 @@ void mda_draw_hline(const mda_point_t* p0, const mda_point_t* p1, const mda_cell
         shl  di, 1
         add  di, ax         ; ax = y*80 + x
         shl  di, 1          ; word offset ES:DI *VRAM (x,y)
+        add  di, base       ; start address relative
         // 3. setup cell
         lds  si, cell       ; DS:SI *cell
         lodsw               ; AX = char:attribute pair
@@ -109,9 +127,12 @@ void mda_draw_hline(const mda_point_t* p0, const mda_point_t* p1, const mda_cell
         rep stosw           ; draw hline
         popf                ; restore flags
     }
+    MDA_TRACE_LEAVE();
 }
 
 void mda_draw_vline(const mda_point_t* p0, const mda_point_t* p1, const mda_cell_t* cell) {
+    MDA_TRACE_CALL(MDA_TRACE_VLINE, p0, 2, p1, 2, cell, 2);
+    uint16_t base = mda_vram_base;
     __asm {
         .8086
         // 1. register & flag setup
@@ -141,6 +162,7 @@ void mda_draw_vline(const mda_point_t* p0, const mda_point_t* p1, const mda_cell
         shl  di, 1
         add  di, ax         ; ax = y*80 + x
         shl  di, 1          ; word offset ES:DI *VRAM (x,y)
+        add  di, base       ; start address relative
         // 3. setup cell
         lds  si, cell       ; DS:SI *cell
         lodsw               ; AX = char:attribute pair
@@ -150,9 +172,12 @@ NEXT:   mov es:[di], ax
         loop NEXT
         popf                ; restore flags
     }
+    MDA_TRACE_LEAVE();
 }
 
 void mda_draw_hline_caps(const mda_point_t* p0, const mda_point_t* p1, const mda_cell_t* cells) {
+    MDA_TRACE_CALL(MDA_TRACE_HLINE_CAPS, p0, 2, p1, 2, cells, 6);
+    uint16_t base = mda_vram_base;
     __asm {
         .8086
         pushf
@@ -182,6 +207,7 @@ void mda_draw_hline_caps(const mda_point_t* p0, const mda_point_t* p1, const mda
         shl  di, 1
         add  di, ax         ; ax = y*80 + x
         shl  di, 1          ; word offset ES:DI *VRAM (x,y)
+        add  di, base       ; start address relative
         // 3. setup cell
         lds  si, cells      ; DS:SI *cells list of chars lhs,line,rhs
         dec  cx
@@ -194,9 +220,12 @@ void mda_draw_hline_caps(const mda_point_t* p0, const mda_point_t* p1, const mda
 ONE:    movsw               ; *ES:DI++ = *DS:SI++ (RHS end cap char)
         popf                ; restore flags
     }
+    MDA_TRACE_LEAVE();
 }
 
 void mda_draw_vline_caps(const mda_point_t* p0, const mda_point_t* p1, const mda_cell_t* cells) {
+    MDA_TRACE_CALL(MDA_TRACE_VLINE_CAPS, p0, 2, p1, 2, cells, 6);
+    uint16_t base = mda_vram_base;
     __asm {
         .8086
         // 1. register & flag setup
@@ -226,6 +255,7 @@ void mda_draw_vline_caps(const mda_point_t* p0, const mda_point_t* p1, const mda
         shl  di, 1
         add  di, ax         ; ax = y*80 + x
         shl  di, 1          ; word offset ES:DI *VRAM (x,y)
+        add  di, base       ; start address relative
         // 3. setup cell
         lds  si, cells      ; DS:SI *cells
         dec  cx
@@ -244,9 +274,12 @@ ONE:    lodsw               ; AX = *DS:SI++
         mov es:[di], ax     ; AX = bottom end cap
         popf                ; restore flags
     }
+    MDA_TRACE_LEAVE();
 }
 
 void mda_draw_rect(const mda_rect_t* rect, const mda_cell_t* cell) {
+    MDA_TRACE_CALL(MDA_TRACE_DRAW_RECT, rect, 4, cell, 2, NULL, 0);
+    uint16_t base = mda_vram_base;
     __asm {
         .8086
         // 1. register & flag setup
@@ -275,6 +308,7 @@ void mda_draw_rect(const mda_rect_t* rect, const mda_cell_t* cell) {
         shl  di, 1
         add  di, ax         ; ax = y*80 + x
         shl  di, 1          ; word offset ES:DI *VRAM (x,y)
+        add  di, base       ; start address relative
         // 3. setup cell
         lds si, cell        ; DS:SI *cell
         lodsw               ; AX = char:attribute pair
@@ -301,9 +335,118 @@ NEXT:   mov es:[di], ax     ; lhs cell
         rep stosw           ; bottom line
         popf                ; restore flags
     }
+    MDA_TRACE_LEAVE();
+}
+
+#else
+
+/**
+ * @brief Host model cell at screen (x,y), addressed like the asm: base plus offset, no wrap.
+ */
+static mda_cell_t* host_cell(uint8_t x, uint8_t y) {
+    return mda_crtc_model.vram + mda_crtc_start() + y * MDA_COLUMNS + x;
+}
+
+mda_cell_t* mda_as_pointer(const mda_point_t* point) {
+    return host_cell(point->x, point->y);
+}
+
+void mda_plot(const mda_point_t* point, const mda_cell_t* cell) {
+    MDA_TRACE_CALL(MDA_TRACE_PLOT, point, 2, cell, 2, NULL, 0);
+    *host_cell(point->x, point->y) = *cell;
+    MDA_TRACE_LEAVE();
+}
+
+void mda_draw_hline(const mda_point_t* p0, const mda_point_t* p1, const mda_cell_t* cell) {
+    MDA_TRACE_CALL(MDA_TRACE_HLINE, p0, 2, p1, 2, cell, 2);
+    mda_cell_t* vram = host_cell(p0->x, p0->y);
+    for (uint8_t x = p0->x; x <= p1->x; ++x) {
+        *vram++ = *cell;
+    }
+    MDA_TRACE_LEAVE();
+}
+
+void mda_draw_vline(const mda_point_t* p0, const mda_point_t* p1, const mda_cell_t* cell) {
+    MDA_TRACE_CALL(MDA_TRACE_VLINE, p0, 2, p1, 2, cell, 2);
+    mda_cell_t* vram = host_cell(p0->x, p0->y);
+    for (uint8_t y = p0->y; y <= p1->y; ++y, vram += MDA_COLUMNS) {
+        *vram = *cell;
+    }
+    MDA_TRACE_LEAVE();
+}
+
+void mda_draw_hline_caps(const mda_point_t* p0, const mda_point_t* p1, const mda_cell_t* cells) {
+    MDA_TRACE_CALL(MDA_TRACE_HLINE_CAPS, p0, 2, p1, 2, cells, 6);
+    mda_cell_t* vram = host_cell(p0->x, p0->y);
+    uint8_t n = p1->x - p0->x + 1;
+    if (n == 1) {
+        *vram = cells[0];
+    }
+    else {
+        vram[0] = cells[0];
+        for (uint8_t i = 1; i < n - 1; ++i) {
+            vram[i] = cells[1];
+        }
+        vram[n - 1] = cells[2];
+    }
+    MDA_TRACE_LEAVE();
+}
+
+void mda_draw_vline_caps(const mda_point_t* p0, const mda_point_t* p1, const mda_cell_t* cells) {
+    MDA_TRACE_CALL(MDA_TRACE_VLINE_CAPS, p0, 2, p1, 2, cells, 6);
+    mda_cell_t* vram = host_cell(p0->x, p0->y);
+    uint8_t n = p1->y - p0->y + 1;
+    if (n == 1) {
+        *vram = cells[0];
+    }
+    else {
+        vram[0] = cells[0];
+        for (uint8_t i = 1; i < n - 1; ++i) {
+            vram[i * MDA_COLUMNS] = cells[1];
+        }
+        vram[(n - 1) * MDA_COLUMNS] = cells[2];
+    }
+    MDA_TRACE_LEAVE();
+}
+
+void mda_draw_rect(const mda_rect_t* rect, const mda_cell_t* cell) {
+    MDA_TRACE_CALL(MDA_TRACE_DRAW_RECT, rect, 4, cell, 2, NULL, 0);
+    mda_cell_t* top = host_cell(rect->x, rect->y);
+    mda_cell_t* bottom = top + (rect->h - 1) * MDA_COLUMNS;
+    for (uint8_t x = 0; x < rect->w; ++x) {
+        top[x] = bottom[x] = *cell;
+    }
+    for (uint8_t y = 1; y + 1 < rect->h; ++y) {
+        top[y * MDA_COLUMNS] = top[y * MDA_COLUMNS + rect->w - 1] = *cell;
+    }
+    MDA_TRACE_LEAVE();
+}
+
+#endif
+
+void mda_draw_border(const mda_rect_t* rect, const mda_cell_t* cells) {
+    MDA_TRACE_CALL(MDA_TRACE_DRAW_BORDER, rect, 4, cells, 16, NULL, 0);
+    // cells: TL, T, TR, L, R, BL, B, BR so each horizontal edge is one caps triple
+    mda_point_t p0 = mda_point_make(rect->x, rect->y);
+    mda_point_t p1 = mda_point_make(rect->x + rect->w - 1, rect->y);
+    mda_draw_hline_caps(&p0, &p1, &cells[0]);
+    p0.y = p1.y = rect->y + rect->h - 1;
+    mda_draw_hline_caps(&p0, &p1, &cells[5]);
+    if (rect->h > 2) {
+        p0.y = rect->y + 1;
+        p1.y = rect->y + rect->h - 2;
+        p1.x = p0.x;
+        mda_draw_vline(&p0, &p1, &cells[3]);
+        p0.x = p1.x = rect->x + rect->w - 1;
+        mda_draw_vline(&p0, &p1, &cells[4]);
+    }
+    MDA_TRACE_LEAVE();
 }
 
-void mda_fill_rect(const mda_rect_t* rect, const mda_cell_t* cell) {
+#ifdef __DOS__
+
+void mda_fill_rect_8086(const mda_rect_t* rect, const mda_cell_t* cell) {
+    uint16_t base = mda_vram_base;
     __asm {
         .8086
         // 1. register & flag setup
@@ -331,6 +474,7 @@ void mda_fill_rect(const mda_rect_t* rect, const mda_cell_t* cell) {
         shl  di, 1
         add  di, ax         ; ax = y*80 + x
         shl  di, 1          ; word offset ES:DI *VRAM (x,y)
+        add  di, base       ; start address relative
         lds si, cell        ; DS:SI *cell
         lodsw               ; AX = char:attribute pair
         // 3. setup cell
@@ -354,14 +498,91 @@ void mda_fill_rect(const mda_rect_t* rect, const mda_cell_t* cell) {
 
 // void mda_blit(mda_rect_t* to, mda_rect_t* from);
 
-void mda_fill_screen(const mda_cell_t* cell) {
+void mda_write_cells_8086(const mda_point_t* point, const mda_cell_t* cells, uint8_t count) {
+    uint16_t base = mda_vram_base;
+    __asm {
+        .8086
+        // 1. register & flag setup
+        pushf
+        cld                 ; inc str ops
+        mov ax, MDA_SEGMENT
+        mov es, ax          ; ES:DI *VRAM
+        lds si, point       ; DS:SI *point
+        lodsb               ; AL = x
+        xor ah, ah          ; AX = x
+        mov bl, ds:[si]     ; BL = y
+        xor bh, bh          ; BX = y
+        mov di, bx          ; DI copy y
+        mov cl, count       ; CL = count
+        xor ch, ch          ; CX = count
+        // 2. DI = y * 80
+        shl  di, 1          ; y * 4
+        shl  di, 1
+        add  di, bx         ; y * 5
+        shl  di, 1          ; y * 5 * 16
+        shl  di, 1
+        shl  di, 1
+        shl  di, 1
+        add  di, ax         ; ax = y*80 + x
+        shl  di, 1          ; word offset ES:DI *VRAM (x,y)
+        add  di, base       ; start address relative
+        // 3. copy run of cells
+        lds  si, cells      ; DS:SI *cells
+        rep  movsw          ; *ES:DI++ = *DS:SI++
+        popf                ; restore flags
+    }
+}
+
+void mda_write_attr(const mda_point_t* point, uint8_t attr, uint8_t count) {
+    MDA_TRACE_CALL(MDA_TRACE_WRITE_ATTR, point, 2, &attr, 1, &count, 1);
+    uint16_t base = mda_vram_base;
+    __asm {
+        .8086
+        // 1. register & flag setup
+        pushf
+        cld                 ; inc str ops
+        mov ax, MDA_SEGMENT
+        mov es, ax          ; ES:DI *VRAM
+        lds si, point       ; DS:SI *point
+        lodsb               ; AL = x
+        xor ah, ah          ; AX = x
+        mov bl, ds:[si]     ; BL = y
+        xor bh, bh          ; BX = y
+        mov di, bx          ; DI copy y
+        mov cl, count       ; CL = count
+        xor ch, ch          ; CX = count
+        // 2. DI = y * 80
+        shl  di, 1          ; y * 4
+        shl  di, 1
+        add  di, bx         ; y * 5
+        shl  di, 1          ; y * 5 * 16
+        shl  di, 1
+        shl  di, 1
+        shl  di, 1
+        add  di, ax         ; ax = y*80 + x
+        shl  di, 1          ; word offset ES:DI *VRAM (x,y)
+        add  di, base       ; start address relative
+        // 3. overwrite attribute bytes only
+        mov  al, attr       ; AL = attribute
+        jcxz DONE           ; nothing to do
+        inc  di             ; ES:DI *attribute byte
+NEXT:   stosb               ; *ES:DI++ = attribute
+        inc  di             ; skip character byte
+        loop NEXT
+DONE:   popf                ; restore flags
+    }
+    MDA_TRACE_LEAVE();
+}
+
+void mda_fill_screen_8086(const mda_cell_t* cell) {
+    uint16_t base = mda_vram_base;
     __asm {
         // 1. register & flag setup
         pushf
         cld                 ; inc str ops
         mov ax, MDA_SEGMENT
         mov es, ax          ; ES:DI *VRAM
-        xor di, di
+        mov di, base        ; ES:DI *VRAM displayed (0,0)
         lds si, cell        ; DS:SI *rect
         lodsw               ; AX = attribut:char pair
         mov cx, MDA_SCREEN_WORDS
@@ -370,17 +591,53 @@ void mda_fill_screen(const mda_cell_t* cell) {
     }
 }
 
-void mda_save_screen(const FILE* f) {
+#else
+
+void mda_fill_rect_8086(const mda_rect_t* rect, const mda_cell_t* cell) {
+    mda_cell_t* vram = host_cell(rect->x, rect->y);
+    for (uint8_t y = 0; y < rect->h; ++y, vram += MDA_COLUMNS) {
+        for (uint8_t x = 0; x < rect->w; ++x) {
+            vram[x] = *cell;
+        }
+    }
+}
+
+void mda_write_cells_8086(const mda_point_t* point, const mda_cell_t* cells, uint8_t count) {
+    memcpy(host_cell(point->x, point->y), cells, count * sizeof(mda_cell_t));
+}
+
+void mda_write_attr(const mda_point_t* point, uint8_t attr, uint8_t count) {
+    MDA_TRACE_CALL(MDA_TRACE_WRITE_ATTR, point, 2, &attr, 1, &count, 1);
+    mda_cell_t* vram = host_cell(point->x, point->y);
+    for (uint8_t i = 0; i < count; ++i) {
+        vram[i].attr = attr;
+    }
+    MDA_TRACE_LEAVE();
+}
+
+void mda_fill_screen_8086(const mda_cell_t* cell) {
+    mda_cell_t* vram = host_cell(0, 0);
+    for (uint16_t i = 0; i < MDA_SCREEN_WORDS; ++i) {
+        vram[i] = *cell;
+    }
+}
+
+#endif
+
+void mda_save_screen(FILE* f) {
     require_fd(f, "NULL file pointer!");
-    ensure(fwrite(MDA_VRAM_PTR, sizeof(char), MDA_SCREEN_BYTES, f) == MDA_SCREEN_BYTES, "FAIL to write!");
+    mda_point_t origin = mda_point_make(0, 0);
+    ensure(fwrite(mda_as_pointer(&origin), sizeof(char), MDA_SCREEN_BYTES, f) == MDA_SCREEN_BYTES, "FAIL to write!");
 }
 
-void mda_load_screen(const FILE* f) {
+void mda_load_screen(FILE* f) {
     require_fd(f, "NULL file pointer!");
-    ensure(fread(MDA_VRAM_PTR, sizeof(char), MDA_SCREEN_BYTES, f) == MDA_SCREEN_BYTES, "FAIL to read!");
+    mda_point_t origin = mda_point_make(0, 0);
+    ensure(fread(mda_as_pointer(&origin), sizeof(char), MDA_SCREEN_BYTES, f) == MDA_SCREEN_BYTES, "FAIL to read!");
+    MDA_TRACE_LOADED(NULL);    // the whole screen
 }
 
-void mda_save_rect(const FILE* f, const mda_rect_t* rect) {
+void mda_save_rect(FILE* f, const mda_rect_t* rect) {
     require_fd(f, "NULL file pointer!");
     mda_cell_t* vram = mda_as_pointer(&rect->origin);
     for (int y = 0; y < rect->h; y++) {
@@ -389,16 +646,20 @@ void mda_save_rect(const FILE* f, const mda_rect_t* rect) {
     }
 }
 
-void mda_load_rect(const FILE* f, const mda_rect_t* rect) {
+void mda_load_rect(FILE* f, const mda_rect_t* rect) {
     require_fd(f, "NULL file pointer!");
     mda_cell_t* vram = mda_as_pointer(&rect->origin);
     for (int y = 0; y < rect->h; y++) {
         ensure(fread(vram, sizeof(mda_cell_t), rect->w, f) == rect->w, "FAIL to read!");
         vram += MDA_ROW_WORDS;
     }
+    MDA_TRACE_LOADED(rect);
 }
 
-void mda_scroll_up(const mda_rect_t* rect, const mda_cell_t* blank) {
+#ifdef __DOS__
+
+void mda_scroll_up_8086(const mda_rect_t* rect, const mda_cell_t* blank) {
+    uint16_t base = mda_vram_base;
     __asm {
         .8086
         // 1. register & flag setup
@@ -426,6 +687,7 @@ void mda_scroll_up(const mda_rect_t* rect, const mda_cell_t* blank) {
         shl  di, 1
         add  di, ax         ; ax = y*80 + x
         shl  di, 1          ; word offset ES:DI *VRAM (x,y)
+        add  di, base       ; start address relative
         // 3. register setup
         mov  ax, MDA_SEGMENT
         mov  ds, ax
@@ -450,7 +712,8 @@ NEXT:   rep  movsw          ; copy row cells upwards left to right
     }
 }
 
-void mda_scroll_down(const mda_rect_t* rect, const mda_cell_t* blank) {
+void mda_scroll_down_8086(const mda_rect_t* rect, const mda_cell_t* blank) {
+    uint16_t base = mda_vram_base;
     __asm {
         .8086
         // 1. register & flag setup
@@ -481,6 +744,7 @@ void mda_scroll_down(const mda_rect_t* rect, const mda_cell_t* blank) {
         shl  di, 1
         add  di, ax         ; ax = y*80 + x
         shl  di, 1          ; word offset ES:DI *VRAM (x,y)
+        add  di, base       ; start address relative
         // 3. register setup
         mov  ax, MDA_SEGMENT
         mov  ds, ax
@@ -507,6 +771,8 @@ NEXT:   rep  movsw          ; copy row cells downwards right to left
 }
 
 void mda_scroll_left(const mda_rect_t* rect, const mda_cell_t* blank) {
+    MDA_TRACE_CALL(MDA_TRACE_SCROLL_LEFT, rect, 4, blank, 2, NULL, 0);
+    uint16_t base = mda_vram_base;
     __asm {
         .8086
         // 1. register & flag setup
@@ -533,6 +799,7 @@ void mda_scroll_left(const mda_rect_t* rect, const mda_cell_t* blank) {
         shl  di, 1
         add  di, ax         ; ax = y*80 + x
         shl  di, 1          ; word offset ES:DI *VRAM (x,y)
+        add  di, base       ; start address relative
         // 3. register setup
         lds  si, blank      ; DS:SI* blank
         mov  bx, ds:[si]    ; BX = blank char:attr
@@ -558,9 +825,12 @@ NEXT:   rep  movsw          ; copy row cells left
         pop bp              ; restore BP
         popf                ; restore flags
     }
+    MDA_TRACE_LEAVE();
 }
 
 void mda_scroll_right(const mda_rect_t* rect, const mda_cell_t* blank) {
+    MDA_TRACE_CALL(MDA_TRACE_SCROLL_RIGHT, rect, 4, blank, 2, NULL, 0);
+    uint16_t base = mda_vram_base;
     __asm {
         .8086
         // 1. register & flag setup
@@ -591,6 +861,7 @@ void mda_scroll_right(const mda_rect_t* rect, const mda_cell_t* blank) {
         shl  di, 1
         add  di, ax         ; ax = y*80 + x
         shl  di, 1          ; word offset ES:DI *VRAM (x,y)
+        add  di, base       ; start address relative
         // 3. register setup
         lds  si, blank      ; DS:SI* blank
         mov  bx, ds:[si]    ; BX = blank char:attr
@@ -616,4 +887,49 @@ NEXT:   rep  movsw          ; copy row cells right
         pop bp              ; restore BP
         popf                ; restore flags
     }
+    MDA_TRACE_LEAVE();
+}
+
+#else
+
+void mda_scroll_up_8086(const mda_rect_t* rect, const mda_cell_t* blank) {
+    mda_cell_t* vram = host_cell(rect->x, rect->y);
+    for (uint8_t y = 1; y < rect->h; ++y, vram += MDA_COLUMNS) {
+        memcpy(vram, vram + MDA_COLUMNS, rect->w * sizeof(mda_cell_t));
+    }
+    for (uint8_t x = 0; x < rect->w; ++x) {
+        vram[x] = *blank;
+    }
+}
+
+void mda_scroll_down_8086(const mda_rect_t* rect, const mda_cell_t* blank) {
+    mda_cell_t* vram = host_cell(rect->x, rect->y + rect->h - 1);
+    for (uint8_t y = 1; y < rect->h; ++y, vram -= MDA_COLUMNS) {
+        memcpy(vram, vram - MDA_COLUMNS, rect->w * sizeof(mda_cell_t));
+    }
+    for (uint8_t x = 0; x < rect->w; ++x) {
+        vram[x] = *blank;
+    }
+}
+
+void mda_scroll_left(const mda_rect_t* rect, const mda_cell_t* blank) {
+    MDA_TRACE_CALL(MDA_TRACE_SCROLL_LEFT, rect, 4, blank, 2, NULL, 0);
+    mda_cell_t* vram = host_cell(rect->x, rect->y);
+    for (uint8_t y = 0; y < rect->h; ++y, vram += MDA_COLUMNS) {
+        memmove(vram, vram + 1, (rect->w - 1) * sizeof(mda_cell_t));
+        vram[rect->w - 1] = *blank;
+    }
+    MDA_TRACE_LEAVE();
+}
+
+void mda_scroll_right(const mda_rect_t* rect, const mda_cell_t* blank) {
+    MDA_TRACE_CALL(MDA_TRACE_SCROLL_RIGHT, rect, 4, blank, 2, NULL, 0);
+    mda_cell_t* vram = host_cell(rect->x, rect->y);
+    for (uint8_t y = 0; y < rect->h; ++y, vram += MDA_COLUMNS) {
+        memmove(vram + 1, vram, (rect->w - 1) * sizeof(mda_cell_t));
+        vram[0] = *blank;
+    }
+    MDA_TRACE_LEAVE();
 }
+
+#endif
@@ -39,16 +39,33 @@ void mda_draw_rect(const mda_rect_t* rect, const mda_cell_t* cell);
 
 void mda_fill_rect(const mda_rect_t* rect, const mda_cell_t* cell);
 
+/**
+ * @brief Outline a rectangle (at least 2x2) with distinct corner and edge cells.
+ * @param cells 8 cells: top left, top, top right, left, right, bottom left, bottom, bottom right.
+ * @see mda_border_cells() for CP437 line style sets, mda_border.h for merged junctions.
+ */
 void mda_draw_border(const mda_rect_t* rect, const mda_cell_t* cells);
 
 void mda_blit(const mda_rect_t* to, const mda_rect_t* from);
 ///@}
 
+/**
+ * @defgroup run_ops Cell Run Operations
+ * @brief Batched writes of a horizontal run of cells within one row.
+ * @note Callers compose a row once in a cell buffer and commit it with a
+ *       single `rep movsw`, rather than plotting or printing per cell.
+ * @{
+ */
+void mda_write_cells(const mda_point_t* point, const mda_cell_t* cells, uint8_t count); ///< Copy count cells to VRAM starting at point
+
+void mda_write_attr(const mda_point_t* point, uint8_t attr, uint8_t count);              ///< Rewrite only the attribute bytes of count cells
+///@}
+
 void mda_fill_screen(const mda_cell_t* cell);
 
-void mda_load_screen(const FILE* f);
+void mda_load_screen(FILE* f);
 
-void mda_save_screen(const FILE* f);
+void mda_save_screen(FILE* f);
 
 static inline void mda_clear_rect(const mda_rect_t* rect) {
     mda_cell_t cell = mda_cell_make('\0', MDA_NORMAL);
@@ -67,7 +84,7 @@ static inline void mda_clear_screen(void) {
  * @note Format: consecutive cell_t pairs (char + attr) in row-major order.
  * @note Caller must ensure file is opened in binary mode.
  */
-void mda_save_rect(const FILE* f, const mda_rect_t* rect);
+void mda_save_rect(FILE* f, const mda_rect_t* rect);
 
 /**
  * @brief Load contents from a binary stream into a rectangle.
@@ -77,7 +94,7 @@ void mda_save_rect(const FILE* f, const mda_rect_t* rect);
  * @note Caller must ensure stream contains valid data of correct size.
  * @warning No bounds checking on input — use with trusted sources.
  */
-void mda_load_rect(const FILE* f, const mda_rect_t* rect);
+void mda_load_rect(FILE* f, const mda_rect_t* rect);
 
 
 /**
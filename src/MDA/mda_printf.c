@@ -0,0 +1,249 @@
+/**
+ * @file mda_printf.c
+ * @brief Implementation of Direct-to-Cells Formatted Output
+ * @details Each conversion is measured first (sign, digits, point) so the
+ * padding can be emitted in place; digits are generated least significant
+ * first into a 10 byte stack and popped straight into cells.
+ * @author Jeremy Thornton
+ */
+#include "mda_printf.h"
+#include "mda_primitives.h"
+#include "../CONTRACT/contract.h"
+#include <stdbool.h>
+
+#define FORMAT_DIGITS   10  // digits of 2^32 - 1
+
+static const char format_hex[2][16] = {
+    { '0','1','2','3','4','5','6','7','8','9','a','b','c','d','e','f' },
+    { '0','1','2','3','4','5','6','7','8','9','A','B','C','D','E','F' }
+};
+
+/**
+ * @struct format_out_t
+ * @brief Output cursor over the destination field.
+ */
+typedef struct {
+    mda_cell_t* cell;   /**< Next cell */
+    mda_cell_t* end;    /**< One past the field */
+    uint16_t attr;      /**< Attribute, pre-shifted to the high byte */
+} format_out_t;
+
+static void format_put(format_out_t* out, char c) {
+    if (out->cell < out->end) {
+        (out->cell++)->packed = out->attr | (uint8_t)c;
+    }
+}
+
+static void format_repeat(format_out_t* out, char c, int16_t n) {
+    while (n-- > 0) {
+        format_put(out, c);
+    }
+}
+
+/**
+ * @brief Push the digits of value in base 10 or 16, least significant first.
+ * @return Number of digits (at least 1).
+ */
+static uint8_t format_digits(char* stack, uint32_t value, bool hex, bool upper) {
+    uint8_t n = 0;
+    if (hex) {
+        const char* table = format_hex[upper];
+        do {
+            stack[n++] = table[(uint8_t)value & 0x0F];
+            value >>= 4;
+        } while (value != 0);
+        return n;
+    }
+    while (value > 0xFFFF) {    // 32-bit division only while it is needed
+        stack[n++] = '0' + (char)(value % 10);
+        value /= 10;
+    }
+    uint16_t v = (uint16_t)value;
+    do {
+        stack[n++] = '0' + (char)(v % 10);
+        v /= 10;
+    } while (v != 0);
+    return n;
+}
+
+/**
+ * @brief Emit one padded numeric conversion.
+ * @param point Digits after the decimal point (0 = no point).
+ */
+static void format_number(format_out_t* out, uint32_t magnitude, char sign, bool hex, bool upper,
+                          uint8_t width, int16_t precision, uint8_t point, bool left, bool zero) {
+    char stack[FORMAT_DIGITS];
+    uint8_t n = format_digits(stack, magnitude, hex, upper);
+    int16_t digits = n;
+    if (precision > digits) {       // minimum digits
+        digits = precision;
+    }
+    int16_t len = digits + (sign != 0) + (point != 0);
+    int16_t pad = width - len;
+    if (!left && !zero) {
+        format_repeat(out, ' ', pad);
+    }
+    if (sign) {
+        format_put(out, sign);
+    }
+    if (!left && zero) {
+        format_repeat(out, '0', pad);
+    }
+    for (int16_t k = digits; k > 0; --k) {  // k = digits still to emit
+        if (point && k == point) {
+            format_put(out, '.');
+        }
+        format_put(out, (k > n) ? '0' : stack[k - 1]);
+    }
+    if (left) {
+        format_repeat(out, ' ', pad);
+    }
+}
+
+uint8_t mda_vformat(mda_cell_t* dst, uint8_t width, uint8_t attr, const char* fmt, va_list args) {
+    require_address(dst, "NULL destination!");
+    require_address(fmt, "NULL format!");
+    format_out_t out;
+    out.cell = dst;
+    out.end = dst + width;
+    out.attr = (uint16_t)attr << 8;
+    char c;
+    while ((c = *fmt++) != '\0' && out.cell < out.end) {
+        if (c != '%') {
+            format_put(&out, c);
+            continue;
+        }
+        bool left = false;
+        bool zero = false;
+        bool plus = false;
+        for (;; ++fmt) {            // flags
+            if (*fmt == '-') {
+                left = true;
+            }
+            else if (*fmt == '0') {
+                zero = true;
+            }
+            else if (*fmt == '+') {
+                plus = true;
+            }
+            else {
+                break;
+            }
+        }
+        uint8_t field = 0;
+        while (*fmt >= '0' && *fmt <= '9') {
+            field = field * 10 + (*fmt++ - '0');
+        }
+        int16_t precision = -1;
+        if (*fmt == '.') {
+            precision = 0;
+            while (*++fmt >= '0' && *fmt <= '9') {
+                precision = precision * 10 + (*fmt - '0');
+            }
+        }
+        bool wide = false;
+        if (*fmt == 'l') {
+            wide = true;
+            fmt++;
+        }
+        int32_t value;
+        uint32_t magnitude;
+        char sign = 0;
+        switch (c = *fmt++) {
+            case 'd':
+            case 'i':
+            case 'F':
+                value = wide ? va_arg(args, long) : va_arg(args, int);
+                magnitude = (value < 0) ? (uint32_t)0 - (uint32_t)value : (uint32_t)value;
+                if (value < 0) {
+                    sign = '-';
+                }
+                else if (plus) {
+                    sign = '+';
+                }
+                if (c == 'F') {     // fixed point: precision = places after the point
+                    uint8_t places = (precision < 0) ? 2 : (uint8_t)precision;
+                    if (places > FORMAT_DIGITS - 1) {
+                        places = FORMAT_DIGITS - 1;
+                    }
+                    format_number(&out, magnitude, sign, false, false, field, places + 1, places, left, zero);
+                }
+                else {
+                    format_number(&out, magnitude, sign, false, false, field, precision, 0, left, zero);
+                }
+                break;
+            case 'u':
+            case 'x':
+            case 'X':
+                magnitude = wide ? va_arg(args, unsigned long) : va_arg(args, unsigned int);
+                format_number(&out, magnitude, 0, c != 'u', c == 'X', field, precision, 0, left, zero);
+                break;
+            case 's': {
+                const char* s = va_arg(args, const char*);
+                int16_t len = 0;
+                while (s[len] != '\0' && (precision < 0 || len < precision)) {
+                    len++;
+                }
+                if (!left) {
+                    format_repeat(&out, ' ', field - len);
+                }
+                for (int16_t i = 0; i < len; ++i) {
+                    format_put(&out, s[i]);
+                }
+                if (left) {
+                    format_repeat(&out, ' ', field - len);
+                }
+                break;
+            }
+            case 'c':
+                if (!left) {
+                    format_repeat(&out, ' ', field - 1);
+                }
+                format_put(&out, (char)va_arg(args, int));
+                if (left) {
+                    format_repeat(&out, ' ', field - 1);
+                }
+                break;
+            case '\0':              // dangling '%'
+                return (uint8_t)(out.cell - dst);
+            default:                // '%' and unknown conversions print as is
+                format_put(&out, c);
+                break;
+        }
+    }
+    return (uint8_t)(out.cell - dst);
+}
+
+uint8_t mda_format(mda_cell_t* dst, uint8_t width, uint8_t attr, const char* fmt, ...) {
+    va_list args;
+    va_start(args, fmt);
+    uint8_t n = mda_vformat(dst, width, attr, fmt, args);
+    va_end(args);
+    return n;
+}
+
+void mda_printf_at(const mda_point_t* point, uint8_t width, uint8_t attr, const char* fmt, ...) {
+    require_address(point, "NULL point!");
+    mda_cell_t* vram = mda_as_pointer(point);
+    va_list args;
+    va_start(args, fmt);
+    uint8_t n = mda_vformat(vram, width, attr, fmt, args);
+    va_end(args);
+    uint16_t blank = (uint16_t)attr << 8 | ' ';
+    for (vram += n; n < width; ++n) {    // clear what the previous value left
+        (vram++)->packed = blank;
+    }
+}
+
+uint8_t mda_printf(mda_context_t* ctx, const char* fmt, ...) {
+    require_address(ctx, "NULL context!");
+    mda_point_t p = mda_point_make(ctx->cursor.column, ctx->cursor.row);
+    uint8_t room = ctx->bounds.x + ctx->bounds.w - p.x;
+    va_list args;
+    va_start(args, fmt);
+    uint8_t n = mda_vformat(mda_as_pointer(&p), room, ctx->attributes, fmt, args);
+    va_end(args);
+    p.x += (n < room) ? n : room - 1;   // stay on the last column when the row is full
+    mda_cursor_to(ctx, &p);
+    return n;
+}
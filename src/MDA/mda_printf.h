@@ -0,0 +1,60 @@
+/**
+ * @file mda_printf.h
+ * @brief Direct-to-Cells Formatted Output
+ * @details A printf-style formatter that writes character:attribute cells
+ * straight into their destination — VRAM, a surface row or any cell
+ * buffer — with no intermediate string, no heap and no stdio. Output is
+ * confined to a field of fixed width: longer output is truncated and
+ * mda_printf_at() blanks the unused tail so a shrinking value never leaves
+ * stale digits behind.
+ *
+ * Conversion spec: %[flags][width][.precision][l]conv
+ * - flags: '-' left align, '0' zero pad, '+' always show the sign
+ * - l:     the argument is long (32 bits) rather than int
+ * - d, i:  signed decimal (precision = minimum digits)
+ * - u:     unsigned decimal
+ * - x, X:  unsigned hexadecimal, lower / upper case
+ * - F:     signed fixed point: the integer argument is scaled by
+ *          10^precision (default 2), e.g. %.2F of 12345 prints 123.45
+ * - s:     string (precision = maximum characters)
+ * - c:     character
+ * - %:     a literal '%'
+ *
+ * Integers are converted with 16-bit division whenever the value fits,
+ * as 32-bit division is a library call on the 8086.
+ *
+ * @author Jeremy Thornton
+ */
+#ifndef MDA_PRINTF_H
+#define MDA_PRINTF_H
+
+#include "mda_cell.h"
+#include "mda_context.h"
+#include "mda_types.h"
+#include <stdarg.h>
+#include <stdint.h>
+
+/**
+ * @brief Format into a cell buffer.
+ * @param dst   Destination cells (VRAM, surface row, buffer).
+ * @param width Field width: at most this many cells are written.
+ * @param attr  Attribute of every cell written.
+ * @return Number of cells written.
+ */
+uint8_t mda_vformat(mda_cell_t* dst, uint8_t width, uint8_t attr, const char* fmt, va_list args);
+uint8_t mda_format(mda_cell_t* dst, uint8_t width, uint8_t attr, const char* fmt, ...);
+
+/**
+ * @brief Format into the width cell field of VRAM at point, blanking the rest of the field.
+ * @note Unbounded like the primitives — caller must clip the field.
+ */
+void mda_printf_at(const mda_point_t* point, uint8_t width, uint8_t attr, const char* fmt, ...);
+
+/**
+ * @brief Format at the context cursor, up to the right edge of its bounds,
+ *        in the context attribute; the cursor moves past the output.
+ * @return Number of cells written.
+ */
+uint8_t mda_printf(mda_context_t* ctx, const char* fmt, ...);
+
+#endif /* MDA_PRINTF_H */
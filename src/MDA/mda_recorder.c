@@ -0,0 +1,169 @@
+/**
+ * @file mda_recorder.c
+ * @brief Implementation of the Screen Session Recorder
+ * @details A delta is built in a static payload buffer so its length is
+ * known before the record header is written. Spans stay within a row and
+ * bridge single unchanged cells, which cost less to repeat (2 bytes) than
+ * a new span header (3 bytes).
+ * @author Jeremy Thornton
+ */
+#include "mda_recorder.h"
+#include "mda_clock.h"
+#include "mda_primitives.h"
+#include "../CONTRACT/contract.h"
+#include <string.h>
+
+static uint8_t record_payload[MDA_SCREEN_BYTES];
+
+/**
+ * @brief Append n bytes to the write buffer, flushing when it fills.
+ */
+static void record_write(mda_recorder_t* rec, const void* data, uint16_t n) {
+    if (rec->failed) {
+        return;
+    }
+    if (rec->used + n > rec->size && !mda_recorder_flush(rec)) {
+        return;
+    }
+    if (n > rec->size) {                        // larger than the buffer: write it through
+        rec->failed |= fwrite(data, 1, n, rec->file) != n;
+    }
+    else {
+        memcpy(rec->buffer + rec->used, data, n);
+        rec->used += n;
+    }
+    rec->bytes += n;
+}
+
+/**
+ * @brief Append a record: header then payload.
+ */
+static void record_emit(mda_recorder_t* rec, uint8_t tag, const void* payload, uint16_t length) {
+    uint32_t time = mda_clock_ms() - rec->start;
+    uint8_t header[MDA_RECORD_HEADER];
+    header[0] = tag;
+    header[1] = (uint8_t)time;
+    header[2] = (uint8_t)(time >> 8);
+    header[3] = (uint8_t)(time >> 16);
+    header[4] = (uint8_t)(time >> 24);
+    header[5] = (uint8_t)length;
+    header[6] = (uint8_t)(length >> 8);
+    record_write(rec, header, MDA_RECORD_HEADER);
+    record_write(rec, payload, length);
+}
+
+/**
+ * @brief Copy the whole screen into the shadow and append it as a keyframe.
+ */
+static void record_keyframe(mda_recorder_t* rec) {
+    mda_point_t p = mda_point_make(0, 0);
+    for (; p.y < MDA_ROWS; ++p.y) {
+        memcpy(rec->shadow + p.y * MDA_COLUMNS, mda_as_pointer(&p), MDA_ROW_BYTES);
+    }
+    record_emit(rec, MDA_RECORD_KEYFRAME, rec->shadow, MDA_SCREEN_BYTES);
+    rec->since_key = 0;
+}
+
+/**
+ * @brief Encode the changed spans of the masked rows into record_payload.
+ * @return Payload length, or MDA_SCREEN_BYTES if a keyframe would be smaller.
+ */
+static uint16_t record_delta(mda_recorder_t* rec, uint32_t rows) {
+    uint16_t length = 0;
+    mda_point_t p = mda_point_make(0, 0);
+    for (; p.y < MDA_ROWS; ++p.y, rows >>= 1) {
+        if (!(rows & 1)) {
+            continue;
+        }
+        const mda_cell_t* screen = mda_as_pointer(&p);
+        mda_cell_t* shadow = rec->shadow + p.y * MDA_COLUMNS;
+        if (memcmp(screen, shadow, MDA_ROW_BYTES) == 0) {
+            continue;
+        }
+        uint8_t x = 0;
+        while (x < MDA_COLUMNS) {
+            if (screen[x].packed == shadow[x].packed) {
+                x++;
+                continue;
+            }
+            uint8_t start = x++;
+            while (x < MDA_COLUMNS && (screen[x].packed != shadow[x].packed
+                   || (x + 1 < MDA_COLUMNS && screen[x + 1].packed != shadow[x + 1].packed))) {
+                x++;
+            }
+            uint8_t count = x - start;
+            uint16_t offset = p.y * MDA_COLUMNS + start;
+            if (length + MDA_RECORD_SPAN + count * 2 >= MDA_SCREEN_BYTES) {
+                return MDA_SCREEN_BYTES;
+            }
+            record_payload[length++] = (uint8_t)offset;
+            record_payload[length++] = (uint8_t)(offset >> 8);
+            record_payload[length++] = count;
+            memcpy(record_payload + length, screen + start, count * 2);
+            length += count * 2;
+        }
+        memcpy(shadow, screen, MDA_ROW_BYTES);
+    }
+    return length;
+}
+
+bool mda_recorder_open(mda_recorder_t* rec, const char* path, uint8_t* buffer, uint16_t size) {
+    require_address(rec, "NULL recorder!");
+    require_address(path, "NULL path!");
+    require_address(buffer, "NULL buffer!");
+    require(size >= MDA_RECORD_HEADER, "INVALID buffer size!");
+    rec->file = fopen(path, "ab");
+    if (rec->file == NULL) {
+        return false;
+    }
+    rec->buffer = buffer;
+    rec->size = size;
+    rec->used = 0;
+    rec->since_key = MDA_RECORD_KEY_INTERVAL;   // the session starts with a keyframe
+    rec->start = mda_clock_ms();
+    rec->frames = 0;
+    rec->bytes = 0;
+    rec->failed = false;
+    fseek(rec->file, 0, SEEK_END);
+    if (ftell(rec->file) == 0) {
+        uint8_t header[MDA_RECORD_FILE_HEADER] = { 'M', 'D', 'A', 'R', MDA_RECORD_VERSION, MDA_COLUMNS, MDA_ROWS };
+        record_write(rec, header, MDA_RECORD_FILE_HEADER);
+    }
+    return true;
+}
+
+void mda_recorder_frame(mda_recorder_t* rec, uint32_t rows) {
+    require_address(rec, "NULL recorder!");
+    if (rec->failed) {
+        return;
+    }
+    rec->frames++;
+    if (rec->since_key++ >= MDA_RECORD_KEY_INTERVAL) {
+        record_keyframe(rec);
+        return;
+    }
+    uint16_t length = record_delta(rec, rows);
+    if (length == MDA_SCREEN_BYTES) {
+        record_keyframe(rec);
+    }
+    else if (length > 0) {                      // an unchanged frame costs nothing
+        record_emit(rec, MDA_RECORD_DELTA, record_payload, length);
+    }
+}
+
+bool mda_recorder_flush(mda_recorder_t* rec) {
+    require_address(rec, "NULL recorder!");
+    if (rec->used > 0 && !rec->failed) {
+        rec->failed = fwrite(rec->buffer, 1, rec->used, rec->file) != rec->used;
+    }
+    rec->used = 0;
+    return !rec->failed;
+}
+
+bool mda_recorder_close(mda_recorder_t* rec) {
+    require_address(rec, "NULL recorder!");
+    mda_recorder_flush(rec);
+    rec->failed |= fclose(rec->file) != 0;
+    rec->file = NULL;
+    return !rec->failed;
+}
@@ -0,0 +1,91 @@
+/**
+ * @file mda_recorder.h
+ * @brief Screen Session Recorder
+ * @details Records what the screen showed, frame by frame, for replay
+ * with mda_player.h. Call mda_recorder_frame() after each present; it
+ * compares the screen with a shadow copy of the previous frame and appends
+ * only the changed spans, stamped with mda_clock_ms().
+ *
+ * The cost per frame is one memcmp() per row that may have changed plus a
+ * copy of the spans that did; callers that know which rows they touched
+ * pass a row mask and the other rows are not even compared. Records go
+ * through a caller supplied write buffer, so the file is written in large
+ * blocks rather than once per frame.
+ *
+ * File format (little endian): a header, then records appended in order.
+ * - header:  "MDAR", version, columns, rows
+ * - record:  tag, time (ms, 32 bits), payload length (16 bits), payload
+ * - MDA_RECORD_KEYFRAME payload: every cell of the screen
+ * - MDA_RECORD_DELTA payload: spans of offset (16 bits), count, cells
+ * Cells are stored as character, attribute. A keyframe is written every
+ * MDA_RECORD_KEY_INTERVAL frames, and whenever a delta would be larger,
+ * so the player can seek without replaying from the start.
+ *
+ * Opening an existing recording appends a new session; it starts with a
+ * keyframe and its times restart from 0.
+ *
+ * @note mda_clock_init() must have been called.
+ * @author Jeremy Thornton
+ */
+#ifndef MDA_RECORDER_H
+#define MDA_RECORDER_H
+
+#include "mda_cell.h"
+#include "mda_constants.h"
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#define MDA_RECORD_MAGIC            "MDAR"
+#define MDA_RECORD_VERSION          1
+#define MDA_RECORD_FILE_HEADER      7           /**< Bytes: magic, version, columns, rows */
+#define MDA_RECORD_HEADER           7           /**< Bytes: tag, time, length */
+#define MDA_RECORD_KEYFRAME         'K'         /**< Record tag: the whole screen */
+#define MDA_RECORD_DELTA            'D'         /**< Record tag: changed spans */
+#define MDA_RECORD_SPAN             3           /**< Bytes of a span header: offset, count */
+#define MDA_RECORD_KEY_INTERVAL     64          /**< Frames between keyframes */
+#define MDA_RECORD_ALL_ROWS         0x01FFFFFFUL /**< Row mask covering the screen */
+
+/**
+ * @struct mda_recorder_t
+ * @brief Output file, write buffer and previous frame of one recording.
+ */
+typedef struct {
+    FILE* file;                             /**< Recording, opened for append */
+    uint8_t* buffer;                        /**< Caller supplied write buffer */
+    uint16_t size;                          /**< Bytes in buffer */
+    uint16_t used;                          /**< Bytes waiting to be written */
+    mda_cell_t shadow[MDA_SCREEN_WORDS];    /**< Screen as last recorded */
+    uint16_t since_key;                     /**< Frames since the last keyframe */
+    uint32_t start;                         /**< Clock at open */
+    uint32_t frames;                        /**< Frames recorded */
+    uint32_t bytes;                         /**< Bytes recorded */
+    bool failed;                            /**< A write failed; recording stopped */
+} mda_recorder_t;
+
+/**
+ * @brief Open or create a recording and start a session.
+ * @param buffer Write buffer; a few KB keeps disk writes infrequent.
+ * @return false if the file cannot be opened.
+ */
+bool mda_recorder_open(mda_recorder_t* rec, const char* path, uint8_t* buffer, uint16_t size);
+
+/**
+ * @brief Record the screen as presented.
+ * @param rows Bit y set if row y may have changed; MDA_RECORD_ALL_ROWS when unknown.
+ */
+void mda_recorder_frame(mda_recorder_t* rec, uint32_t rows);
+
+/**
+ * @brief Write out buffered records.
+ * @return false if any write has failed.
+ */
+bool mda_recorder_flush(mda_recorder_t* rec);
+
+/**
+ * @brief Flush and close the recording.
+ * @return false if any write has failed.
+ */
+bool mda_recorder_close(mda_recorder_t* rec);
+
+#endif /* MDA_RECORDER_H */
@@ -0,0 +1,577 @@
+/**
+ * @file mda_remote.c
+ * @brief Implementation of Remote Console Mirroring
+ * @details Spans are encoded straight into the free end of the queue, one
+ * cell at a time, and the shadow is updated only for the cells that fitted.
+ * A VT100 span bridges up to REMOTE_VT100_BRIDGE unchanged cells, which
+ * cost less to repeat than a cursor move; a binary span bridges one, as in
+ * the recorder. The far end cursor is tracked so a span that continues
+ * where the last one ended needs no cursor move.
+ * @author Jeremy Thornton
+ */
+#include "mda_remote.h"
+#include "mda_clock.h"
+#include "mda_primitives.h"
+#include "../CONTRACT/contract.h"
+#include <string.h>
+
+#define REMOTE_VT100_BRIDGE     4       /**< Unchanged cells a VT100 span may include */
+#define REMOTE_CUP_MAX          8       /**< ESC [ 25 ; 80 H */
+#define REMOTE_SGR_MAX          12      /**< ESC [ 0 ; 1 ; 4 ; 5 ; 7 m */
+#define REMOTE_UNKNOWN          0xFF    /**< SGR state not known */
+#define REMOTE_QUEUE_MIN        64
+
+#define REMOTE_SGR_BOLD         0x01
+#define REMOTE_SGR_UNDERLINE    0x02
+#define REMOTE_SGR_BLINK        0x04
+#define REMOTE_SGR_REVERSE      0x08
+#define REMOTE_SGR_CONCEAL      0x10
+
+/**
+ * @brief Unicode code point of each CP437 character.
+ */
+static const uint16_t remote_cp437[256] = {
+    0x0020, 0x263A, 0x263B, 0x2665, 0x2666, 0x2663, 0x2660, 0x2022,
+    0x25D8, 0x25CB, 0x25D9, 0x2642, 0x2640, 0x266A, 0x266B, 0x263C,
+    0x25BA, 0x25C4, 0x2195, 0x203C, 0x00B6, 0x00A7, 0x25AC, 0x21A8,
+    0x2191, 0x2193, 0x2192, 0x2190, 0x221F, 0x2194, 0x25B2, 0x25BC,
+    0x0020, 0x0021, 0x0022, 0x0023, 0x0024, 0x0025, 0x0026, 0x0027,
+    0x0028, 0x0029, 0x002A, 0x002B, 0x002C, 0x002D, 0x002E, 0x002F,
+    0x0030, 0x0031, 0x0032, 0x0033, 0x0034, 0x0035, 0x0036, 0x0037,
+    0x0038, 0x0039, 0x003A, 0x003B, 0x003C, 0x003D, 0x003E, 0x003F,
+    0x0040, 0x0041, 0x0042, 0x0043, 0x0044, 0x0045, 0x0046, 0x0047,
+    0x0048, 0x0049, 0x004A, 0x004B, 0x004C, 0x004D, 0x004E, 0x004F,
+    0x0050, 0x0051, 0x0052, 0x0053, 0x0054, 0x0055, 0x0056, 0x0057,
+    0x0058, 0x0059, 0x005A, 0x005B, 0x005C, 0x005D, 0x005E, 0x005F,
+    0x0060, 0x0061, 0x0062, 0x0063, 0x0064, 0x0065, 0x0066, 0x0067,
+    0x0068, 0x0069, 0x006A, 0x006B, 0x006C, 0x006D, 0x006E, 0x006F,
+    0x0070, 0x0071, 0x0072, 0x0073, 0x0074, 0x0075, 0x0076, 0x0077,
+    0x0078, 0x0079, 0x007A, 0x007B, 0x007C, 0x007D, 0x007E, 0x2302,
+    0x00C7, 0x00FC, 0x00E9, 0x00E2, 0x00E4, 0x00E0, 0x00E5, 0x00E7,
+    0x00EA, 0x00EB, 0x00E8, 0x00EF, 0x00EE, 0x00EC, 0x00C4, 0x00C5,
+    0x00C9, 0x00E6, 0x00C6, 0x00F4, 0x00F6, 0x00F2, 0x00FB, 0x00F9,
+    0x00FF, 0x00D6, 0x00DC, 0x00A2, 0x00A3, 0x00A5, 0x20A7, 0x0192,
+    0x00E1, 0x00ED, 0x00F3, 0x00FA, 0x00F1, 0x00D1, 0x00AA, 0x00BA,
+    0x00BF, 0x2310, 0x00AC, 0x00BD, 0x00BC, 0x00A1, 0x00AB, 0x00BB,
+    0x2591, 0x2592, 0x2593, 0x2502, 0x2524, 0x2561, 0x2562, 0x2556,
+    0x2555, 0x2563, 0x2551, 0x2557, 0x255D, 0x255C, 0x255B, 0x2510,
+    0x2514, 0x2534, 0x252C, 0x251C, 0x2500, 0x253C, 0x255E, 0x255F,
+    0x255A, 0x2554, 0x2569, 0x2566, 0x2560, 0x2550, 0x256C, 0x2567,
+    0x2568, 0x2564, 0x2565, 0x2559, 0x2558, 0x2552, 0x2553, 0x256B,
+    0x256A, 0x2518, 0x250C, 0x2588, 0x2584, 0x258C, 0x2590, 0x2580,
+    0x03B1, 0x00DF, 0x0393, 0x03C0, 0x03A3, 0x03C3, 0x00B5, 0x03C4,
+    0x03A6, 0x0398, 0x03A9, 0x03B4, 0x221E, 0x03C6, 0x03B5, 0x2229,
+    0x2261, 0x00B1, 0x2265, 0x2264, 0x2320, 0x2321, 0x00F7, 0x2248,
+    0x00B0, 0x2219, 0x00B7, 0x221A, 0x207F, 0x00B2, 0x25A0, 0x00A0,
+};
+
+uint8_t mda_remote_utf8(uint8_t chr, uint8_t* out) {
+    uint16_t u = remote_cp437[chr];
+    if (u < 0x80) {
+        out[0] = (uint8_t)u;
+        return 1;
+    }
+    if (u < 0x800) {
+        out[0] = (uint8_t)(0xC0 | (u >> 6));
+        out[1] = (uint8_t)(0x80 | (u & 0x3F));
+        return 2;
+    }
+    out[0] = (uint8_t)(0xE0 | (u >> 12));
+    out[1] = (uint8_t)(0x80 | ((u >> 6) & 0x3F));
+    out[2] = (uint8_t)(0x80 | (u & 0x3F));
+    return 3;
+}
+
+#ifdef __DOS__
+
+#define REMOTE_UART_DATA        0       /**< THR/RBR, DLL with DLAB */
+#define REMOTE_UART_IER         1       /**< Interrupt enable, DLM with DLAB */
+#define REMOTE_UART_FCR         2       /**< FIFO control (write), IIR (read) */
+#define REMOTE_UART_LCR         3       /**< Line control */
+#define REMOTE_UART_MCR         4       /**< Modem control */
+#define REMOTE_UART_LSR         5       /**< Line status */
+#define REMOTE_UART_DLAB        0x80
+#define REMOTE_UART_8N1         0x03
+#define REMOTE_UART_FIFO_ON     0xC7    /**< Enable, clear both, trigger at 14 */
+#define REMOTE_UART_FIFO_MASK   0xC0    /**< IIR bits set when the FIFO is on (16550A) */
+#define REMOTE_UART_DTR_RTS     0x03
+#define REMOTE_UART_THRE        0x20    /**< Transmitter holding register (or FIFO) empty */
+#define REMOTE_UART_CLOCK       115200UL
+
+static uint8_t remote_in(uint16_t port) {
+    uint8_t value;
+    __asm {
+        .8086
+        mov  dx, port
+        in   al, dx
+        mov  value, al
+    }
+    return value;
+}
+
+static void remote_out(uint16_t port, uint8_t value) {
+    __asm {
+        .8086
+        mov  dx, port
+        mov  al, value
+        out  dx, al
+    }
+}
+
+/**
+ * @brief I/O base of COM port n (1-4) from the BIOS data area, 0 if absent.
+ */
+static uint16_t remote_com_base(uint8_t n) {
+    uint16_t base;
+    __asm {
+        .8086
+        push es
+        mov  ax, 40h
+        mov  es, ax         ; ES = BIOS data area
+        mov  bl, n
+        xor  bh, bh
+        dec  bx
+        shl  bx, 1          ; BX = 0000h + 2 * (n - 1)
+        mov  ax, es:[bx]
+        pop  es
+        mov  base, ax
+    }
+    return base;
+}
+
+/**
+ * @brief Program the UART: baud rate, 8N1, polled, FIFO if it has one.
+ * @return false if the port does not exist.
+ */
+static bool remote_link_open(mda_remote_t* remote, int port, uint32_t baud) {
+    require(baud > 0 && baud <= REMOTE_UART_CLOCK, "INVALID baud rate!");
+    uint16_t base = (port >= 1 && port <= 4) ? remote_com_base((uint8_t)port) : 0;
+    if (base == 0) {
+        return false;
+    }
+    uint16_t divisor = (uint16_t)(REMOTE_UART_CLOCK / baud);
+    remote_out(base + REMOTE_UART_LCR, REMOTE_UART_DLAB);
+    remote_out(base + REMOTE_UART_DATA, (uint8_t)divisor);
+    remote_out(base + REMOTE_UART_IER, (uint8_t)(divisor >> 8));
+    remote_out(base + REMOTE_UART_LCR, REMOTE_UART_8N1);
+    remote_out(base + REMOTE_UART_IER, 0);
+    remote_out(base + REMOTE_UART_FCR, REMOTE_UART_FIFO_ON);
+    bool fifo = (remote_in(base + REMOTE_UART_FCR) & REMOTE_UART_FIFO_MASK) == REMOTE_UART_FIFO_MASK;
+    remote_out(base + REMOTE_UART_MCR, REMOTE_UART_DTR_RTS);
+    remote->port = base;
+    remote->fifo = fifo ? 16 : 1;
+    remote->cps = 0;                                // the UART sets the pace
+    return true;
+}
+
+bool mda_remote_pump(mda_remote_t* remote) {
+    require_address(remote, "NULL remote!");
+    while (remote->sent < remote->used
+           && (remote_in(remote->port + REMOTE_UART_LSR) & REMOTE_UART_THRE)) {
+        for (uint8_t i = 0; i < remote->fifo && remote->sent < remote->used; ++i) {
+            remote_out(remote->port + REMOTE_UART_DATA, remote->queue[remote->sent++]);
+            remote->bytes++;
+        }
+    }
+    return remote->sent == remote->used;
+}
+
+#else
+
+#include <errno.h>
+#include <unistd.h>
+
+static bool remote_link_open(mda_remote_t* remote, int port, uint32_t baud) {
+    require(port >= 0, "INVALID file descriptor!");
+    remote->port = port;
+    remote->fifo = 0;
+    remote->cps = (uint16_t)(baud / 10);            // start, 8 data and stop bits
+    remote->stamp = mda_clock_ms();
+    remote->credited = 0;
+    remote->allowance = 0;
+    return true;
+}
+
+bool mda_remote_pump(mda_remote_t* remote) {
+    require_address(remote, "NULL remote!");
+    uint16_t n = remote->used - remote->sent;
+    if (remote->failed || n == 0) {
+        remote->sent = remote->used;
+        return true;
+    }
+    if (remote->cps > 0) {
+        uint32_t due = (uint32_t)((uint64_t)(mda_clock_ms() - remote->stamp) * remote->cps / 1000);
+        uint32_t accrued = due - remote->credited + remote->allowance;
+        remote->credited = due;
+        remote->allowance = (accrued > remote->size) ? remote->size : (uint16_t)accrued;
+        if (n > remote->allowance) {
+            n = remote->allowance;
+        }
+        if (n == 0) {
+            return false;
+        }
+    }
+    ssize_t written = write(remote->port, remote->queue + remote->sent, n);
+    if (written < 0) {
+        if (errno != EAGAIN && errno != EINTR) {
+            remote->failed = true;
+            remote->sent = remote->used;
+            return true;
+        }
+        written = 0;
+    }
+    remote->sent += (uint16_t)written;
+    remote->bytes += (uint32_t)written;
+    if (remote->cps > 0) {
+        remote->allowance -= (uint16_t)written;
+    }
+    return remote->sent == remote->used;
+}
+
+#endif
+
+/**
+ * @brief Move the bytes still queued to the front of the queue.
+ */
+static void remote_compact(mda_remote_t* remote) {
+    if (remote->sent > 0) {
+        memmove(remote->queue, remote->queue + remote->sent, remote->used - remote->sent);
+        remote->used -= remote->sent;
+        remote->sent = 0;
+    }
+}
+
+/**
+ * @brief Queue n bytes if they all fit.
+ */
+static bool remote_append(mda_remote_t* remote, const void* data, uint16_t n) {
+    if (n > remote->size - remote->used) {
+        return false;
+    }
+    memcpy(remote->queue + remote->used, data, n);
+    remote->used += n;
+    return true;
+}
+
+static uint8_t remote_decimal(uint8_t* out, uint8_t value) {
+    if (value >= 10) {
+        out[0] = '0' + value / 10;
+        out[1] = '0' + value % 10;
+        return 2;
+    }
+    out[0] = '0' + value;
+    return 1;
+}
+
+/**
+ * @brief Encode a VT100 cursor position (CUP) for zero based x, y.
+ */
+static uint8_t remote_cup(uint8_t* out, uint8_t x, uint8_t y) {
+    uint8_t n = 0;
+    out[n++] = 0x1B;
+    out[n++] = '[';
+    n += remote_decimal(out + n, y + 1);
+    out[n++] = ';';
+    n += remote_decimal(out + n, x + 1);
+    out[n++] = 'H';
+    return n;
+}
+
+/**
+ * @brief SGR state showing an MDA attribute.
+ */
+static uint8_t remote_sgr(uint8_t attr) {
+    uint8_t fg = attr & 0x07;
+    uint8_t bg = (attr >> 4) & 0x07;
+    uint8_t sgr = 0;
+    if (fg == 0 && bg == 0) {
+        return REMOTE_SGR_CONCEAL;
+    }
+    if (bg != 0) {
+        sgr |= REMOTE_SGR_REVERSE;
+    }
+    else if (fg == MDA_UNDERLINE) {
+        sgr |= REMOTE_SGR_UNDERLINE;
+    }
+    if (attr & MDA_BOLD) {
+        sgr |= REMOTE_SGR_BOLD;
+    }
+    if (attr & MDA_BLINK) {
+        sgr |= REMOTE_SGR_BLINK;
+    }
+    return sgr;
+}
+
+/**
+ * @brief Encode the SGR sequence that sets exactly the state sgr.
+ */
+static uint8_t remote_sgr_sequence(uint8_t* out, uint8_t sgr) {
+    static const uint8_t codes[5] = { '1', '4', '5', '7', '8' };
+    uint8_t n = 0;
+    out[n++] = 0x1B;
+    out[n++] = '[';
+    out[n++] = '0';
+    for (uint8_t i = 0; i < 5; ++i) {
+        if (sgr & (1 << i)) {
+            out[n++] = ';';
+            out[n++] = codes[i];
+        }
+    }
+    out[n++] = 'm';
+    return n;
+}
+
+/**
+ * @brief Queue cells start..end-1 of row y as VT100 output.
+ * @return Cells queued; fewer than asked when the queue filled.
+ */
+static uint8_t remote_vt100_span(mda_remote_t* remote, uint8_t y, uint8_t start, uint8_t end,
+                                 const mda_cell_t* screen) {
+    uint8_t* out = remote->queue + remote->used;
+    uint16_t room = remote->size - remote->used;
+    uint16_t n = 0;
+    if (!remote->at_known || remote->at.x != start || remote->at.y != y) {
+        if (room < REMOTE_CUP_MAX) {
+            return 0;
+        }
+        n = remote_cup(out, start, y);
+    }
+    uint8_t sgr = remote->sgr;
+    uint8_t x = start;
+    for (; x < end; ++x) {
+        uint8_t cell[REMOTE_SGR_MAX + MDA_REMOTE_UTF8_MAX];
+        uint8_t k = 0;
+        uint8_t s = remote_sgr(screen[x].attr);
+        if (s != sgr) {
+            k = remote_sgr_sequence(cell, s);
+        }
+        k += mda_remote_utf8((uint8_t)screen[x].chr, cell + k);
+        if (n + k > room) {
+            break;
+        }
+        memcpy(out + n, cell, k);
+        n += k;
+        sgr = s;
+    }
+    if (x > start) {
+        remote->used += n;
+        remote->sgr = sgr;
+        remote->at = mda_point_make(x, y);
+        remote->at_known = x < MDA_COLUMNS;         // the last column leaves a wrap pending
+    }
+    return x - start;
+}
+
+/**
+ * @brief Queue cells start..end-1 of row y as a binary span.
+ * @return Cells queued; fewer than asked when the queue filled.
+ */
+static uint8_t remote_binary_span(mda_remote_t* remote, uint8_t y, uint8_t start, uint8_t end,
+                                  const mda_cell_t* screen) {
+    uint16_t room = remote->size - remote->used;
+    if (room < MDA_REMOTE_SPAN + sizeof(mda_cell_t)) {
+        return 0;
+    }
+    uint8_t count = end - start;
+    if (count > (room - MDA_REMOTE_SPAN) / sizeof(mda_cell_t)) {
+        count = (uint8_t)((room - MDA_REMOTE_SPAN) / sizeof(mda_cell_t));
+    }
+    uint16_t offset = y * MDA_COLUMNS + start;
+    uint8_t* out = remote->queue + remote->used;
+    out[0] = (uint8_t)offset;
+    out[1] = (uint8_t)(offset >> 8);
+    out[2] = count;
+    memcpy(out + MDA_REMOTE_SPAN, screen + start, count * sizeof(mda_cell_t));
+    remote->used += MDA_REMOTE_SPAN + count * sizeof(mda_cell_t);
+    return count;
+}
+
+/**
+ * @brief Row y of the cells mirrored.
+ */
+static const mda_cell_t* remote_source_row(const mda_remote_t* remote, uint8_t y) {
+    mda_point_t p = mda_point_make(0, y);
+    return remote->source ? remote->source + y * MDA_COLUMNS : mda_as_pointer(&p);
+}
+
+/**
+ * @brief Make the binary shadow differ from the source in every cell, so the next frames send it all.
+ */
+static void remote_invalidate(mda_remote_t* remote) {
+    for (uint8_t y = 0; y < MDA_ROWS; ++y) {
+        const mda_cell_t* screen = remote_source_row(remote, y);
+        mda_cell_t* shadow = remote->shadow + y * MDA_COLUMNS;
+        for (uint8_t x = 0; x < MDA_COLUMNS; ++x) {
+            shadow[x].packed = ~screen[x].packed;
+        }
+    }
+    remote->pending = MDA_REMOTE_ALL_ROWS;
+}
+
+/**
+ * @brief Queue the changed cells of row y and update the shadow with them.
+ * @return false if the queue filled before the row was done.
+ */
+static bool remote_row(mda_remote_t* remote, uint8_t y) {
+    const mda_cell_t* screen = remote_source_row(remote, y);
+    mda_cell_t* shadow = remote->shadow + y * MDA_COLUMNS;
+    if (memcmp(screen, shadow, MDA_ROW_BYTES) == 0) {
+        return true;
+    }
+    uint8_t bridge = (remote->mode == MDA_REMOTE_VT100) ? REMOTE_VT100_BRIDGE : 1;
+    uint8_t x = 0;
+    while (x < MDA_COLUMNS) {
+        if (screen[x].packed == shadow[x].packed) {
+            x++;
+            continue;
+        }
+        uint8_t start = x;
+        uint8_t end = start + 1;
+        for (x = end; x < MDA_COLUMNS && x - end <= bridge; ++x) {
+            if (screen[x].packed != shadow[x].packed) {
+                end = x + 1;
+            }
+        }
+        uint8_t count = (remote->mode == MDA_REMOTE_VT100)
+                      ? remote_vt100_span(remote, y, start, end, screen)
+                      : remote_binary_span(remote, y, start, end, screen);
+        memcpy(shadow + start, screen + start, count * sizeof(mda_cell_t));
+        if (count < end - start) {
+            return false;
+        }
+        x = end;
+    }
+    return true;
+}
+
+/**
+ * @brief Queue the cursor position or visibility if it changed.
+ */
+static void remote_cursor(mda_remote_t* remote, const mda_point_t* cursor) {
+    uint16_t offset = cursor ? cursor->y * MDA_COLUMNS + cursor->x : MDA_SCREEN_WORDS;
+    uint8_t seq[REMOTE_CUP_MAX + 6];
+    uint8_t n = 0;
+    if (remote->mode == MDA_REMOTE_BINARY) {
+        if (offset == remote->cursor) {
+            return;
+        }
+        seq[n++] = (uint8_t)offset;
+        seq[n++] = (uint8_t)(offset >> 8);
+        seq[n++] = 0;
+    }
+    else if (cursor == NULL) {
+        if (remote->cursor == MDA_SCREEN_WORDS) {
+            return;
+        }
+        memcpy(seq, "\x1B[?25l", 6);
+        n = 6;
+    }
+    else {
+        if (!remote->at_known || remote->at.packed != cursor->packed) {
+            n = remote_cup(seq, cursor->x, cursor->y);
+        }
+        if (remote->cursor >= MDA_SCREEN_WORDS) {
+            memcpy(seq + n, "\x1B[?25h", 6);
+            n += 6;
+        }
+    }
+    if (n > 0 && remote_append(remote, seq, n)) {
+        remote->cursor = offset;
+        if (cursor != NULL) {
+            remote->at = *cursor;
+            remote->at_known = true;
+        }
+    }
+}
+
+bool mda_remote_open(mda_remote_t* remote, int port, uint32_t baud, mda_remote_mode_t mode,
+                     uint8_t* queue, uint16_t size) {
+    require_address(remote, "NULL remote!");
+    require_address(queue, "NULL queue!");
+    require(size >= REMOTE_QUEUE_MIN, "INVALID queue size!");
+    if (!remote_link_open(remote, port, baud)) {
+        return false;
+    }
+    remote->mode = mode;
+    remote->queue = queue;
+    remote->size = size;
+    remote->used = 0;
+    remote->sent = 0;
+    remote->source = NULL;
+    remote->pending = MDA_REMOTE_ALL_ROWS;
+    remote->next_row = 0;
+    remote->cursor = 0xFFFF;                        // unknown: the first frame sets it
+    remote->bytes = 0;
+    remote->failed = false;
+    mda_point_t p = mda_point_make(0, 0);
+    if (mode == MDA_REMOTE_VT100) {
+        for (uint16_t i = 0; i < MDA_SCREEN_WORDS; ++i) {
+            remote->shadow[i] = mda_cell_make(' ', MDA_NORMAL);    // as the far end shows after clearing
+        }
+        remote_append(remote, "\x1B[0m\x1B[H\x1B[2J", 11);
+        remote->sgr = 0;
+        remote->at = p;
+        remote->at_known = true;
+    }
+    else {
+        remote_invalidate(remote);
+        remote->sgr = REMOTE_UNKNOWN;
+        remote->at_known = false;
+    }
+    return true;
+}
+
+void mda_remote_set_source(mda_remote_t* remote, const mda_cell_t* cells) {
+    require_address(remote, "NULL remote!");
+    remote->source = cells;
+    if (remote->mode == MDA_REMOTE_BINARY && remote->bytes == 0 && remote->used == 0) {
+        remote_invalidate(remote);                  // nothing sent yet: differ from the new cells
+    }
+    remote->pending = MDA_REMOTE_ALL_ROWS;
+}
+
+void mda_remote_frame(mda_remote_t* remote, uint32_t rows, const mda_point_t* cursor) {
+    require_address(remote, "NULL remote!");
+    if (remote->failed) {
+        return;
+    }
+    mda_remote_pump(remote);
+    remote_compact(remote);
+    remote->pending |= rows & MDA_REMOTE_ALL_ROWS;
+    uint8_t y = remote->next_row;
+    for (uint8_t i = 0; i < MDA_ROWS; ++i) {
+        uint32_t bit = 1UL << y;
+        if (remote->pending & bit) {
+            uint16_t used = remote->used;
+            if (!remote_row(remote, y)) {
+                if (remote->used > used) {      // made progress: serve the next row first so none starves
+                    y = (y + 1 < MDA_ROWS) ? y + 1 : 0;
+                }
+                remote->next_row = y;
+                break;
+            }
+            remote->pending &= ~bit;
+        }
+        y = (y + 1 < MDA_ROWS) ? y + 1 : 0;
+    }
+    remote_cursor(remote, cursor);
+    mda_remote_pump(remote);
+}
+
+bool mda_remote_close(mda_remote_t* remote) {
+    require_address(remote, "NULL remote!");
+    while (!mda_remote_pump(remote)) {
+        ;
+    }
+    remote_compact(remote);
+    if (remote->mode == MDA_REMOTE_VT100) {
+        uint8_t seq[REMOTE_CUP_MAX];
+        remote_append(remote, "\x1B[0m\x1B[?25h", 10);
+        remote_append(remote, seq, remote_cup(seq, 0, MDA_ROWS - 1));
+        remote_append(remote, "\r\n", 2);
+    }
+    while (!mda_remote_pump(remote)) {
+        ;
+    }
+    return !remote->failed;
+}
@@ -0,0 +1,134 @@
+/**
+ * @file mda_remote.h
+ * @brief Remote Console Mirroring over a Serial Port or File Descriptor
+ * @details Mirrors the screen to a terminal on the other end of a serial
+ * link (DOS) or any file descriptor such as a pipe or pty (host). Like
+ * mda_recorder.h it keeps a shadow of what the far end shows and sends only
+ * the cells that differ from it.
+ *
+ * Two encodings:
+ * - MDA_REMOTE_VT100: cursor positioning and SGR sequences, characters as
+ *   UTF-8, for any VT100/ANSI terminal emulator. Attributes map to bold
+ *   (intensity), underline, blink, reverse and concealed (invisible).
+ * - MDA_REMOTE_BINARY: spans of offset (16 bits, little endian), count,
+ *   then count cells of character, attribute, as in mda_recorder.h. A span
+ *   of count 0 carries the cursor position as its offset; an offset past
+ *   the screen hides the cursor.
+ *
+ * Bandwidth: encoded bytes wait in a caller supplied queue which drains at
+ * the speed of the link. A frame encodes only what fits in the free part of
+ * the queue; cells that did not fit stay different from the shadow and go
+ * with a later frame, by which time they may have changed again, so a slow
+ * link shows the latest picture rather than falling behind. Rows are served
+ * round robin, so a busy row cannot starve the rest. Size the queue to what
+ * the link carries between frames: 256 bytes is about a quarter of a second
+ * at 9600 baud.
+ *
+ * On DOS the port is a COM number (1-4), driven by polling the 8250/16550
+ * UART; the queue drains as mda_remote_frame() or mda_remote_pump() run,
+ * never waiting on the UART. On the host the port is a file descriptor and
+ * the baud rate, if not 0, paces the writes as a serial line would.
+ *
+ * @note Host pacing reads mda_clock_ms(); call mda_clock_init() first.
+ * @author Jeremy Thornton
+ */
+#ifndef MDA_REMOTE_H
+#define MDA_REMOTE_H
+
+#include "mda_cell.h"
+#include "mda_constants.h"
+#include "mda_point.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+#define MDA_REMOTE_ALL_ROWS     0x01FFFFFFUL    /**< Row mask covering the screen */
+#define MDA_REMOTE_SPAN         3               /**< Bytes of a binary span header */
+#define MDA_REMOTE_UTF8_MAX     3               /**< Longest UTF-8 encoding of a CP437 character */
+
+/**
+ * @enum mda_remote_mode_t
+ * @brief Encoding sent to the far end.
+ */
+typedef enum {
+    MDA_REMOTE_VT100 = 0,   /**< VT100 escape sequences and UTF-8 */
+    MDA_REMOTE_BINARY       /**< Cell spans */
+} mda_remote_mode_t;
+
+/**
+ * @struct mda_remote_t
+ * @brief Link, output queue and far end state of one mirror.
+ */
+typedef struct {
+    int port;                               /**< DOS: UART base address; host: file descriptor */
+    uint8_t fifo;                           /**< Bytes the UART accepts at once */
+    mda_remote_mode_t mode;                 /**< Encoding */
+    uint16_t cps;                           /**< Host pacing in characters per second, 0 unpaced */
+    uint32_t stamp;                         /**< Clock when pacing started */
+    uint32_t credited;                      /**< Bytes the paced line could have carried since stamp */
+    uint16_t allowance;                     /**< Bytes the paced link may take now */
+    uint8_t* queue;                         /**< Caller supplied output queue */
+    uint16_t size;                          /**< Bytes in queue */
+    uint16_t used;                          /**< Bytes queued */
+    uint16_t sent;                          /**< Bytes of those already on the link */
+    const mda_cell_t* source;               /**< Cells mirrored, NULL for the screen */
+    uint32_t pending;                       /**< Bit y set if row y may differ from the shadow */
+    uint8_t next_row;                       /**< Row to serve first */
+    mda_cell_t shadow[MDA_SCREEN_WORDS];    /**< Screen as the far end shows it */
+    mda_point_t at;                         /**< Far end cursor position */
+    bool at_known;                          /**< at is valid */
+    uint8_t sgr;                            /**< Far end SGR state, 0xFF unknown */
+    uint16_t cursor;                        /**< Cursor as last sent, as an offset; MDA_SCREEN_WORDS hidden */
+    uint32_t bytes;                         /**< Bytes sent */
+    bool failed;                            /**< A write failed; mirroring stopped */
+} mda_remote_t;
+
+/**
+ * @brief Open the link and start mirroring; the first frames send the whole screen.
+ * @param port DOS: COM port number 1-4; host: an open file descriptor.
+ * @param baud Line speed. DOS: programmed into the UART (8N1); host: pacing, 0 for none.
+ * @param queue Output queue, at least 64 bytes.
+ * @return false if the COM port does not exist.
+ */
+bool mda_remote_open(mda_remote_t* remote, int port, uint32_t baud, mda_remote_mode_t mode,
+                     uint8_t* queue, uint16_t size);
+
+/**
+ * @brief Send what changed on screen, as far as the queue allows.
+ * @param rows Bit y set if row y may have changed; MDA_REMOTE_ALL_ROWS when unknown.
+ * @param cursor Where to show the cursor, or NULL to hide it.
+ */
+void mda_remote_frame(mda_remote_t* remote, uint32_t rows, const mda_point_t* cursor);
+
+/**
+ * @brief Mirror a buffer of MDA_SCREEN_WORDS cells instead of the screen.
+ * @details Lets a thread other than the one drawing encode a copy of the
+ * screen. The shadow is kept, so switching between the buffers of a double
+ * or triple buffer sends only what differs; every row is checked by the
+ * next frame.
+ * @param cells The buffer, or NULL to mirror the screen again.
+ */
+void mda_remote_set_source(mda_remote_t* remote, const mda_cell_t* cells);
+
+/**
+ * @brief Pass queued bytes to the link as far as it takes them now.
+ * @return true once the queue is empty.
+ */
+bool mda_remote_pump(mda_remote_t* remote);
+
+/**
+ * @brief Finish sending, restore the far end's attributes and cursor.
+ * @note Waits for the queue to drain.
+ * @return false if any write has failed.
+ */
+bool mda_remote_close(mda_remote_t* remote);
+
+/**
+ * @brief Encode a CP437 character as UTF-8.
+ * @details Characters 0x01-0x1F and 0x7F map to the IBM PC glyphs shown on
+ * screen; NUL maps to a space.
+ * @param out At least MDA_REMOTE_UTF8_MAX bytes.
+ * @return Bytes written to out.
+ */
+uint8_t mda_remote_utf8(uint8_t chr, uint8_t* out);
+
+#endif /* MDA_REMOTE_H */
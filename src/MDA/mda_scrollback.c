@@ -0,0 +1,266 @@
+/**
+ * @file mda_scrollback.c
+ * @brief Implementation of the Compressed Scrollback Ring Buffer
+ * @details Row lengths are not stored: a row ends where the next row (or
+ * the write head) begins, so evicting the oldest row only advances two ring
+ * indices.
+ * @author Jeremy Thornton
+ */
+#include "mda_scrollback.h"
+#include "mda_primitives.h"
+#include "../CONTRACT/contract.h"
+#include <string.h>
+
+/**
+ * @brief Ring position of stored row k (0 = oldest).
+ */
+static uint16_t sb_slot(const mda_scrollback_t* sb, uint16_t k) {
+    uint16_t slot = sb->first + k;
+    return (slot >= sb->capacity) ? slot - sb->capacity : slot;
+}
+
+/**
+ * @brief Encoded length of stored row k.
+ */
+static uint16_t sb_length(const mda_scrollback_t* sb, uint16_t k) {
+    uint16_t start = sb->rows[sb_slot(sb, k)];
+    if (k + 1 == sb->count) {   // newest row runs up to the head
+        uint16_t rel = (start >= sb->rows[sb->first]) ? start - sb->rows[sb->first]
+                                                      : start + sb->size - sb->rows[sb->first];
+        return sb->used - rel;
+    }
+    uint16_t end = sb->rows[sb_slot(sb, k + 1)];
+    return (end >= start) ? end - start : end + sb->size - start;
+}
+
+/**
+ * @brief Drop the oldest row.
+ */
+static void sb_evict(mda_scrollback_t* sb) {
+    sb->used -= sb_length(sb, 0);
+    sb->first = sb_slot(sb, 1);
+    sb->count--;
+    if (sb->top > 0) {
+        sb->top--;
+    }
+}
+
+/**
+ * @brief Compress a row of cells into out.
+ * @return Encoded length, at most MDA_SCROLLBACK_MAX_ROW.
+ */
+static uint16_t sb_encode(const mda_cell_t* cells, uint8_t w, const mda_cell_t* blank, uint8_t* out) {
+    uint16_t n = 0;
+    uint8_t i = 0;
+    while (w > 0 && cells[w - 1].packed == blank->packed) {  // trailing padding
+        w--;
+    }
+    while (i < w) {
+        uint8_t j = i + 1;
+        while (j < w && cells[j].packed == cells[i].packed && j - i < MDA_SCROLLBACK_RUN_MAX) {
+            j++;
+        }
+        if (j - i >= 3) {           // repeat run
+            out[n++] = cells[i].attr;
+            out[n++] = MDA_SCROLLBACK_REPEAT | (j - i);
+            out[n++] = cells[i].chr;
+            i = j;
+            continue;
+        }
+        uint8_t attr = cells[i].attr;
+        j = i;                      // literal run: same attribute, up to the next repeat
+        while (j < w && cells[j].attr == attr && j - i < MDA_SCROLLBACK_RUN_MAX &&
+               !(j + 2 < w && cells[j].packed == cells[j + 1].packed && cells[j].packed == cells[j + 2].packed)) {
+            j++;
+        }
+        if (j == i) {
+            j = i + 1;
+        }
+        out[n++] = attr;
+        out[n++] = j - i;
+        while (i < j) {
+            out[n++] = cells[i++].chr;
+        }
+    }
+    return n;
+}
+
+void mda_scrollback_init(mda_scrollback_t* sb, uint8_t* buffer, uint16_t bytes) {
+    require_address(sb, "NULL scrollback!");
+    require_address(buffer, "NULL buffer!");
+    sb->capacity = bytes / (MDA_SCROLLBACK_AVG_ROW + sizeof(uint16_t));
+    sb->size = bytes - sb->capacity * sizeof(uint16_t);
+    sb->size &= ~1u;            // keep the row index word aligned
+    require(sb->size >= MDA_ROWS * MDA_SCROLLBACK_MAX_ROW && sb->capacity >= MDA_ROWS,
+            "Scrollback budget cannot park a screen!");
+    sb->data = buffer;
+    sb->rows = (uint16_t*)(buffer + sb->size);
+    mda_scrollback_clear(sb);
+}
+
+void mda_scrollback_clear(mda_scrollback_t* sb) {
+    require_address(sb, "NULL scrollback!");
+    sb->head = 0;
+    sb->used = 0;
+    sb->first = 0;
+    sb->count = 0;
+    sb->live = 0;
+    sb->top = 0;
+}
+
+void mda_scrollback_push(mda_scrollback_t* sb, const mda_cell_t* cells, uint8_t w, const mda_cell_t* blank) {
+    require_address(sb, "NULL scrollback!");
+    require_address(cells, "NULL cells!");
+    require_address(blank, "NULL blank!");
+    uint8_t encoded[MDA_SCROLLBACK_MAX_ROW];
+    uint16_t n = sb_encode(cells, w, blank, encoded);
+    while (sb->count > 0 && (sb->count == sb->capacity || sb->size - sb->used < n)) {
+        sb_evict(sb);
+    }
+    sb->rows[sb_slot(sb, sb->count)] = sb->head;
+    sb->count++;
+    uint16_t tail = sb->size - sb->head;    // bytes before the ring wraps
+    if (n <= tail) {
+        memcpy(sb->data + sb->head, encoded, n);
+    }
+    else {
+        memcpy(sb->data + sb->head, encoded, tail);
+        memcpy(sb->data, encoded + tail, n - tail);
+    }
+    sb->head = (n < tail) ? sb->head + n : n - tail;
+    sb->used += n;
+}
+
+void mda_scrollback_pop(mda_scrollback_t* sb, uint16_t n) {
+    require_address(sb, "NULL scrollback!");
+    require(n <= sb->count, "Popping more rows than stored!");
+    while (n-- > 0) {
+        uint16_t k = sb->count - 1;
+        sb->used -= sb_length(sb, k);
+        sb->head = sb->rows[sb_slot(sb, k)];
+        sb->count--;
+    }
+}
+
+void mda_scrollback_row(const mda_scrollback_t* sb, uint16_t k, mda_cell_t* cells, uint8_t w, const mda_cell_t* blank) {
+    require_address(sb, "NULL scrollback!");
+    require_address(cells, "NULL cells!");
+    require(k < sb->count, "Row not stored!");
+    uint8_t encoded[MDA_SCROLLBACK_MAX_ROW];
+    uint16_t start = sb->rows[sb_slot(sb, k)];
+    uint16_t n = sb_length(sb, k);
+    uint16_t tail = sb->size - start;
+    if (n <= tail) {
+        memcpy(encoded, sb->data + start, n);
+    }
+    else {
+        memcpy(encoded, sb->data + start, tail);
+        memcpy(encoded + tail, sb->data, n - tail);
+    }
+    uint16_t i = 0;
+    uint8_t x = 0;
+    while (i < n && x < w) {
+        mda_cell_t cell;
+        cell.attr = encoded[i++];
+        uint8_t run = encoded[i++];
+        if (run & MDA_SCROLLBACK_REPEAT) {
+            run &= ~MDA_SCROLLBACK_REPEAT;
+            cell.chr = encoded[i++];
+            while (run-- > 0 && x < w) {
+                cells[x++] = cell;
+            }
+        }
+        else {
+            while (run-- > 0 && x < w) {
+                cell.chr = encoded[i++];
+                cells[x++] = cell;
+            }
+        }
+    }
+    while (x < w) {
+        cells[x++] = *blank;
+    }
+}
+
+void mda_scrollback_render(const mda_scrollback_t* sb, const mda_rect_t* rect, uint16_t first, const mda_cell_t* blank) {
+    require_address(sb, "NULL scrollback!");
+    require_address(rect, "NULL rectangle!");
+    require_address(blank, "NULL blank!");
+    mda_cell_t row[MDA_COLUMNS];
+    for (uint8_t r = 0; r < rect->h; ++r) {
+        mda_point_t p = mda_point_make(rect->x, rect->y + r);
+        if (first + r < sb->count) {
+            mda_scrollback_row(sb, first + r, row, rect->w, blank);
+            mda_write_cells(&p, row, rect->w);
+        }
+        else {
+            mda_point_t p1 = mda_point_make(rect->x + rect->w - 1, p.y);
+            mda_draw_hline(&p, &p1, blank);
+        }
+    }
+}
+
+void mda_scrollback_enter(mda_scrollback_t* sb, const mda_rect_t* rect, const mda_cell_t* blank) {
+    require_address(sb, "NULL scrollback!");
+    require_address(rect, "NULL rectangle!");
+    if (sb->live > 0) {
+        return;
+    }
+    for (uint8_t r = 0; r < rect->h; ++r) {
+        mda_point_t p = mda_point_make(rect->x, rect->y + r);
+        mda_scrollback_push(sb, mda_as_pointer(&p), rect->w, blank);
+    }
+    ensure(sb->count >= rect->h, "Parked rows evicted!");
+    sb->live = rect->h;
+    sb->top = sb->count - rect->h;
+}
+
+void mda_scrollback_scroll(mda_scrollback_t* sb, const mda_rect_t* rect, const mda_cell_t* blank, int16_t lines) {
+    require_address(sb, "NULL scrollback!");
+    require_address(rect, "NULL rectangle!");
+    require(sb->live > 0, "Not viewing scrollback!");
+    int32_t top = (int32_t)sb->top + lines;
+    int32_t newest = (int32_t)sb->count - rect->h;  // live screen position
+    if (top > newest) {
+        top = newest;
+    }
+    if (top < 0) {
+        top = 0;
+    }
+    if (top == sb->top) {
+        return;
+    }
+    if (rect->h > 1 && top == sb->top - 1) {        // one line back in time
+        mda_point_t p = mda_point_make(rect->x, rect->y);
+        mda_cell_t row[MDA_COLUMNS];
+        sb->top--;
+        mda_scroll_down(rect, blank);
+        mda_scrollback_row(sb, sb->top, row, rect->w, blank);
+        mda_write_cells(&p, row, rect->w);
+    }
+    else if (rect->h > 1 && top == sb->top + 1) {   // one line forward in time
+        mda_point_t p = mda_point_make(rect->x, rect->y + rect->h - 1);
+        mda_cell_t row[MDA_COLUMNS];
+        sb->top++;
+        mda_scroll_up(rect, blank);
+        mda_scrollback_row(sb, sb->top + rect->h - 1, row, rect->w, blank);
+        mda_write_cells(&p, row, rect->w);
+    }
+    else {
+        sb->top = (uint16_t)top;
+        mda_scrollback_render(sb, rect, sb->top, blank);
+    }
+}
+
+void mda_scrollback_leave(mda_scrollback_t* sb, const mda_rect_t* rect, const mda_cell_t* blank) {
+    require_address(sb, "NULL scrollback!");
+    require_address(rect, "NULL rectangle!");
+    if (sb->live == 0) {
+        return;
+    }
+    uint16_t live = (sb->live < sb->count) ? sb->live : sb->count;
+    mda_scrollback_render(sb, rect, sb->count - live, blank);
+    mda_scrollback_pop(sb, live);
+    sb->live = 0;
+    sb->top = 0;
+}
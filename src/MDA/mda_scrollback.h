@@ -0,0 +1,109 @@
+/**
+ * @file mda_scrollback.h
+ * @brief Compressed Scrollback Ring Buffer for Console Output
+ * @details Keeps the rows that scroll off the top of a context so they can
+ * be viewed again later. Rows are stored compressed in a byte ring inside a
+ * caller supplied memory budget: trailing blanks are dropped, cells are
+ * grouped into attribute runs, and runs of one repeated cell are stored as a
+ * single cell plus a count. A plain line of text costs roughly its length
+ * plus two bytes, rather than a fixed 160 bytes.
+ *
+ * Appending a row is O(1) amortized: when the budget is exhausted the
+ * oldest rows are evicted. Any historical window can be rendered straight
+ * from the ring.
+ *
+ * Encoded row format, a sequence of runs:
+ * - literal run: attr, n (1..127), n characters
+ * - repeat run:  attr, 0x80 | n (1..127), one character repeated n times
+ *
+ * @author Jeremy Thornton
+ */
+#ifndef MDA_SCROLLBACK_H
+#define MDA_SCROLLBACK_H
+
+#include "mda_constants.h"
+#include "mda_types.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+#define MDA_SCROLLBACK_AVG_ROW      24      /**< Expected encoded bytes per row, sizes the row index */
+#define MDA_SCROLLBACK_MAX_ROW      (MDA_COLUMNS * 3) /**< Worst case encoded row (one run per cell) */
+#define MDA_SCROLLBACK_REPEAT       0x80    /**< Run count flag: one character repeated */
+#define MDA_SCROLLBACK_RUN_MAX      127     /**< Longest run that fits the count byte */
+#define MDA_SCROLLBACK_MIN_BYTES    ((MDA_ROWS * MDA_SCROLLBACK_MAX_ROW / MDA_SCROLLBACK_AVG_ROW + 1) * \
+                                     (MDA_SCROLLBACK_AVG_ROW + 2)) /**< Smallest budget whose ring parks any screen */
+
+/**
+ * @struct mda_scrollback_t
+ * @brief Ring of compressed rows plus a ring of row start offsets.
+ */
+typedef struct {
+    uint8_t* data;          /**< Encoded row bytes (ring) */
+    uint16_t size;          /**< Capacity of data in bytes */
+    uint16_t head;          /**< Next byte to write */
+    uint16_t used;          /**< Bytes held by stored rows */
+    uint16_t* rows;         /**< Start offset of each stored row (ring) */
+    uint16_t capacity;      /**< Capacity of rows */
+    uint16_t first;         /**< Ring position of the oldest row */
+    uint16_t count;         /**< Rows stored */
+    uint16_t live;          /**< Live screen rows parked in the ring while viewing, 0 otherwise */
+    uint16_t top;           /**< Row shown at the top of the viewport while viewing */
+} mda_scrollback_t;
+
+/**
+ * @brief Initialize a scrollback store inside a caller supplied buffer.
+ * @param sb     Store to initialize.
+ * @param buffer Memory budget; the row index is carved from its end.
+ * @param bytes  Size of buffer, at least MDA_SCROLLBACK_MIN_BYTES: after the index the ring must hold
+ *               MDA_ROWS worst case rows, or parking a busy screen would evict its own rows.
+ */
+void mda_scrollback_init(mda_scrollback_t* sb, uint8_t* buffer, uint16_t bytes);
+
+/**
+ * @brief Discard every stored row.
+ */
+void mda_scrollback_clear(mda_scrollback_t* sb);
+
+/**
+ * @brief Compress and append one row, evicting the oldest rows if needed.
+ * @param sb    Store.
+ * @param cells Row of cells (may point into VRAM).
+ * @param w     Number of cells in the row.
+ * @param blank Cell treated as trailing padding and dropped.
+ */
+void mda_scrollback_push(mda_scrollback_t* sb, const mda_cell_t* cells, uint8_t w, const mda_cell_t* blank);
+
+/**
+ * @brief Drop the newest n rows.
+ */
+void mda_scrollback_pop(mda_scrollback_t* sb, uint16_t n);
+
+/**
+ * @brief Decompress stored row k (0 = oldest) into w cells, padding with blank.
+ */
+void mda_scrollback_row(const mda_scrollback_t* sb, uint16_t k, mda_cell_t* cells, uint8_t w, const mda_cell_t* blank);
+
+/**
+ * @brief Render stored rows first.. into rect, one cell run per row.
+ * @details Rows past the newest stored row are drawn blank.
+ */
+void mda_scrollback_render(const mda_scrollback_t* sb, const mda_rect_t* rect, uint16_t first, const mda_cell_t* blank);
+
+/**
+ * @defgroup scrollback_view Scrollback View Mode
+ * @brief Browse history in place of the live screen.
+ * @details Entering parks the live rows of rect in the ring, so the live
+ * screen is simply the newest window of history; leaving redraws and pops
+ * them. Console output must not be written while viewing.
+ * @{
+ */
+void mda_scrollback_enter(mda_scrollback_t* sb, const mda_rect_t* rect, const mda_cell_t* blank);                ///< Park the live screen and start viewing
+void mda_scrollback_scroll(mda_scrollback_t* sb, const mda_rect_t* rect, const mda_cell_t* blank, int16_t lines); ///< Move the view (negative = back in time)
+void mda_scrollback_leave(mda_scrollback_t* sb, const mda_rect_t* rect, const mda_cell_t* blank);                ///< Restore the live screen
+///@}
+
+static inline bool mda_scrollback_viewing(const mda_scrollback_t* sb) {
+    return sb->live > 0;    /**< true while in view mode */
+}
+
+#endif /* MDA_SCROLLBACK_H */
@@ -0,0 +1,152 @@
+/**
+ * @file mda_strip_chart.c
+ * @brief Implementation of the Streaming Strip Chart Widget
+ * @details A column is composed top to bottom in a small cell buffer and
+ * written a cell per row with mda_write_cells(), so committing a sample
+ * costs one mda_scroll_left() plus bounds.h cell writes.
+ * @author Jeremy Thornton
+ */
+#include "mda_strip_chart.h"
+#include "mda_primitives.h"
+#include "cp437_constants.h"
+#include "../CONTRACT/contract.h"
+
+static const char strip_shades[5] = {
+    ' ', CP437_LIGHT_SHADE, CP437_MEDIUM_SHADE, CP437_DARK_SHADE, CP437_FULL_BLOCK
+};
+
+/**
+ * @brief Scale a value to 1..levels within the series range.
+ * @details A value at or below the minimum stays on the baseline, level 1,
+ * so a trace flat at its minimum is still drawn.
+ */
+static uint8_t strip_level(const mda_strip_series_t* s, int16_t v, uint8_t levels) {
+    if (s->max <= s->min || v <= s->min) {
+        return 1;
+    }
+    if (v >= s->max) {
+        return levels;
+    }
+    uint8_t level = (uint8_t)(((int32_t)(v - s->min) * levels) / ((int32_t)s->max - s->min));
+    return (level > 0) ? level : 1;
+}
+
+/**
+ * @brief Render one column of values (NULL = empty) at screen column x.
+ */
+static void strip_render_column(const mda_strip_chart_t* chart, uint8_t x, const int16_t* values) {
+    mda_cell_t column[MDA_ROWS];
+    uint8_t h = chart->bounds.h;
+    for (uint8_t r = 0; r < h; ++r) {
+        column[r] = chart->blank;
+    }
+    for (uint8_t i = 0; values && i < chart->series_count; ++i) {
+        const mda_strip_series_t* s = &chart->series[i];
+        if (h == 1) {           // sparkline: level by density
+            column[0] = mda_cell_make(strip_shades[strip_level(s, values[i], 4)], s->attr);
+            continue;
+        }
+        uint8_t level = strip_level(s, values[i], h * 2);
+        uint8_t full = level >> 1;
+        if (s->fill) {          // area: full blocks topped by a lower half
+            for (uint8_t k = 0; k < full; ++k) {
+                column[h - 1 - k] = mda_cell_make(CP437_FULL_BLOCK, s->attr);
+            }
+            if (level & 1) {
+                column[h - 1 - full] = mda_cell_make(CP437_LOWER_HALF_BLOCK, s->attr);
+            }
+        }
+        else if (level & 1) {   // trace: marker in the lower half of the cell
+            column[h - 1 - full] = mda_cell_make(CP437_LOWER_HALF_BLOCK, s->attr);
+        }
+        else {                  // trace: marker in the upper half of the cell below
+            column[h - full] = mda_cell_make(CP437_UPPER_HALF_BLOCK, s->attr);
+        }
+    }
+    mda_point_t p = mda_point_make(x, chart->bounds.y);
+    for (uint8_t r = 0; r < h; ++r, ++p.y) {
+        mda_write_cells(&p, &column[r], 1);
+    }
+}
+
+void mda_strip_chart_init(mda_strip_chart_t* chart, const mda_rect_t* bounds, uint8_t series_count,
+                          uint8_t decimate, mda_strip_reduce_t reduce) {
+    require_address(chart, "NULL strip chart!");
+    require_address(bounds, "NULL bounds!");
+    require(bounds->w > 0 && bounds->w <= MDA_COLUMNS, "INVALID strip chart width!");
+    require(bounds->h > 0 && bounds->h <= MDA_ROWS, "INVALID strip chart height!");
+    require(series_count > 0 && series_count <= MDA_STRIP_MAX_SERIES, "INVALID series count!");
+    require(decimate > 0, "INVALID decimation!");
+    chart->bounds = *bounds;
+    chart->blank = mda_cell_make(' ', MDA_NORMAL);
+    chart->series_count = series_count;
+    chart->decimate = decimate;
+    chart->pending = 0;
+    chart->reduce = reduce;
+    chart->head = 0;
+    chart->columns = 0;
+    for (uint8_t i = 0; i < series_count; ++i) {
+        mda_strip_chart_set_series(chart, i, 0, 100, MDA_NORMAL, false);
+    }
+}
+
+void mda_strip_chart_set_series(mda_strip_chart_t* chart, uint8_t i, int16_t min, int16_t max, uint8_t attr, bool fill) {
+    require_address(chart, "NULL strip chart!");
+    require(i < chart->series_count, "INVALID series!");
+    mda_strip_series_t* s = &chart->series[i];
+    s->min = min;
+    s->max = max;
+    s->attr = attr;
+    s->fill = fill;
+    s->sum = 0;
+    s->peak = 0;
+}
+
+void mda_strip_chart_push(mda_strip_chart_t* chart, const int16_t* values) {
+    require_address(chart, "NULL strip chart!");
+    require_address(values, "NULL values!");
+    int16_t column[MDA_STRIP_MAX_SERIES];
+    for (uint8_t i = 0; i < chart->series_count; ++i) {
+        mda_strip_series_t* s = &chart->series[i];
+        s->sum += values[i];
+        if (chart->pending == 0 || values[i] > s->peak) {
+            s->peak = values[i];
+        }
+    }
+    if (++chart->pending < chart->decimate) {
+        return;
+    }
+    for (uint8_t i = 0; i < chart->series_count; ++i) {   // close the bucket
+        mda_strip_series_t* s = &chart->series[i];
+        column[i] = (chart->reduce == MDA_STRIP_PEAK) ? s->peak : (int16_t)(s->sum / chart->decimate);
+        chart->history[i][chart->head] = column[i];
+        s->sum = 0;
+    }
+    chart->pending = 0;
+    chart->head = (chart->head + 1 == chart->bounds.w) ? 0 : chart->head + 1;
+    if (chart->columns < chart->bounds.w) {
+        chart->columns++;
+    }
+    if (chart->bounds.w > 1) {
+        mda_scroll_left(&chart->bounds, &chart->blank);
+    }
+    strip_render_column(chart, chart->bounds.x + chart->bounds.w - 1, column);
+}
+
+void mda_strip_chart_draw(mda_strip_chart_t* chart) {
+    require_address(chart, "NULL strip chart!");
+    uint8_t w = chart->bounds.w;
+    int16_t column[MDA_STRIP_MAX_SERIES];
+    for (uint8_t c = 0; c < w; ++c) {
+        uint8_t age = w - 1 - c;            // 0 = newest, at the right
+        if (age >= chart->columns) {
+            strip_render_column(chart, chart->bounds.x + c, NULL);
+            continue;
+        }
+        uint8_t slot = (chart->head + w - 1 - age) % w;
+        for (uint8_t i = 0; i < chart->series_count; ++i) {
+            column[i] = chart->history[i][slot];
+        }
+        strip_render_column(chart, chart->bounds.x + c, column);
+    }
+}
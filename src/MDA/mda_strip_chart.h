@@ -0,0 +1,102 @@
+/**
+ * @file mda_strip_chart.h
+ * @brief Streaming Strip Chart and Sparkline Widget
+ * @details Plots live metrics as a chart that scrolls right to left. Each
+ * column is one sample (or one decimated bucket of samples). When a column
+ * is committed the chart is shifted with mda_scroll_left() and only the
+ * newly exposed right hand column is rendered.
+ *
+ * Every series has its own value range and attribute and is drawn either
+ * as a trace (a half block marker at its level) or as a filled area (full
+ * blocks topped by a half block), later series over earlier ones, giving
+ * two vertical levels per text row. A chart one row high is a sparkline:
+ * the level is shown by density with the CP437 shades instead. Values at
+ * or below a series' minimum are drawn on the baseline, never left out.
+ *
+ * High-rate inputs are decimated: every n pushed samples are reduced to
+ * one column by mean or by peak, so the screen work per sample stays tiny.
+ * The last column of every series is kept in a ring so the chart can be
+ * redrawn at any time.
+ *
+ * @author Jeremy Thornton
+ */
+#ifndef MDA_STRIP_CHART_H
+#define MDA_STRIP_CHART_H
+
+#include "mda_cell.h"
+#include "mda_constants.h"
+#include "mda_types.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+#define MDA_STRIP_MAX_SERIES    4   /**< Series per chart */
+
+/**
+ * @enum mda_strip_reduce_t
+ * @brief How a bucket of decimated samples becomes one column.
+ */
+typedef enum {
+    MDA_STRIP_MEAN = 0,     /**< Average of the bucket */
+    MDA_STRIP_PEAK          /**< Largest sample, so spikes are never lost */
+} mda_strip_reduce_t;
+
+/**
+ * @struct mda_strip_series_t
+ * @brief Scale, style and bucket accumulator of one series.
+ */
+typedef struct {
+    int16_t min;            /**< Value at the bottom of the chart */
+    int16_t max;            /**< Value at the top of the chart */
+    uint8_t attr;           /**< Attribute distinguishing the series */
+    bool fill;              /**< true = filled area, false = trace */
+    int32_t sum;            /**< Bucket accumulator (mean) */
+    int16_t peak;           /**< Bucket accumulator (peak) */
+} mda_strip_series_t;
+
+/**
+ * @struct mda_strip_chart_t
+ * @brief State of one strip chart, including its column history.
+ */
+typedef struct {
+    mda_rect_t bounds;                                      /**< Screen rectangle of the chart */
+    mda_cell_t blank;                                       /**< Background cell */
+    uint8_t series_count;                                   /**< Series in use */
+    mda_strip_series_t series[MDA_STRIP_MAX_SERIES];        /**< Per series state */
+    uint8_t decimate;                                       /**< Samples per column */
+    uint8_t pending;                                        /**< Samples in the current bucket */
+    mda_strip_reduce_t reduce;                              /**< Bucket reduction */
+    uint8_t head;                                           /**< History slot of the next column */
+    uint8_t columns;                                        /**< Columns of history held (<= bounds.w) */
+    int16_t history[MDA_STRIP_MAX_SERIES][MDA_COLUMNS];     /**< Ring of committed column values */
+} mda_strip_chart_t;
+
+/**
+ * @brief Initialize an empty chart; series default to 0..100, normal trace.
+ * @param chart        Chart to initialize.
+ * @param bounds       Screen rectangle (caller clipped to 80x25).
+ * @param series_count Number of series (1..MDA_STRIP_MAX_SERIES).
+ * @param decimate     Samples reduced into each column (1 = no decimation).
+ * @param reduce       Bucket reduction when decimating.
+ */
+void mda_strip_chart_init(mda_strip_chart_t* chart, const mda_rect_t* bounds, uint8_t series_count,
+                          uint8_t decimate, mda_strip_reduce_t reduce);
+
+/**
+ * @brief Set the scale and style of series i.
+ */
+void mda_strip_chart_set_series(mda_strip_chart_t* chart, uint8_t i, int16_t min, int16_t max, uint8_t attr, bool fill);
+
+/**
+ * @brief Feed one sample per series.
+ * @details Every decimate-th call commits a column: scroll left one column
+ * and render the new right hand column only.
+ * @param values series_count values.
+ */
+void mda_strip_chart_push(mda_strip_chart_t* chart, const int16_t* values);
+
+/**
+ * @brief Redraw the whole chart from its history.
+ */
+void mda_strip_chart_draw(mda_strip_chart_t* chart);
+
+#endif /* MDA_STRIP_CHART_H */
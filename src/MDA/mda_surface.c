@@ -0,0 +1,162 @@
+/**
+ * @file mda_surface.c
+ * @brief Implementation of Memory-Backed Off-Screen Surfaces
+ * @details Surfaces are only ever mapped into EMS physical page 0. A
+ * surface is at most 4000 bytes, so starting a fresh page whenever the
+ * current one cannot hold the next surface wastes under 4 KB per page.
+ * @author Jeremy Thornton
+ */
+#include "mda_surface.h"
+#include "mda_primitives.h"
+#include "../CONTRACT/contract.h"
+#include <string.h>
+
+#define SURFACE_EMS_PHYSICAL    0   /**< Physical page used for surfaces */
+
+/**
+ * @brief Address of row y of an EMS surface, mapping its page if needed.
+ */
+static mda_cell_t* surface_ems_row(mda_surface_t* surface, uint8_t y) {
+    uint16_t page = (uint16_t)(surface->offset / MEM_EMS_PAGE_SIZE);
+    uint16_t within = (uint16_t)(surface->offset % MEM_EMS_PAGE_SIZE);
+    uint8_t* frame = mem_ems_map(&surface->store->ems, SURFACE_EMS_PHYSICAL, page);
+    return (mda_cell_t*)(frame + within) + (uint16_t)y * surface->w;
+}
+
+bool mda_surface_store_init(mda_surface_store_t* store, uint16_t kib, mda_surface_backing_t backing) {
+    require_address(store, "NULL surface store!");
+    require(kib > 0, "EMPTY surface store!");
+    store->used = 0;
+    if ((backing == MDA_SURFACE_ANY || backing == MDA_SURFACE_EMS) && mem_ems_detect()) {
+        uint16_t pages = (uint16_t)(((uint32_t)kib * 1024 + MEM_EMS_PAGE_SIZE - 1) / MEM_EMS_PAGE_SIZE);
+        if (mem_ems_alloc(&store->ems, pages)) {
+            store->backing = MDA_SURFACE_EMS;
+            store->size = (uint32_t)pages * MEM_EMS_PAGE_SIZE;
+            return true;
+        }
+    }
+    if ((backing == MDA_SURFACE_ANY || backing == MDA_SURFACE_XMS) && mem_xms_detect()) {
+        if (mem_xms_alloc(&store->xms, kib)) {
+            store->backing = MDA_SURFACE_XMS;
+            store->size = store->xms.bytes;
+            return true;
+        }
+    }
+    if ((backing == MDA_SURFACE_ANY || backing == MDA_SURFACE_ARENA) && kib < 1024) {
+        if (mem_arena_create(&store->arena, kib * (1024 / MEM_PARAGRAPH))) {
+            store->backing = MDA_SURFACE_ARENA;
+            store->size = (uint32_t)kib * 1024;
+            return true;
+        }
+    }
+    return false;
+}
+
+void mda_surface_store_release(mda_surface_store_t* store) {
+    require_address(store, "NULL surface store!");
+    switch (store->backing) {
+        case MDA_SURFACE_EMS:
+            mem_ems_free(&store->ems);
+            break;
+        case MDA_SURFACE_XMS:
+            mem_xms_free(&store->xms);
+            break;
+        case MDA_SURFACE_ARENA:
+            mem_arena_destroy(&store->arena);
+            break;
+        default:
+            break;
+    }
+    store->size = 0;
+    store->used = 0;
+}
+
+bool mda_surface_create(mda_surface_store_t* store, mda_surface_t* surface, uint8_t w, uint8_t h) {
+    require_address(store, "NULL surface store!");
+    require_address(surface, "NULL surface!");
+    require(w > 0 && w <= MDA_COLUMNS && h > 0 && h <= MDA_ROWS, "INVALID surface size!");
+    uint16_t bytes = (uint16_t)w * h * sizeof(mda_cell_t);
+    surface->store = store;
+    surface->w = w;
+    surface->h = h;
+    surface->cells = NULL;
+    uint32_t offset = store->used;
+    if (store->backing == MDA_SURFACE_EMS) {
+        uint16_t within = (uint16_t)(offset % MEM_EMS_PAGE_SIZE);
+        if (within + bytes > MEM_EMS_PAGE_SIZE) {   // never straddle a page
+            offset += MEM_EMS_PAGE_SIZE - within;
+        }
+    }
+    if (offset + bytes > store->size) {
+        return false;
+    }
+    if (store->backing == MDA_SURFACE_ARENA) {
+        surface->cells = mem_arena_alloc(&store->arena, bytes);
+        if (surface->cells == NULL) {
+            return false;
+        }
+    }
+    surface->offset = offset;
+    store->used = offset + bytes;                   // padding counts only once the surface exists
+    return true;
+}
+
+void mda_surface_capture(mda_surface_t* surface, const mda_rect_t* rect) {
+    require_address(surface, "NULL surface!");
+    require_address(rect, "NULL rectangle!");
+    require(rect->w == surface->w && rect->h == surface->h, "Surface size mismatch!");
+    uint16_t row_bytes = (uint16_t)surface->w * sizeof(mda_cell_t);
+    for (uint8_t y = 0; y < surface->h; ++y) {
+        mda_point_t p = mda_point_make(rect->x, rect->y + y);
+        const mda_cell_t* vram = mda_as_pointer(&p);
+        switch (surface->store->backing) {
+            case MDA_SURFACE_EMS:
+                memcpy(surface_ems_row(surface, y), vram, row_bytes);
+                break;
+            case MDA_SURFACE_XMS:
+                mem_xms_write(&surface->store->xms, surface->offset + (uint32_t)y * row_bytes, vram, row_bytes);
+                break;
+            default:
+                memcpy(surface->cells + (uint16_t)y * surface->w, vram, row_bytes);
+                break;
+        }
+    }
+}
+
+void mda_surface_present(mda_surface_t* surface, const mda_point_t* point) {
+    require_address(surface, "NULL surface!");
+    require_address(point, "NULL point!");
+    uint16_t row_bytes = (uint16_t)surface->w * sizeof(mda_cell_t);
+    for (uint8_t y = 0; y < surface->h; ++y) {
+        mda_point_t p = mda_point_make(point->x, point->y + y);
+        switch (surface->store->backing) {
+            case MDA_SURFACE_EMS:       // page already mapped after the first row
+                mda_write_cells(&p, surface_ems_row(surface, y), surface->w);
+                break;
+            case MDA_SURFACE_XMS:       // driver moves the row straight into VRAM
+                mem_xms_read(&surface->store->xms, surface->offset + (uint32_t)y * row_bytes, mda_as_pointer(&p), row_bytes);
+                break;
+            default:
+                mda_write_cells(&p, surface->cells + (uint16_t)y * surface->w, surface->w);
+                break;
+        }
+    }
+}
+
+void mda_surface_write_row(mda_surface_t* surface, uint8_t y, const mda_cell_t* cells) {
+    require_address(surface, "NULL surface!");
+    require_address(cells, "NULL cells!");
+    require(y < surface->h, "Row outside surface!");
+    uint16_t row_bytes = (uint16_t)surface->w * sizeof(mda_cell_t);
+    switch (surface->store->backing) {
+        case MDA_SURFACE_EMS:
+            memcpy(surface_ems_row(surface, y), cells, row_bytes);
+            break;
+        case MDA_SURFACE_XMS:
+            mem_xms_write(&surface->store->xms, surface->offset + (uint32_t)y * row_bytes, cells, row_bytes);
+            break;
+        default:
+            memcpy(surface->cells + (uint16_t)y * surface->w, cells, row_bytes);
+            break;
+    }
+}
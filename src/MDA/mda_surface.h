@@ -0,0 +1,104 @@
+/**
+ * @file mda_surface.h
+ * @brief Memory-Backed Off-Screen Surfaces
+ * @details A surface is a w x h block of cells kept in memory rather than
+ * in a file, used to cache saved screens, popups and pre-composed panels.
+ * Surfaces are carved from a store backed by one of:
+ * - EMS: surfaces never straddle a 16 KB page, so presenting or capturing
+ *   one maps a single page (skipped if it is already mapped) and moves
+ *   rows straight between the page frame and VRAM;
+ * - XMS: each row is one driver move directly between the EMB and VRAM;
+ * - arena: segment-aligned conventional memory from mem_arena_t.
+ *
+ * The store picks EMS, then XMS, then the arena unless told otherwise. The
+ * host build emulates EMS bank switching and XMS moves so every path can
+ * be exercised on Linux.
+ *
+ * @note Like the primitives, surface placement on screen is unbounded —
+ *       caller must clip.
+ * @author Jeremy Thornton
+ */
+#ifndef MDA_SURFACE_H
+#define MDA_SURFACE_H
+
+#include "mda_cell.h"
+#include "mda_constants.h"
+#include "mda_types.h"
+#include "../MEM/mem_arena.h"
+#include "../MEM/mem_ems.h"
+#include "../MEM/mem_xms.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * @enum mda_surface_backing_t
+ * @brief Where a store keeps its cells.
+ */
+typedef enum {
+    MDA_SURFACE_ANY = 0,    /**< Best available: EMS, XMS, then arena */
+    MDA_SURFACE_EMS,        /**< Expanded memory page frame */
+    MDA_SURFACE_XMS,        /**< Extended memory block */
+    MDA_SURFACE_ARENA       /**< Conventional far heap arena */
+} mda_surface_backing_t;
+
+/**
+ * @struct mda_surface_store_t
+ * @brief Backing memory shared by many surfaces, allocated by bumping.
+ */
+typedef struct {
+    mda_surface_backing_t backing;  /**< Backing in use */
+    uint32_t size;                  /**< Bytes available */
+    uint32_t used;                  /**< Bytes handed out, EMS page padding included, on every backing */
+    mem_arena_t arena;              /**< MDA_SURFACE_ARENA */
+    mem_ems_t ems;                  /**< MDA_SURFACE_EMS */
+    mem_xms_t xms;                  /**< MDA_SURFACE_XMS */
+} mda_surface_store_t;
+
+/**
+ * @struct mda_surface_t
+ * @brief One surface: its size and where its cells live in the store.
+ */
+typedef struct {
+    mda_surface_store_t* store;     /**< Owning store */
+    uint8_t w;                      /**< Width in cells */
+    uint8_t h;                      /**< Height in cells */
+    uint32_t offset;                /**< EMS/XMS: byte offset in the store */
+    mda_cell_t* cells;              /**< Arena: address of the cells */
+} mda_surface_t;
+
+/**
+ * @brief Reserve backing memory for surfaces.
+ * @param store   Store to initialize.
+ * @param kib     Budget in KiB (at most 1023 for the arena).
+ * @param backing Required backing, or MDA_SURFACE_ANY.
+ * @return true on success, false if no requested backing can supply the budget.
+ */
+bool mda_surface_store_init(mda_surface_store_t* store, uint16_t kib, mda_surface_backing_t backing);
+
+/**
+ * @brief Release the backing memory; every surface becomes invalid.
+ */
+void mda_surface_store_release(mda_surface_store_t* store);
+
+/**
+ * @brief Allocate a w x h surface from a store.
+ * @return true on success, false if the store is exhausted.
+ */
+bool mda_surface_create(mda_surface_store_t* store, mda_surface_t* surface, uint8_t w, uint8_t h);
+
+/**
+ * @brief Copy the screen area of rect (size must match the surface) into the surface.
+ */
+void mda_surface_capture(mda_surface_t* surface, const mda_rect_t* rect);
+
+/**
+ * @brief Copy the surface to the screen with its top left at point.
+ */
+void mda_surface_present(mda_surface_t* surface, const mda_point_t* point);
+
+/**
+ * @brief Replace row y of the surface, to compose it off screen.
+ */
+void mda_surface_write_row(mda_surface_t* surface, uint8_t y, const mda_cell_t* cells);
+
+#endif /* MDA_SURFACE_H */
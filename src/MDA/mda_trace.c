@@ -0,0 +1,203 @@
+/**
+ * @file mda_trace.c
+ * @brief Implementation of Primitive-Call Trace Capture
+ * @details One trace at a time, held in file scope like mda_vram_base. A
+ * depth count marks calls made from inside a traced call, which are not
+ * logged. The context state is noted again as each context call returns,
+ * so a context record is only written when the caller changed the context
+ * itself — moving the cursor by printing needs no record.
+ * @author Jeremy Thornton
+ */
+#include "mda_trace.h"
+#include "mda_constants.h"
+#include "mda_primitives.h"
+#include "../CONTRACT/contract.h"
+#include <stdio.h>
+#include <string.h>
+
+static FILE* trace_file;
+static uint8_t* trace_buffer;
+static uint16_t trace_size;
+static uint16_t trace_used;
+static uint8_t trace_depth;                             // traced calls in progress
+static bool trace_failed;
+static bool trace_has_context;                          // trace_context has been written
+static uint8_t trace_context[MDA_TRACE_CONTEXT_SIZE];   // context state as last written
+
+static const char* trace_names[MDA_TRACE_OPS] = {
+    "screen", "frame", "context", "load_rect",
+    "plot", "draw_hline", "draw_vline", "draw_hline_caps", "draw_vline_caps",
+    "draw_rect", "fill_rect", "draw_border", "write_cells", "write_attr", "fill_screen",
+    "scroll_up", "scroll_down", "scroll_left", "scroll_right", "hw_scroll_up", "hw_scroll_down",
+    "cursor_to", "BS", "HT", "LF", "VT", "FF", "CR", "DEL", "CRLF", "print_char", "print_string"
+};
+
+/**
+ * @brief Append n bytes to the write buffer, flushing when it fills.
+ */
+static void trace_write(const void* data, uint16_t n) {
+    if (trace_failed || n == 0) {
+        return;
+    }
+    if (trace_used + n > trace_size) {
+        trace_failed = fwrite(trace_buffer, 1, trace_used, trace_file) != trace_used;
+        trace_used = 0;
+    }
+    if (n > trace_size) {
+        trace_failed |= fwrite(data, 1, n, trace_file) != n;
+    }
+    else {
+        memcpy(trace_buffer + trace_used, data, n);
+        trace_used += n;
+    }
+}
+
+static void trace_op(mda_trace_op_t op) {
+    uint8_t byte = (uint8_t)op;
+    trace_write(&byte, 1);
+}
+
+/**
+ * @brief Append w cells of each of the rect's rows as they are on screen.
+ */
+static void trace_rect_cells(const mda_rect_t* rect) {
+    mda_point_t p = rect->origin;
+    for (uint8_t y = 0; y < rect->h; ++y, ++p.y) {
+        trace_write(mda_as_pointer(&p), rect->w * sizeof(mda_cell_t));
+    }
+}
+
+/**
+ * @brief Pack the context state a replay needs.
+ */
+static void trace_snapshot(const mda_context_t* ctx, uint8_t* state) {
+    state[0] = ctx->bounds.x;
+    state[1] = ctx->bounds.y;
+    state[2] = ctx->bounds.w;
+    state[3] = ctx->bounds.h;
+    state[4] = (uint8_t)ctx->attributes;
+    state[5] = (uint8_t)ctx->blank.chr;
+    state[6] = ctx->blank.attr;
+    state[7] = ctx->htab_size;
+    state[8] = ctx->vtab_size;
+    state[9] = ctx->cursor.column;
+    state[10] = ctx->cursor.row;
+    state[11] = ctx->hw_scroll;
+}
+
+bool mda_trace_open(const char* path, uint8_t* buffer, uint16_t size) {
+    require_address(path, "NULL path!");
+    require_address(buffer, "NULL buffer!");
+    require(size > 0, "INVALID buffer size!");
+    require(trace_file == NULL, "TRACE already open!");
+    trace_file = fopen(path, "wb");
+    if (trace_file == NULL) {
+        return false;
+    }
+    trace_buffer = buffer;
+    trace_size = size;
+    trace_used = 0;
+    trace_depth = 0;
+    trace_failed = false;
+    trace_has_context = false;
+    uint8_t header[MDA_TRACE_FILE_HEADER] = { 'M', 'D', 'A', 'T', MDA_TRACE_VERSION };
+    mda_rect_t screen = mda_rect_make(0, 0, MDA_COLUMNS, MDA_ROWS);
+    trace_write(header, MDA_TRACE_FILE_HEADER);
+    trace_op(MDA_TRACE_SCREEN);
+    trace_rect_cells(&screen);
+    return true;
+}
+
+void mda_trace_frame(void) {
+    if (trace_file == NULL) {
+        return;
+    }
+    uint16_t sum = mda_trace_checksum();
+    uint8_t bytes[2] = { (uint8_t)sum, (uint8_t)(sum >> 8) };
+    trace_op(MDA_TRACE_FRAME);
+    trace_write(bytes, 2);
+}
+
+bool mda_trace_close(void) {
+    require(trace_file != NULL, "TRACE not open!");
+    mda_trace_frame();
+    if (trace_used > 0 && !trace_failed) {
+        trace_failed = fwrite(trace_buffer, 1, trace_used, trace_file) != trace_used;
+    }
+    trace_failed |= fclose(trace_file) != 0;
+    trace_file = NULL;
+    return !trace_failed;
+}
+
+uint16_t mda_trace_checksum(void) {
+    uint16_t a = 0;
+    uint16_t b = 0;
+    mda_point_t p = mda_point_make(0, 0);
+    for (; p.y < MDA_ROWS; ++p.y) {
+        const uint8_t* bytes = (const uint8_t*)mda_as_pointer(&p);
+        for (uint8_t i = 0; i < MDA_ROW_BYTES; ++i) {
+            a = (a + bytes[i]) % 255;
+            b = (b + a) % 255;
+        }
+    }
+    return (b << 8) | a;
+}
+
+const char* mda_trace_op_name(mda_trace_op_t op) {
+    return (op < MDA_TRACE_OPS) ? trace_names[op] : "?";
+}
+
+void mda_trace_call(mda_trace_op_t op, const void* a, uint16_t na, const void* b, uint16_t nb,
+                    const void* c, uint16_t nc) {
+    if (trace_file == NULL) {
+        return;
+    }
+    if (trace_depth++ == 0) {
+        trace_op(op);
+        trace_write(a, na);
+        trace_write(b, nb);
+        trace_write(c, nc);
+    }
+}
+
+void mda_trace_context_call(mda_trace_op_t op, const mda_context_t* ctx, const void* a, uint16_t na) {
+    if (trace_file == NULL) {
+        return;
+    }
+    if (trace_depth == 0) {
+        uint8_t state[MDA_TRACE_CONTEXT_SIZE];
+        trace_snapshot(ctx, state);
+        if (!trace_has_context || memcmp(state, trace_context, MDA_TRACE_CONTEXT_SIZE) != 0) {
+            memcpy(trace_context, state, MDA_TRACE_CONTEXT_SIZE);
+            trace_has_context = true;
+            trace_op(MDA_TRACE_CONTEXT);
+            trace_write(state, MDA_TRACE_CONTEXT_SIZE);
+        }
+    }
+    mda_trace_call(op, a, na, NULL, 0, NULL, 0);
+}
+
+void mda_trace_loaded(const mda_rect_t* rect) {
+    if (trace_file == NULL || trace_depth > 0) {
+        return;
+    }
+    mda_rect_t screen = mda_rect_make(0, 0, MDA_COLUMNS, MDA_ROWS);
+    if (rect == NULL) {
+        rect = &screen;
+    }
+    trace_op(MDA_TRACE_LOAD_RECT);
+    trace_write(rect, sizeof(mda_rect_t));
+    trace_rect_cells(rect);
+}
+
+void mda_trace_leave(void) {
+    if (trace_depth > 0) {
+        trace_depth--;
+    }
+}
+
+void mda_trace_context_leave(const mda_context_t* ctx) {
+    if (trace_depth > 0 && --trace_depth == 0 && trace_file != NULL) {
+        trace_snapshot(ctx, trace_context);     // a replay ends the call in the same state
+    }
+}
@@ -0,0 +1,133 @@
+/**
+ * @file mda_trace.h
+ * @brief Primitive-Call Trace Capture
+ * @details Built with MDA_TRACE defined (cmake -DTUI_TRACE=ON), every
+ * public drawing primitive and console context function logs its call
+ * and arguments to a compact binary trace while one is open. The replay
+ * tool (TOOLS/replay.c) re-executes a trace, times each primitive and
+ * checks the screen checksums recorded with mda_trace_frame().
+ *
+ * Only the outermost call is logged: mda_print_string() is one record,
+ * not one per character and scroll, so a replay does the same work once.
+ * Without MDA_TRACE the hooks compile to nothing.
+ *
+ * Trace format: "MDAT", version, then records of an op byte followed by
+ * that op's arguments as they lie in memory (points x,y; rects x,y,w,h;
+ * cells character, attribute). Before a context function is logged a
+ * MDA_TRACE_CONTEXT record carries the context state, whenever it differs
+ * from the state a replay would have reached. The trace opens with the
+ * whole screen.
+ *
+ * @note Writes made through mda_as_pointer() bypass the trace; a frame
+ *       checksum shows when a workload relies on them.
+ * @author Jeremy Thornton
+ */
+#ifndef MDA_TRACE_H
+#define MDA_TRACE_H
+
+#include "mda_context.h"
+#include "mda_types.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+#define MDA_TRACE_MAGIC         "MDAT"
+#define MDA_TRACE_VERSION       1
+#define MDA_TRACE_FILE_HEADER   5       /**< Bytes: magic, version */
+#define MDA_TRACE_CONTEXT_SIZE  12      /**< Bytes of a context record */
+
+/**
+ * @enum mda_trace_op_t
+ * @brief Record type: a traced function, or trace bookkeeping.
+ */
+typedef enum {
+    MDA_TRACE_SCREEN = 0,   /**< The whole screen (4000 bytes) */
+    MDA_TRACE_FRAME,        /**< Screen checksum (16 bits) */
+    MDA_TRACE_CONTEXT,      /**< Context state */
+    MDA_TRACE_LOAD_RECT,    /**< rect, then the cells loaded into it */
+    MDA_TRACE_PLOT,
+    MDA_TRACE_HLINE,
+    MDA_TRACE_VLINE,
+    MDA_TRACE_HLINE_CAPS,
+    MDA_TRACE_VLINE_CAPS,
+    MDA_TRACE_DRAW_RECT,
+    MDA_TRACE_FILL_RECT,
+    MDA_TRACE_DRAW_BORDER,
+    MDA_TRACE_WRITE_CELLS,
+    MDA_TRACE_WRITE_ATTR,
+    MDA_TRACE_FILL_SCREEN,
+    MDA_TRACE_SCROLL_UP,
+    MDA_TRACE_SCROLL_DOWN,
+    MDA_TRACE_SCROLL_LEFT,
+    MDA_TRACE_SCROLL_RIGHT,
+    MDA_TRACE_HW_SCROLL_UP,
+    MDA_TRACE_HW_SCROLL_DOWN,
+    MDA_TRACE_CURSOR_TO,
+    MDA_TRACE_BS,
+    MDA_TRACE_HT,
+    MDA_TRACE_LF,
+    MDA_TRACE_VT,
+    MDA_TRACE_FF,
+    MDA_TRACE_CR,
+    MDA_TRACE_DEL,
+    MDA_TRACE_CRLF,
+    MDA_TRACE_PRINT_CHAR,
+    MDA_TRACE_PRINT_STRING, /**< Characters up to and including the NUL */
+    MDA_TRACE_OPS
+} mda_trace_op_t;
+
+/**
+ * @brief Start tracing to a new file.
+ * @param buffer Write buffer; a few KB keeps disk writes infrequent.
+ * @return false if the file cannot be created.
+ */
+bool mda_trace_open(const char* path, uint8_t* buffer, uint16_t size);
+
+/**
+ * @brief Record the checksum of the screen as it is now.
+ */
+void mda_trace_frame(void);
+
+/**
+ * @brief Record a final frame checksum and close the trace.
+ * @return false if any write failed.
+ */
+bool mda_trace_close(void);
+
+/**
+ * @brief Fletcher-16 checksum of the 4000 bytes on screen.
+ */
+uint16_t mda_trace_checksum(void);
+
+/**
+ * @brief Name of an op, for reports.
+ */
+const char* mda_trace_op_name(mda_trace_op_t op);
+
+/**
+ * @defgroup trace_hooks Hooks
+ * @brief Used by the traced functions through the macros below.
+ * @{
+ */
+void mda_trace_call(mda_trace_op_t op, const void* a, uint16_t na, const void* b, uint16_t nb,
+                    const void* c, uint16_t nc);
+void mda_trace_context_call(mda_trace_op_t op, const mda_context_t* ctx, const void* a, uint16_t na);
+void mda_trace_loaded(const mda_rect_t* rect);         ///< rect loaded from a file, NULL for the screen
+void mda_trace_leave(void);
+void mda_trace_context_leave(const mda_context_t* ctx);
+///@}
+
+#ifdef MDA_TRACE
+#define MDA_TRACE_CALL(op, a, na, b, nb, c, nc) mda_trace_call(op, a, na, b, nb, c, nc)
+#define MDA_TRACE_CONTEXT_CALL(op, ctx, a, na)  mda_trace_context_call(op, ctx, a, na)
+#define MDA_TRACE_LOADED(rect)                  mda_trace_loaded(rect)
+#define MDA_TRACE_LEAVE()                       mda_trace_leave()
+#define MDA_TRACE_CONTEXT_LEAVE(ctx)            mda_trace_context_leave(ctx)
+#else
+#define MDA_TRACE_CALL(op, a, na, b, nb, c, nc) ((void)0)
+#define MDA_TRACE_CONTEXT_CALL(op, ctx, a, na)  ((void)0)
+#define MDA_TRACE_LOADED(rect)                  ((void)0)
+#define MDA_TRACE_LEAVE()                       ((void)0)
+#define MDA_TRACE_CONTEXT_LEAVE(ctx)            ((void)0)
+#endif
+
+#endif /* MDA_TRACE_H */
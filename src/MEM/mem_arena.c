@@ -0,0 +1,94 @@
+/**
+ * @file mem_arena.c
+ * @brief Implementation of the Segment-Aligned Far Heap Arena
+ * @author Jeremy Thornton
+ */
+#include "mem_arena.h"
+#include "../CONTRACT/contract.h"
+#include <stdlib.h>
+
+#ifdef __DOS__
+/**
+ * @brief INT 21h, 48h - Allocate memory.
+ * @return Segment of the block, or 0 on failure.
+ */
+static uint16_t dos_allocate(uint16_t paragraphs) {
+    uint16_t segment = 0;
+    __asm {
+        .8086
+        mov  ah, 48h
+        mov  bx, paragraphs ; BX = paragraphs requested
+        int  21h
+        jc   FAIL           ; CF set: AX = error, BX = largest block
+        mov  segment, ax
+FAIL:
+    }
+    return segment;
+}
+
+/**
+ * @brief INT 21h, 49h - Free memory.
+ */
+static void dos_free(uint16_t segment) {
+    __asm {
+        .8086
+        push es
+        mov  ah, 49h
+        mov  es, segment    ; ES = segment of block
+        int  21h
+        pop  es
+    }
+}
+#endif
+
+bool mem_arena_create(mem_arena_t* arena, uint16_t paragraphs) {
+    require_address(arena, "NULL arena!");
+    require(paragraphs > 0, "EMPTY arena!");
+    arena->paragraphs = 0;
+    arena->used = 0;
+#ifdef __DOS__
+    arena->segment = dos_allocate(paragraphs);
+    if (arena->segment == 0) {
+        return false;
+    }
+    arena->base = (uint8_t*)((uint32_t)arena->segment << 16);
+#else
+    arena->segment = 0;
+    arena->base = malloc((size_t)paragraphs * MEM_PARAGRAPH);
+    if (arena->base == NULL) {
+        return false;
+    }
+#endif
+    arena->paragraphs = paragraphs;
+    return true;
+}
+
+void mem_arena_destroy(mem_arena_t* arena) {
+    require_address(arena, "NULL arena!");
+    if (arena->paragraphs == 0) {
+        return;
+    }
+#ifdef __DOS__
+    dos_free(arena->segment);
+#else
+    free(arena->base);
+#endif
+    arena->base = NULL;
+    arena->paragraphs = 0;
+    arena->used = 0;
+}
+
+void* mem_arena_alloc(mem_arena_t* arena, uint16_t bytes) {
+    require_address(arena, "NULL arena!");
+    uint16_t need = (uint16_t)(((uint32_t)bytes + MEM_PARAGRAPH - 1) / MEM_PARAGRAPH);
+    if (need == 0 || need > mem_arena_available(arena)) {
+        return NULL;
+    }
+    uint16_t first = arena->used;
+    arena->used += need;
+#ifdef __DOS__
+    return (void*)((uint32_t)(arena->segment + first) << 16);   // segment:0000
+#else
+    return arena->base + (size_t)first * MEM_PARAGRAPH;
+#endif
+}
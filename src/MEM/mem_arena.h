@@ -0,0 +1,67 @@
+/**
+ * @file mem_arena.h
+ * @brief Segment-Aligned Far Heap Arena
+ * @details One block of conventional memory is taken from DOS
+ * (INT 21h, 48h) and handed out by bumping a paragraph counter. Every
+ * allocation starts at offset 0 of its own segment, so a buffer of up to
+ * 64 KB can be walked with a plain offset and never normalizes.
+ *
+ * The whole arena is released at once; individual allocations are not
+ * freed. On the host build the block comes from malloc().
+ *
+ * @author Jeremy Thornton
+ */
+#ifndef MEM_ARENA_H
+#define MEM_ARENA_H
+
+#include "mem_segoff_t.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * @struct mem_arena_t
+ * @brief A block of paragraphs and how many have been handed out.
+ */
+typedef struct {
+    uint16_t segment;       /**< First paragraph of the block (DOS) */
+    uint8_t* base;          /**< Address of the first paragraph */
+    uint16_t paragraphs;    /**< Size of the block */
+    uint16_t used;          /**< Paragraphs handed out */
+} mem_arena_t;
+
+/**
+ * @brief Reserve a block of conventional memory.
+ * @param arena      Arena to initialize.
+ * @param paragraphs Size of the block in 16 byte paragraphs.
+ * @return true on success, false if DOS cannot supply the block.
+ */
+bool mem_arena_create(mem_arena_t* arena, uint16_t paragraphs);
+
+/**
+ * @brief Return the block to DOS; every allocation becomes invalid.
+ */
+void mem_arena_destroy(mem_arena_t* arena);
+
+/**
+ * @brief Allocate a segment-aligned buffer.
+ * @param arena Arena to allocate from.
+ * @param bytes Size of the buffer, rounded up to whole paragraphs.
+ * @return Pointer to offset 0 of a fresh segment, or NULL if exhausted.
+ */
+void* mem_arena_alloc(mem_arena_t* arena, uint16_t bytes);
+
+/**
+ * @brief Forget every allocation, keeping the block.
+ */
+static inline void mem_arena_reset(mem_arena_t* arena) {
+    arena->used = 0;
+}
+
+/**
+ * @brief Paragraphs still available.
+ */
+static inline uint16_t mem_arena_available(const mem_arena_t* arena) {
+    return arena->paragraphs - arena->used;
+}
+
+#endif /* MEM_ARENA_H */
@@ -0,0 +1,180 @@
+/**
+ * @file mem_ems.c
+ * @brief Implementation of LIM EMS Access
+ * @author Jeremy Thornton
+ */
+#include "mem_ems.h"
+#include "../CONTRACT/contract.h"
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * @struct ems_page_t
+ * @brief Owner of a physical page of the frame, shared by all allocations.
+ */
+typedef struct {
+    uint16_t handle;
+    uint16_t logical;       /**< MEM_EMS_UNMAPPED if no allocation's page is known to be there */
+#ifndef __DOS__
+    uint8_t* store;         /**< Owner's emulated memory, to bank the page out to */
+#endif
+} ems_page_t;
+
+#ifdef __DOS__
+#define EMS_PAGE_FREE   { 0, MEM_EMS_UNMAPPED }
+#else
+#define EMS_PAGE_FREE   { 0, MEM_EMS_UNMAPPED, NULL }
+#endif
+
+static ems_page_t ems_pages[MEM_EMS_PHYSICAL_PAGES] = {
+    EMS_PAGE_FREE, EMS_PAGE_FREE, EMS_PAGE_FREE, EMS_PAGE_FREE
+};
+
+static bool ems_in_place(const mem_ems_t* ems, uint8_t physical, uint16_t logical) {
+    return ems_pages[physical].handle == ems->handle && ems_pages[physical].logical == logical;
+}
+
+/**
+ * @brief Forget the pages of a released handle; the driver may give it out again.
+ */
+static void ems_release(const mem_ems_t* ems) {
+    for (uint8_t i = 0; i < MEM_EMS_PHYSICAL_PAGES; ++i) {
+        if (ems_pages[i].handle == ems->handle) {
+            ems_pages[i].logical = MEM_EMS_UNMAPPED;
+        }
+    }
+}
+
+#ifdef __DOS__
+bool mem_ems_detect(void) {
+    static const char name[] = "EMMXXXX0";
+    uint16_t segment = 0;
+    uint8_t status = 0xFF;
+    __asm {
+        .8086
+        push es
+        mov  ax, 3567h      ; get INT 67h vector
+        int  21h
+        mov  segment, es    ; driver header segment
+        pop  es
+    }
+    if (memcmp((const char*)(((uint32_t)segment << 16) | 0x000A), name, 8) != 0) {
+        return false;       // no device named EMMXXXX0 behind the vector
+    }
+    __asm {
+        .8086
+        mov  ah, 40h        ; get status
+        int  MEM_EMS_INT
+        mov  status, ah
+    }
+    return status == 0;
+}
+
+bool mem_ems_alloc(mem_ems_t* ems, uint16_t pages) {
+    require_address(ems, "NULL ems!");
+    uint16_t frame = 0;
+    uint16_t handle = 0;
+    uint8_t status = 0xFF;
+    __asm {
+        .8086
+        mov  ah, 41h        ; get page frame segment
+        int  MEM_EMS_INT
+        or   ah, ah
+        jnz  FAIL
+        mov  frame, bx
+        mov  ah, 43h        ; allocate pages
+        mov  bx, pages
+        int  MEM_EMS_INT
+        mov  handle, dx
+FAIL:   mov  status, ah
+    }
+    if (status != 0) {
+        return false;
+    }
+    ems->handle = handle;
+    ems->pages = pages;
+    ems->frame = (uint8_t*)((uint32_t)frame << 16);
+    return true;
+}
+
+void mem_ems_free(mem_ems_t* ems) {
+    require_address(ems, "NULL ems!");
+    uint16_t handle = ems->handle;
+    __asm {
+        .8086
+        mov  ah, 45h        ; deallocate pages
+        mov  dx, handle
+        int  MEM_EMS_INT
+    }
+    ems_release(ems);
+    ems->pages = 0;
+}
+
+uint8_t* mem_ems_map(mem_ems_t* ems, uint8_t physical, uint16_t logical) {
+    require_address(ems, "NULL ems!");
+    require(physical < MEM_EMS_PHYSICAL_PAGES, "INVALID physical page!");
+    require(logical < ems->pages, "INVALID logical page!");
+    if (!ems_in_place(ems, physical, logical)) {
+        uint16_t handle = ems->handle;
+        uint8_t status = 0xFF;
+        __asm {
+            .8086
+            mov  ah, 44h        ; map handle page
+            mov  al, physical
+            mov  bx, logical
+            mov  dx, handle
+            int  MEM_EMS_INT
+            mov  status, ah
+        }
+        ensure(status == 0, "FAIL to map EMS page!");
+        ems_pages[physical].handle = handle;
+        ems_pages[physical].logical = logical;
+    }
+    return ems->frame + (uint16_t)physical * MEM_EMS_PAGE_SIZE;
+}
+#else
+static uint8_t ems_frame[MEM_EMS_PHYSICAL_PAGES * MEM_EMS_PAGE_SIZE];  // emulated page frame
+static uint16_t ems_handles;                                            // handles given out, as the driver numbers them
+
+bool mem_ems_detect(void) {
+    return true;
+}
+
+bool mem_ems_alloc(mem_ems_t* ems, uint16_t pages) {
+    require_address(ems, "NULL ems!");
+    ems->store = calloc(pages, MEM_EMS_PAGE_SIZE);
+    if (ems->store == NULL) {
+        return false;
+    }
+    ems->handle = ++ems_handles;
+    ems->pages = pages;
+    ems->frame = ems_frame;
+    return true;
+}
+
+void mem_ems_free(mem_ems_t* ems) {
+    require_address(ems, "NULL ems!");
+    ems_release(ems);       // its pages in the frame are dropped, not banked out
+    free(ems->store);
+    ems->store = NULL;
+    ems->pages = 0;
+}
+
+uint8_t* mem_ems_map(mem_ems_t* ems, uint8_t physical, uint16_t logical) {
+    require_address(ems, "NULL ems!");
+    require(physical < MEM_EMS_PHYSICAL_PAGES, "INVALID physical page!");
+    require(logical < ems->pages, "INVALID logical page!");
+    uint8_t* window = ems->frame + (size_t)physical * MEM_EMS_PAGE_SIZE;
+    ems_page_t* page = &ems_pages[physical];
+    if (!ems_in_place(ems, physical, logical)) {
+        if (page->logical != MEM_EMS_UNMAPPED) {    // bank out, to whichever allocation owns it
+            memcpy(page->store + (size_t)page->logical * MEM_EMS_PAGE_SIZE, window, MEM_EMS_PAGE_SIZE);
+        }
+        memcpy(window, ems->store + (size_t)logical * MEM_EMS_PAGE_SIZE, MEM_EMS_PAGE_SIZE);   // bank in
+        page->handle = ems->handle;
+        page->logical = logical;
+        page->store = ems->store;
+    }
+    return window;
+}
+#endif
@@ -0,0 +1,69 @@
+/**
+ * @file mem_ems.h
+ * @brief LIM EMS (INT 67h) Expanded Memory Access
+ * @details Expanded memory is reached through a 64 KB page frame in the
+ * upper memory area, split into four 16 KB physical pages. Any 16 KB
+ * logical page of an allocation can be mapped into any physical page.
+ *
+ * The frame is shared by every allocation, so the owner (handle and
+ * logical page) of each physical page is remembered globally: mapping a
+ * page that this allocation already put in place costs no driver call, and
+ * a page mapped since by another allocation is mapped again.
+ *
+ * On the host build the driver is emulated: logical pages live in a heap
+ * block and mapping copies the outgoing page back and the incoming page
+ * into a local page frame, exactly like bank switching from the caller's
+ * point of view.
+ *
+ * @author Jeremy Thornton
+ */
+#ifndef MEM_EMS_H
+#define MEM_EMS_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define MEM_EMS_INT             67h     /**< EMM interrupt (use in __asm) */
+#define MEM_EMS_PAGE_SIZE       16384   /**< Bytes per page */
+#define MEM_EMS_PHYSICAL_PAGES  4       /**< Pages in the page frame */
+#define MEM_EMS_UNMAPPED        0xFFFF  /**< No logical page in a physical page */
+
+/**
+ * @struct mem_ems_t
+ * @brief One EMS allocation.
+ */
+typedef struct {
+    uint16_t handle;                            /**< EMM handle */
+    uint16_t pages;                             /**< Logical pages allocated */
+    uint8_t* frame;                             /**< Address of physical page 0 */
+#ifndef __DOS__
+    uint8_t* store;                             /**< Emulated expanded memory */
+#endif
+} mem_ems_t;
+
+/**
+ * @brief true if an expanded memory manager is installed and working.
+ */
+bool mem_ems_detect(void);
+
+/**
+ * @brief Allocate logical pages.
+ * @return true on success.
+ */
+bool mem_ems_alloc(mem_ems_t* ems, uint16_t pages);
+
+/**
+ * @brief Release the allocation.
+ */
+void mem_ems_free(mem_ems_t* ems);
+
+/**
+ * @brief Map a logical page into a physical page of the frame.
+ * @param ems      Allocation.
+ * @param physical Physical page (0..3).
+ * @param logical  Logical page of the allocation.
+ * @return Address of the physical page now holding the logical page.
+ */
+uint8_t* mem_ems_map(mem_ems_t* ems, uint8_t physical, uint16_t logical);
+
+#endif /* MEM_EMS_H */
@@ -1 +1,39 @@
+/**
+ * @file mem_segoff_t.h
+ * @brief Real Mode Segment:Offset Address
+ * @details Layout matches a far pointer in memory (offset low word,
+ * segment high word), which is also how XMS and EMS drivers take
+ * conventional memory addresses.
+ * @author Jeremy Thornton
+ */
+#ifndef MEM_SEGOFF_T_H
+#define MEM_SEGOFF_T_H
 
+#include <stdint.h>
+
+#define MEM_PARAGRAPH       16      /**< Bytes per paragraph (segment granularity) */
+
+/**
+ * @union mem_segoff_t
+ * @brief Segment:offset pair, or the same 32 bits packed.
+ */
+typedef union {
+    uint32_t packed;        /**< segment << 16 | offset */
+    struct {
+        uint16_t offset;    /**< Offset within segment */
+        uint16_t segment;   /**< Paragraph number */
+    };
+} mem_segoff_t;
+
+static inline mem_segoff_t mem_segoff_make(uint16_t segment, uint16_t offset) {
+    mem_segoff_t so;
+    so.segment = segment;
+    so.offset = offset;
+    return so;
+}
+
+static inline uint32_t mem_segoff_linear(mem_segoff_t so) {
+    return ((uint32_t)so.segment << 4) + so.offset;  /**< 20-bit physical address */
+}
+
+#endif /* MEM_SEGOFF_T_H */
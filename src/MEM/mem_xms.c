@@ -0,0 +1,171 @@
+/**
+ * @file mem_xms.c
+ * @brief Implementation of XMS Extended Memory Blocks
+ * @author Jeremy Thornton
+ */
+#include "mem_xms.h"
+#include "../CONTRACT/contract.h"
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef __DOS__
+/**
+ * @struct xms_move_t
+ * @brief Extended Memory Move Structure (function 0Bh).
+ * @details A handle of 0 means the offset is a real mode segment:offset.
+ */
+#pragma pack(push, 1)
+typedef struct {
+    uint32_t length;        /**< Bytes to move (even) */
+    uint16_t src_handle;    /**< Source handle, 0 = conventional */
+    uint32_t src_offset;    /**< Offset into source block, or seg:off */
+    uint16_t dst_handle;    /**< Destination handle, 0 = conventional */
+    uint32_t dst_offset;    /**< Offset into destination block, or seg:off */
+} xms_move_t;
+#pragma pack(pop)
+
+static uint32_t xms_entry = 0;     /**< Driver entry point (seg:off) */
+
+bool mem_xms_detect(void) {
+    uint8_t installed = 0;
+    uint32_t entry = 0;
+    __asm {
+        .8086
+        push es
+        mov  ax, 4300h      ; XMS installation check
+        int  2Fh
+        cmp  al, 80h
+        jne  NONE
+        mov  installed, 1
+        mov  ax, 4310h      ; get driver entry point
+        int  2Fh
+        mov  word ptr entry, bx
+        mov  word ptr entry+2, es
+NONE:   pop  es
+    }
+    xms_entry = entry;
+    return installed != 0;
+}
+
+/**
+ * @brief Call the driver with AH = function, DX = argument.
+ * @return AX from the driver (1 = success for most functions); *dx receives DX.
+ */
+static uint16_t xms_call(uint8_t function, uint16_t* dx) {
+    uint32_t entry = xms_entry;     // copy: globals are not reachable once DS moves
+    uint16_t arg = *dx;
+    uint16_t result = 0;
+    uint16_t out = 0;
+    __asm {
+        .8086
+        mov  ah, function
+        mov  dx, arg
+        call dword ptr entry
+        mov  result, ax
+        mov  out, dx
+    }
+    *dx = out;
+    return result;
+}
+
+/**
+ * @brief Function 0Bh - Move extended memory block.
+ */
+static bool xms_move(xms_move_t* move) {
+    uint32_t entry = xms_entry;
+    uint16_t result = 0;
+    __asm {
+        .8086
+        push ds
+        lds  si, move       ; DS:SI *move structure
+        mov  ah, 0Bh
+        call dword ptr entry
+        pop  ds
+        mov  result, ax
+    }
+    return result == 1;
+}
+
+bool mem_xms_alloc(mem_xms_t* xms, uint16_t kib) {
+    require_address(xms, "NULL xms!");
+    require(xms_entry != 0, "XMS not detected!");
+    uint16_t dx = kib;
+    if (xms_call(0x09, &dx) != 1) {    // allocate extended memory block
+        return false;
+    }
+    xms->handle = dx;
+    xms->bytes = (uint32_t)kib * 1024;
+    return true;
+}
+
+void mem_xms_free(mem_xms_t* xms) {
+    require_address(xms, "NULL xms!");
+    uint16_t dx = xms->handle;
+    xms_call(0x0A, &dx);                // free extended memory block
+    xms->bytes = 0;
+}
+
+bool mem_xms_read(const mem_xms_t* xms, uint32_t offset, void* dst, uint16_t bytes) {
+    require_address(xms, "NULL xms!");
+    require((bytes & 1) == 0, "ODD XMS move!");
+    require(offset + bytes <= xms->bytes, "XMS read out of range!");
+    xms_move_t move;
+    move.length = bytes;
+    move.src_handle = xms->handle;
+    move.src_offset = offset;
+    move.dst_handle = 0;
+    move.dst_offset = (uint32_t)dst;    // far pointer is seg:off
+    return xms_move(&move);
+}
+
+bool mem_xms_write(const mem_xms_t* xms, uint32_t offset, const void* src, uint16_t bytes) {
+    require_address(xms, "NULL xms!");
+    require((bytes & 1) == 0, "ODD XMS move!");
+    require(offset + bytes <= xms->bytes, "XMS write out of range!");
+    xms_move_t move;
+    move.length = bytes;
+    move.src_handle = 0;
+    move.src_offset = (uint32_t)src;
+    move.dst_handle = xms->handle;
+    move.dst_offset = offset;
+    return xms_move(&move);
+}
+#else
+bool mem_xms_detect(void) {
+    return true;
+}
+
+bool mem_xms_alloc(mem_xms_t* xms, uint16_t kib) {
+    require_address(xms, "NULL xms!");
+    xms->store = calloc(kib, 1024);
+    if (xms->store == NULL) {
+        return false;
+    }
+    xms->handle = 1;
+    xms->bytes = (uint32_t)kib * 1024;
+    return true;
+}
+
+void mem_xms_free(mem_xms_t* xms) {
+    require_address(xms, "NULL xms!");
+    free(xms->store);
+    xms->store = NULL;
+    xms->bytes = 0;
+}
+
+bool mem_xms_read(const mem_xms_t* xms, uint32_t offset, void* dst, uint16_t bytes) {
+    require_address(xms, "NULL xms!");
+    require((bytes & 1) == 0, "ODD XMS move!");
+    require(offset + bytes <= xms->bytes, "XMS read out of range!");
+    memcpy(dst, xms->store + offset, bytes);
+    return true;
+}
+
+bool mem_xms_write(const mem_xms_t* xms, uint32_t offset, const void* src, uint16_t bytes) {
+    require_address(xms, "NULL xms!");
+    require((bytes & 1) == 0, "ODD XMS move!");
+    require(offset + bytes <= xms->bytes, "XMS write out of range!");
+    memcpy(xms->store + offset, src, bytes);
+    return true;
+}
+#endif
@@ -0,0 +1,59 @@
+/**
+ * @file mem_xms.h
+ * @brief XMS (HIMEM) Extended Memory Blocks
+ * @details Extended memory cannot be addressed from real mode; the XMS
+ * driver copies between an extended memory block (EMB) and conventional
+ * memory, including video memory, with its Move function. A move can
+ * therefore go straight from an EMB to B000h without a bounce buffer.
+ *
+ * On the host build blocks are heap allocations and moves are memcpy().
+ *
+ * @author Jeremy Thornton
+ */
+#ifndef MEM_XMS_H
+#define MEM_XMS_H
+
+#include "mem_segoff_t.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * @struct mem_xms_t
+ * @brief One extended memory block.
+ */
+typedef struct {
+    uint16_t handle;        /**< XMS handle */
+    uint32_t bytes;         /**< Size of the block */
+#ifndef __DOS__
+    uint8_t* store;         /**< Emulated extended memory */
+#endif
+} mem_xms_t;
+
+/**
+ * @brief true if an XMS driver is installed; also locates its entry point.
+ */
+bool mem_xms_detect(void);
+
+/**
+ * @brief Allocate an extended memory block.
+ * @param xms Block to initialize.
+ * @param kib Size in KiB.
+ * @return true on success.
+ */
+bool mem_xms_alloc(mem_xms_t* xms, uint16_t kib);
+
+/**
+ * @brief Release the block.
+ */
+void mem_xms_free(mem_xms_t* xms);
+
+/**
+ * @defgroup xms_move Block Moves
+ * @brief Copy between the block and conventional memory; bytes must be even.
+ * @{
+ */
+bool mem_xms_read(const mem_xms_t* xms, uint32_t offset, void* dst, uint16_t bytes);          ///< Block -> conventional
+bool mem_xms_write(const mem_xms_t* xms, uint32_t offset, const void* src, uint16_t bytes);   ///< Conventional -> block
+///@}
+
+#endif /* MEM_XMS_H */
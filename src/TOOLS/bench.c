@@ -0,0 +1,344 @@
+/**
+ * @file bench.c
+ * @brief Macro Benchmark Scenarios
+ * @details Times whole frames of typical TUI workloads on the host build,
+ * headless, where single primitive timings (REPLAY) do not show how a frame
+ * behaves:
+ *
+ *   log_console  a line a frame through mda_print_string() and mda_LF(), scrolling
+ *   menu         the highlight moved up and down a menu with mda_write_attr()
+ *   window_drag  a bordered window dragged over a busy background, restored behind it
+ *   dashboard    every panel, figure and bar of a dashboard redrawn each frame
+ *   form_entry   keys typed into the line editors of a form, Tab to the next field
+ *
+ * Random choices come from a generator seeded with -s, so a run repeats
+ * exactly and results compare across commits.
+ *
+ * Usage: BENCH [-n frames] [-s seed] [scenario ...]
+ *
+ * Per scenario prints frames, frames per second, the median and 99th
+ * percentile frame time, and cells per frame: the cells that differ from
+ * the frame before, the cells a presenter sends.
+ *
+ * @author Jeremy Thornton
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "../BIOS/bios_keyboard_constants.h"
+#include "../MDA/mda_border.h"
+#include "../MDA/mda_context.h"
+#include "../MDA/mda_line_edit.h"
+#include "../MDA/mda_primitives.h"
+#include "../MDA/mda_printf.h"
+#include "../MDA/cp437_constants.h"
+#include "../HOST/host_screen.h"
+
+#define BENCH_FRAMES        2000
+#define BENCH_FRAMES_MAX    1000000UL
+#define BENCH_SEED          0x4D444121UL
+#define BENCH_MENU_X        30
+#define BENCH_MENU_Y        5
+#define BENCH_MENU_W        20
+#define BENCH_MENU_ITEMS    14
+#define BENCH_WINDOW_W      34
+#define BENCH_WINDOW_H      11
+#define BENCH_FIELDS        5
+#define BENCH_FIELD_W       40
+
+/**
+ * @struct bench_scenario_t
+ * @brief Setup, untimed, and the step that draws one frame.
+ */
+typedef struct {
+    const char* name;
+    void (*setup)(mda_context_t* ctx);
+    void (*frame)(mda_context_t* ctx, uint32_t i);
+} bench_scenario_t;
+
+static uint32_t bench_random_state;
+static mda_cell_t bench_previous[MDA_SCREEN_WORDS];
+static mda_cell_t bench_background[MDA_SCREEN_WORDS];
+static uint32_t* bench_ns;
+
+/**
+ * @brief xorshift32: the same sequence for the same seed on every host.
+ */
+static uint32_t bench_random(uint32_t n) {
+    uint32_t x = bench_random_state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    bench_random_state = x;
+    return x % n;
+}
+
+static uint64_t bench_clock_ns(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000000ULL + (uint64_t)now.tv_nsec;
+}
+
+static void bench_log_setup(mda_context_t* ctx) {
+    (void)ctx;
+}
+
+static void bench_log_frame(mda_context_t* ctx, uint32_t i) {
+    static const char* levels[] = { "INFO ", "WARN ", "DEBUG", "ERROR" };
+    char line[MDA_COLUMNS];
+    snprintf(line, sizeof(line), "%08lu %s unit %02lu reading %5lu", (unsigned long)i,
+             levels[bench_random(4)], (unsigned long)bench_random(64), (unsigned long)bench_random(100000));
+    ctx->attributes = (line[9] == 'E') ? MDA_NORMAL | MDA_BOLD : MDA_NORMAL;
+    mda_print_string(ctx, line);
+    mda_CR(ctx);
+    mda_LF(ctx);
+}
+
+static uint8_t bench_menu_selected;
+
+static void bench_menu_setup(mda_context_t* ctx) {
+    mda_rect_t r = mda_rect_make(BENCH_MENU_X - 1, BENCH_MENU_Y - 1, BENCH_MENU_W + 2, BENCH_MENU_ITEMS + 2);
+    mda_border_rect(&r, MDA_BORDER_DOUBLE, MDA_BORDER_DOUBLE, ctx->attributes);
+    for (uint8_t i = 0; i < BENCH_MENU_ITEMS; ++i) {
+        mda_point_t p = mda_point_make(BENCH_MENU_X, BENCH_MENU_Y + i);
+        mda_printf_at(&p, BENCH_MENU_W, ctx->attributes, " Menu item %-9u", i + 1);
+    }
+    bench_menu_selected = 0;
+    mda_point_t p = mda_point_make(BENCH_MENU_X, BENCH_MENU_Y);
+    mda_write_attr(&p, MDA_REVERSE, BENCH_MENU_W);
+}
+
+static void bench_menu_frame(mda_context_t* ctx, uint32_t i) {
+    (void)i;
+    mda_point_t p = mda_point_make(BENCH_MENU_X, BENCH_MENU_Y + bench_menu_selected);
+    mda_write_attr(&p, ctx->attributes, BENCH_MENU_W);
+    switch (bench_random(8)) {
+    case 0:
+        bench_menu_selected = 0;                                    // Home
+        break;
+    case 1:
+        bench_menu_selected = BENCH_MENU_ITEMS - 1;                 // End
+        break;
+    case 2:
+    case 3:
+    case 4:
+        bench_menu_selected = (bench_menu_selected + BENCH_MENU_ITEMS - 1) % BENCH_MENU_ITEMS;
+        break;
+    default:
+        bench_menu_selected = (bench_menu_selected + 1) % BENCH_MENU_ITEMS;
+        break;
+    }
+    p.y = BENCH_MENU_Y + bench_menu_selected;
+    mda_write_attr(&p, MDA_REVERSE, BENCH_MENU_W);
+}
+
+static mda_rect_t bench_window;
+
+static void bench_window_draw(mda_context_t* ctx) {
+    mda_cell_t fill = mda_cell_make(' ', MDA_NORMAL);
+    mda_rect_t inner = mda_rect_inner(&bench_window);
+    mda_fill_rect(&inner, &fill);
+    mda_border_rect(&bench_window, MDA_BORDER_DOUBLE, MDA_BORDER_SINGLE, ctx->attributes);
+    mda_point_t p = mda_point_make(bench_window.x + 2, bench_window.y);
+    mda_printf_at(&p, BENCH_WINDOW_W - 4, MDA_REVERSE, " Window at %2u,%2u ", bench_window.x, bench_window.y);
+}
+
+static void bench_window_setup(mda_context_t* ctx) {
+    static const char busy[] = { CP437_LIGHT_SHADE, CP437_MEDIUM_SHADE, '#', '.', '+', 'x' };
+    mda_cell_t* screen = host_screen_cells();
+    for (uint16_t i = 0; i < MDA_SCREEN_WORDS; ++i) {
+        screen[i] = mda_cell_make(busy[bench_random(sizeof(busy))], bench_random(4) ? MDA_NORMAL : MDA_NORMAL | MDA_BOLD);
+    }
+    memcpy(bench_background, screen, sizeof(bench_background));
+    bench_window = mda_rect_make(10, 5, BENCH_WINDOW_W, BENCH_WINDOW_H);
+    bench_window_draw(ctx);
+}
+
+static void bench_window_frame(mda_context_t* ctx, uint32_t i) {
+    (void)i;
+    mda_point_t p = bench_window.origin;
+    for (uint8_t y = 0; y < bench_window.h; ++y, ++p.y) {      // restore what the window covered
+        mda_write_cells(&p, bench_background + p.y * MDA_COLUMNS + p.x, bench_window.w);
+    }
+    int x = bench_window.x + (int)bench_random(5) - 2;
+    int y = bench_window.y + (int)bench_random(3) - 1;
+    bench_window.x = (x < 0) ? 0 : (x > MDA_COLUMNS - BENCH_WINDOW_W) ? MDA_COLUMNS - BENCH_WINDOW_W : x;
+    bench_window.y = (y < 0) ? 0 : (y > MDA_ROWS - BENCH_WINDOW_H) ? MDA_ROWS - BENCH_WINDOW_H : y;
+    bench_window_draw(ctx);
+}
+
+static void bench_dashboard_setup(mda_context_t* ctx) {
+    (void)ctx;
+}
+
+static void bench_dashboard_frame(mda_context_t* ctx, uint32_t i) {
+    static const char* titles[4] = { " CPU ", " Memory ", " Disk ", " Network " };
+    mda_cell_t bar = mda_cell_make(CP437_FULL_BLOCK, MDA_NORMAL);
+    mda_cell_t rest = mda_cell_make(CP437_LIGHT_SHADE, MDA_NORMAL);
+    mda_fill_screen(&ctx->blank);
+    for (uint8_t panel = 0; panel < 4; ++panel) {
+        mda_rect_t r = mda_rect_make((panel % 2) * 40, 1 + (panel / 2) * 12, 40, 12);
+        mda_border_rect(&r, MDA_BORDER_SINGLE, MDA_BORDER_SINGLE, ctx->attributes);
+        mda_point_t p = mda_point_make(r.x + 2, r.y);
+        mda_printf_at(&p, 12, MDA_NORMAL | MDA_BOLD, "%s", titles[panel]);
+        for (uint8_t row = 0; row < 9; ++row) {
+            uint8_t value = (uint8_t)bench_random(101);
+            uint8_t length = value * 24 / 100;
+            p = mda_point_make(r.x + 2, r.y + 1 + row);
+            mda_printf_at(&p, 12, (value > 90) ? MDA_NORMAL | MDA_BOLD : MDA_NORMAL, "ch%u %3u%%", row, value);
+            mda_point_t p0 = mda_point_make(r.x + 13, p.y);
+            mda_point_t p1 = mda_point_make(r.x + 13 + 23, p.y);
+            mda_draw_hline(&p0, &p1, &rest);
+            if (length > 0) {
+                p1.x = r.x + 13 + length - 1;
+                mda_draw_hline(&p0, &p1, &bar);
+            }
+        }
+    }
+    mda_point_t status = mda_point_make(0, 0);
+    mda_printf_at(&status, MDA_COLUMNS, MDA_REVERSE, " Dashboard  refresh %-8lu  load %3u%% %45s", (unsigned long)i,
+                  (unsigned)bench_random(101), "");
+}
+
+static mda_line_edit_t bench_fields[BENCH_FIELDS];
+static uint8_t bench_field;
+
+static void bench_form_setup(mda_context_t* ctx) {
+    static const char* labels[BENCH_FIELDS] = { "Name", "Company", "Street", "Town", "Phone" };
+    mda_rect_t r = mda_rect_make(10, 4, 60, 2 * BENCH_FIELDS + 3);
+    mda_cell_t field = mda_cell_make(' ', MDA_UNDERLINE);
+    mda_border_rect(&r, MDA_BORDER_DOUBLE, MDA_BORDER_DOUBLE, ctx->attributes);
+    for (uint8_t i = 0; i < BENCH_FIELDS; ++i) {
+        mda_point_t label = mda_point_make(r.x + 2, r.y + 2 + 2 * i);
+        mda_point_t origin = mda_point_make(r.x + 14, label.y);
+        mda_printf_at(&label, 11, ctx->attributes, "%s:", labels[i]);
+        mda_line_edit_init(&bench_fields[i], &origin, BENCH_FIELD_W, &field, NULL, NULL, NULL);
+        mda_line_edit_set_text(&bench_fields[i], "");
+    }
+    bench_field = 0;
+}
+
+static void bench_form_frame(mda_context_t* ctx, uint32_t i) {
+    static const char letters[] = "abcdefghijklmnopqrstuvwxyz ABCDEFGHIJKLMNOPQRSTUVWXYZ 0123456789";
+    mda_line_edit_t* le = &bench_fields[bench_field];
+    uint32_t roll = bench_random(40);
+    (void)ctx;
+    (void)i;
+    if (roll == 0 || le->length >= BENCH_FIELD_W + 8) {            // Tab: on to the next field
+        bench_field = (bench_field + 1) % BENCH_FIELDS;
+        if (bench_fields[bench_field].length >= BENCH_FIELD_W + 8) {
+            mda_line_edit_set_text(&bench_fields[bench_field], "");
+        }
+    }
+    else if (roll < 4) {
+        mda_line_edit_key(le, ((uint16_t)BIOS_SCAN_BACKSPACE << 8) | '\b');
+    }
+    else if (roll < 6) {
+        mda_line_edit_key(le, (uint16_t)(roll == 4 ? BIOS_SCAN_LEFT : BIOS_SCAN_RIGHT) << 8);
+    }
+    else {
+        mda_line_edit_key(le, (uint8_t)letters[bench_random(sizeof(letters) - 1)]);
+    }
+}
+
+static const bench_scenario_t bench_scenarios[] = {
+    { "log_console", bench_log_setup,       bench_log_frame },
+    { "menu",        bench_menu_setup,      bench_menu_frame },
+    { "window_drag", bench_window_setup,    bench_window_frame },
+    { "dashboard",   bench_dashboard_setup, bench_dashboard_frame },
+    { "form_entry",  bench_form_setup,      bench_form_frame },
+};
+
+#define BENCH_SCENARIOS (sizeof(bench_scenarios) / sizeof(bench_scenarios[0]))
+
+static int bench_compare(const void* a, const void* b) {
+    uint32_t x = *(const uint32_t*)a;
+    uint32_t y = *(const uint32_t*)b;
+    return (x > y) - (x < y);
+}
+
+/**
+ * @brief Cells that differ from the last frame, which then becomes this one.
+ */
+static uint16_t bench_changed(void) {
+    const mda_cell_t* screen = host_screen_cells();
+    uint16_t changed = 0;
+    for (uint16_t i = 0; i < MDA_SCREEN_WORDS; ++i) {
+        changed += screen[i].packed != bench_previous[i].packed;
+    }
+    memcpy(bench_previous, screen, sizeof(bench_previous));
+    return changed;
+}
+
+static void bench_run(const bench_scenario_t* s, uint32_t frames, uint32_t seed) {
+    mda_context_t ctx;
+    bench_random_state = seed;
+    host_screen_context(&ctx);
+    s->setup(&ctx);
+    bench_changed();
+    uint64_t total_ns = 0;
+    uint64_t cells = 0;
+    for (uint32_t i = 0; i < frames; ++i) {
+        uint64_t start = bench_clock_ns();
+        s->frame(&ctx, i);
+        bench_ns[i] = (uint32_t)(bench_clock_ns() - start);
+        total_ns += bench_ns[i];
+        cells += bench_changed();                                   // outside the timed frame
+    }
+    qsort(bench_ns, frames, sizeof(bench_ns[0]), bench_compare);
+    printf("%-12s %8lu %10.0f %9.2f %9.2f %10.1f\n", s->name, (unsigned long)frames,
+           total_ns ? frames * 1e9 / (double)total_ns : 0.0,
+           bench_ns[frames / 2] / 1000.0, bench_ns[(uint32_t)((frames - 1) * 0.99)] / 1000.0,
+           (double)cells / frames);
+}
+
+int main(int argc, char* argv[]) {
+    uint32_t frames = BENCH_FRAMES;
+    uint32_t seed = BENCH_SEED;
+    bool selected[BENCH_SCENARIOS] = { false };
+    bool any = false;
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "-n") == 0 && i + 1 < argc) {
+            frames = strtoul(argv[++i], NULL, 0);
+            continue;
+        }
+        if (strcmp(argv[i], "-s") == 0 && i + 1 < argc) {
+            seed = strtoul(argv[++i], NULL, 0);
+            continue;
+        }
+        bool found = false;
+        for (uint8_t j = 0; j < BENCH_SCENARIOS; ++j) {
+            if (strcmp(argv[i], bench_scenarios[j].name) == 0) {
+                selected[j] = found = any = true;
+            }
+        }
+        if (!found) {
+            printf("usage: BENCH [-n frames] [-s seed] [scenario ...]\nscenarios:");
+            for (uint8_t j = 0; j < BENCH_SCENARIOS; ++j) {
+                printf(" %s", bench_scenarios[j].name);
+            }
+            putchar('\n');
+            return 2;
+        }
+    }
+    if (frames == 0 || frames > BENCH_FRAMES_MAX || seed == 0) {
+        printf("frames 1..%lu, seed not 0\n", BENCH_FRAMES_MAX);
+        return 2;
+    }
+    bench_ns = malloc(frames * sizeof(bench_ns[0]));
+    if (bench_ns == NULL) {
+        printf("out of memory\n");
+        return 1;
+    }
+    printf("seed %#lx\n", (unsigned long)seed);
+    printf("%-12s %8s %10s %9s %9s %10s\n", "scenario", "frames", "fps", "p50 us", "p99 us", "cells");
+    for (uint8_t j = 0; j < BENCH_SCENARIOS; ++j) {
+        if (!any || selected[j]) {
+            bench_run(&bench_scenarios[j], frames, seed);
+        }
+    }
+    free(bench_ns);
+    return 0;
+}
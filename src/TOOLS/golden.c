@@ -0,0 +1,656 @@
+/**
+ * @file golden.c
+ * @brief Golden-Frame Regression Tests
+ * @details Runs scripted scenarios, drawing calls and keys stored with
+ * bios_store_keystroke(), on the host build without a terminal, then
+ * compares the cells of each scenario's rectangle, as the CRTC model
+ * displays them from its start address, byte for byte with its golden
+ * frame: a .MDA dump in the golden directory (bin/GOLDEN/), the layout
+ * mda_save_rect() writes.
+ *
+ * Scenarios that load dumps read them from the input directory (bin/).
+ * Inputs are never written, so -u on one scenario cannot change what
+ * another scenario draws. Frames marked fixed in the table were made
+ * without the code under test; -u compares them instead of rewriting.
+ *
+ * Usage: GOLDEN [-u] [-d golden] [-i inputs] [scenario ...]
+ *
+ * -u  Rewrite the golden frames of the scenarios run instead of comparing,
+ *     fixed frames excepted.
+ * -d  Golden directory, GOLDEN by default.
+ * -i  Input directory, the current directory by default.
+ *
+ * A mismatch lists the cells that differ, expected and actual. Exit status
+ * 1 if any scenario fails. ctest runs the suite against bin/GOLDEN/ and bin/.
+ *
+ * @author Jeremy Thornton
+ */
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "../BIOS/bios_keyboard_services.h"
+#include "../MDA/mda_border.h"
+#include "../MDA/mda_clock.h"
+#include "../MDA/mda_context.h"
+#include "../MDA/mda_crtc.h"
+#include "../MDA/mda_editor.h"
+#include "../MDA/mda_line_edit.h"
+#include "../MDA/mda_list_view.h"
+#include "../MDA/mda_markup.h"
+#include "../MDA/mda_pager.h"
+#include "../MDA/mda_player.h"
+#include "../MDA/mda_primitives.h"
+#include "../MDA/mda_printf.h"
+#include "../MDA/mda_recorder.h"
+#include "../MDA/mda_scrollback.h"
+#include "../MDA/mda_strip_chart.h"
+#include "../MDA/cp437_constants.h"
+#include "../HOST/host_screen.h"
+
+#define GOLDEN_PATH_MAX     512
+#define GOLDEN_DIFF_LINES   16                                  /**< Cells listed per mismatch */
+#define GOLDEN_KEY(scan, ascii) ((uint16_t)(((scan) << 8) | (uint8_t)(ascii)))
+
+/**
+ * @struct golden_scenario_t
+ * @brief A script and the cells it is judged on.
+ */
+typedef struct {
+    const char* name;
+    const char* golden;             /**< File in the golden directory */
+    uint8_t x, y, w, h;             /**< Rectangle compared */
+    bool fixed;                     /**< Frame made independently of the scenario: -u never rewrites it */
+    void (*run)(mda_context_t* ctx);
+} golden_scenario_t;
+
+static const char* golden_dir = "GOLDEN";
+static const char* golden_inputs = ".";
+static mda_cell_t golden_actual[MDA_SCREEN_WORDS];
+static mda_cell_t golden_expected[MDA_SCREEN_WORDS];
+
+/**
+ * @brief Put keys in the type-ahead, as if typed.
+ * @return Keys stored; the scenario reads exactly that many, so never waits on stdin.
+ */
+static uint8_t golden_type(const uint16_t* keys, uint8_t n) {
+    uint8_t stored = 0;
+    while (stored < n && bios_store_keystroke(keys[stored])) {
+        ++stored;
+    }
+    return stored;
+}
+
+/**
+ * @brief Open a dump in dir.
+ */
+static FILE* golden_open(const char* dir, const char* name, const char* mode) {
+    char path[GOLDEN_PATH_MAX];
+    snprintf(path, sizeof(path), "%s/%s", dir, name);
+    return fopen(path, mode);
+}
+
+static void golden_fill_screen(mda_context_t* ctx) {
+    mda_cell_t smile = mda_cell_make(CP437_SMILING_FACE, MDA_NORMAL);
+    (void)ctx;
+    mda_fill_screen(&smile);
+}
+
+/**
+ * @brief The input RECT.MDA: smiles framed by a row of 0s, then A-G and 1-7 down each side.
+ */
+static void golden_rect(mda_context_t* ctx) {
+    mda_rect_t r = mda_rect_make(9, 14, 37, 9);
+    mda_cell_t smile = mda_cell_make(CP437_SMILING_FACE, MDA_NORMAL);
+    mda_cell_t zero = mda_cell_make('0', MDA_NORMAL);
+    (void)ctx;
+    mda_fill_rect(&r, &smile);
+    mda_point_t p0 = mda_point_make(r.x, r.y);
+    mda_point_t p1 = mda_point_make(r.x + r.w - 1, r.y);
+    mda_draw_hline(&p0, &p1, &zero);
+    p0.y = p1.y = r.y + r.h - 1;
+    mda_draw_hline(&p0, &p1, &zero);
+    for (uint8_t i = 0; i < r.h - 2; ++i) {
+        mda_cell_t left[2] = { mda_cell_make('A' + i, MDA_NORMAL), mda_cell_make('1' + i, MDA_NORMAL) };
+        mda_cell_t right[2] = { left[1], left[0] };
+        mda_point_t p = mda_point_make(r.x, r.y + 1 + i);
+        mda_write_cells(&p, left, 2);
+        p.x = r.x + r.w - 2;
+        mda_write_cells(&p, right, 2);
+    }
+}
+
+/**
+ * @brief The input SMILES.MDA placed by mda_load_rect() over stars. LOADRECT.MDA
+ * holds the input's rows as they should land, written without mda_load_rect(),
+ * so it is fixed.
+ */
+static void golden_load_rect(mda_context_t* ctx) {
+    mda_rect_t r = mda_rect_make(20, 5, 40, 15);
+    mda_cell_t star = mda_cell_make('*', MDA_NORMAL);
+    (void)ctx;
+    mda_fill_screen(&star);
+    FILE* f = golden_open(golden_inputs, "SMILES.MDA", "rb");
+    if (f != NULL) {
+        mda_load_rect(f, &r);
+        fclose(f);
+    }
+}
+
+/**
+ * @brief demo_scroll(): RECT.MDA over stars, its inside scrolled each way by keys.
+ */
+static void golden_scroll(mda_context_t* ctx) {
+    static const uint16_t keys[] = { 'w', 'w', 'a', 'd', 'd', 'd', 's', 'w', 'a' };
+    mda_rect_t r0 = mda_rect_make(9, 14, 37, 9);
+    mda_rect_t r1 = mda_rect_inner(&r0);
+    mda_cell_t star = mda_cell_make('*', MDA_NORMAL);
+    mda_fill_screen(&star);
+    FILE* f = golden_open(golden_inputs, "RECT.MDA", "rb");
+    if (f != NULL) {
+        mda_load_rect(f, &r0);
+        fclose(f);
+    }
+    for (uint8_t n = golden_type(keys, sizeof(keys) / sizeof(keys[0])); n > 0; --n) {
+        switch (BIOS_KEY_ASCII(bios_read_keystroke())) {
+        case 'w':
+            mda_scroll_up(&r1, &ctx->blank);
+            break;
+        case 's':
+            mda_scroll_down(&r1, &ctx->blank);
+            break;
+        case 'a':
+            mda_scroll_left(&r1, &ctx->blank);
+            break;
+        case 'd':
+            mda_scroll_right(&r1, &ctx->blank);
+            break;
+        }
+    }
+}
+
+/**
+ * @brief demo_line_edit(): two lines typed and edited, echoed above the prompt.
+ */
+static void golden_line_edit(mda_context_t* ctx) {
+    static const uint16_t keys[] = {
+        'd', 'i', 'r', GOLDEN_KEY(BIOS_SCAN_ENTER, '\r'),
+        'e', 'c', 'h', 'o', ' ', 'h', 'x', GOLDEN_KEY(BIOS_SCAN_BACKSPACE, '\b'), 'i',
+        GOLDEN_KEY(BIOS_SCAN_HOME, 0), GOLDEN_KEY(BIOS_SCAN_DEL, 0), 'E',
+    };
+    static const uint16_t last[] = { GOLDEN_KEY(BIOS_SCAN_END, 0), '!', GOLDEN_KEY(BIOS_SCAN_ENTER, '\r'), 'a', 'b' };
+    mda_line_edit_t le;
+    mda_point_t prompt = mda_point_make(0, MDA_ROWS - 1);
+    mda_point_t field = mda_point_make(3, MDA_ROWS - 1);
+    mda_point_t echo = mda_point_make(0, 0);
+    mda_line_edit_init(&le, &field, 40, &ctx->blank, NULL, NULL, NULL);
+    mda_printf_at(&prompt, 3, MDA_NORMAL | MDA_BOLD, "C>");
+    mda_line_edit_set_text(&le, "");
+    for (uint8_t script = 0; script < 2; ++script) {    // more keys than the type-ahead holds
+        uint8_t n = script ? golden_type(last, sizeof(last) / sizeof(last[0]))
+                           : golden_type(keys, sizeof(keys) / sizeof(keys[0]));
+        for (; n > 0; --n) {
+            if (mda_line_edit_key(&le, bios_read_keystroke()) == MDA_LINE_DONE) {
+                mda_printf_at(&echo, MDA_COLUMNS, ctx->attributes, "> %s", le.text);
+                echo.y++;
+                mda_line_edit_set_text(&le, "");
+            }
+        }
+    }
+}
+
+static void golden_list_row(uint32_t index, char* text, uint8_t width, void* user) {
+    (void)user;
+    snprintf(text, width + 1, "Record %05lu", (unsigned long)index);
+}
+
+/**
+ * @brief demo_list_view(): the selection moved by line, page and end.
+ */
+static void golden_list_view(mda_context_t* ctx) {
+    static mda_list_view_t view;
+    static const uint16_t keys[] = {
+        GOLDEN_KEY(BIOS_SCAN_DOWN, 0), GOLDEN_KEY(BIOS_SCAN_DOWN, 0), GOLDEN_KEY(BIOS_SCAN_PGDN, 0),
+        GOLDEN_KEY(BIOS_SCAN_PGDN, 0), GOLDEN_KEY(BIOS_SCAN_UP, 0), GOLDEN_KEY(BIOS_SCAN_END, 0),
+        GOLDEN_KEY(BIOS_SCAN_PGUP, 0), GOLDEN_KEY(BIOS_SCAN_UP, 0),
+    };
+    mda_rect_t r = mda_rect_make(20, 2, 40, 20);
+    (void)ctx;
+    mda_list_view_init(&view, &r, 500, golden_list_row, NULL);
+    mda_list_view_draw(&view);
+    for (uint8_t n = golden_type(keys, sizeof(keys) / sizeof(keys[0])); n > 0; --n) {
+        switch (BIOS_KEY_SCAN(bios_read_keystroke())) {
+        case BIOS_SCAN_UP:
+            mda_list_view_up(&view);
+            break;
+        case BIOS_SCAN_DOWN:
+            mda_list_view_down(&view);
+            break;
+        case BIOS_SCAN_PGUP:
+            mda_list_view_page_up(&view);
+            break;
+        case BIOS_SCAN_PGDN:
+            mda_list_view_page_down(&view);
+            break;
+        case BIOS_SCAN_HOME:
+            mda_list_view_home(&view);
+            break;
+        case BIOS_SCAN_END:
+            mda_list_view_end(&view);
+            break;
+        }
+    }
+}
+
+/**
+ * @brief Teletype output: tabs, backspace, CR and enough LFs to scroll.
+ */
+static void golden_console(mda_context_t* ctx) {
+    char line[] = "line\\tcolumn\\tcolumn\\rLINE\\n";
+    char tail[] = "abc\\bX\\r\\n";
+    for (uint8_t i = 0; i < MDA_ROWS + 5; ++i) {
+        ctx->attributes = (i % 3 == 0) ? MDA_NORMAL | MDA_BOLD : MDA_NORMAL;
+        mda_print_string(ctx, line);
+    }
+    ctx->attributes = MDA_REVERSE;
+    mda_print_string(ctx, tail);
+}
+
+/**
+ * @brief Crossing single and double borders, each junction glyph, and text in every attribute.
+ */
+static void golden_borders(mda_context_t* ctx) {
+    static const uint8_t attrs[] = { MDA_NORMAL, MDA_NORMAL | MDA_BOLD, MDA_UNDERLINE, MDA_REVERSE,
+                                     MDA_NORMAL | MDA_BLINK, MDA_INVISIBLE };
+    mda_rect_t outer = mda_rect_make(2, 1, 50, 14);
+    mda_rect_t across = mda_rect_make(10, 4, 30, 6);
+    mda_rect_t down = mda_rect_make(20, 1, 12, 14);
+    mda_point_t p0 = mda_point_make(2, 8);
+    mda_point_t p1 = mda_point_make(51, 8);
+    mda_border_rect(&outer, MDA_BORDER_DOUBLE, MDA_BORDER_DOUBLE, ctx->attributes);
+    mda_border_rect(&across, MDA_BORDER_SINGLE, MDA_BORDER_DOUBLE, ctx->attributes);
+    mda_border_rect(&down, MDA_BORDER_DOUBLE, MDA_BORDER_SINGLE, ctx->attributes);
+    mda_border_hline(&p0, &p1, MDA_BORDER_SINGLE, ctx->attributes);
+    mda_point_t p = mda_point_make(54, 2);
+    for (uint8_t i = 0; i < sizeof(attrs); ++i, ++p.y) {
+        mda_printf_at(&p, 24, attrs[i], "attr %02X %-3u %s", attrs[i], i * 7, "text");
+    }
+}
+
+/**
+ * @brief Markup sources with tags, escapes and stray braces, two ending in '{' and "{/".
+ */
+static void golden_markup(mda_context_t* ctx) {
+    static const char* sources[] = {
+        "{b}bold{/b} {u}under{/u} {r}rev {b}both{/b}{/r} {f}flash{/f}",
+        "{{b} {x} {/q} {b {/b",
+        "ends in a brace {",
+        "{r}ends in an open close{/r} {/",
+    };
+    static char text[MDA_COLUMNS];
+    static mda_markup_run_t runs[16];
+    static mda_markup_t markup;
+    for (uint8_t i = 0; i < sizeof(sources) / sizeof(sources[0]); ++i) {
+        mda_rect_t r = mda_rect_make(0, i, MDA_COLUMNS, 1);
+        mda_markup_init(&markup, text, sizeof(text), runs, sizeof(runs) / sizeof(runs[0]));
+        if (mda_markup_compile(&markup, sources[i], MDA_NORMAL)) {
+            mda_markup_draw(&markup, 0, &r, &ctx->blank);
+        }
+    }
+}
+
+/**
+ * @brief A text with more lines than the index holds, after the cursor moved
+ * down another: set_text fails, leaving the editor empty, and keys then edit it.
+ */
+static void golden_editor(mda_context_t* ctx) {
+    static const char fits[] = "one\ntwo\nthree\nfour";
+    static const char overflows[] = "1\n2\n3\n4\n5\n6\n";
+    static const uint16_t keys[] = { 'o', 'k', GOLDEN_KEY(BIOS_SCAN_ENTER, '\r'), 'u', 's', 'e', 'd' };
+    static char buffer[64];
+    static uint16_t lines[4];
+    static mda_editor_t ed;
+    mda_rect_t r = mda_rect_make(1, 1, 20, 6);
+    mda_editor_init(&ed, &r, &ctx->blank, buffer, sizeof(buffer), lines, sizeof(lines) / sizeof(lines[0]));
+    bool first = mda_editor_set_text(&ed, fits, sizeof(fits) - 1);
+    mda_editor_goto(&ed, 3, 4);
+    bool second = mda_editor_set_text(&ed, overflows, sizeof(overflows) - 1);
+    mda_point_t p = mda_point_make(1, 0);
+    mda_printf_at(&p, 30, MDA_REVERSE, "set %u %u length %u", first, second, mda_editor_length(&ed));
+    for (uint8_t n = golden_type(keys, sizeof(keys) / sizeof(keys[0])); n > 0; --n) {
+        mda_editor_key(&ed, bios_read_keystroke());
+    }
+    mda_editor_draw(&ed);
+}
+
+/**
+ * @brief A screen of one run per cell, the worst case row, parked in the smallest
+ * budget under three short history rows, then viewed two rows back.
+ */
+static void golden_scrollback(mda_context_t* ctx) {
+    static uint8_t history[MDA_SCROLLBACK_MIN_BYTES];
+    static mda_scrollback_t sb;
+    mda_rect_t screen = mda_rect_make(0, 0, MDA_COLUMNS, MDA_ROWS);
+    mda_scrollback_init(&sb, history, sizeof(history));
+    for (uint8_t i = 0; i < 3; ++i) {
+        mda_cell_t row[2] = { mda_cell_make('h', MDA_NORMAL), mda_cell_make('0' + i, MDA_NORMAL) };
+        mda_scrollback_push(&sb, row, 2, &ctx->blank);
+    }
+    mda_cell_t* cells = host_screen_cells();
+    for (uint16_t i = 0; i < MDA_SCREEN_WORDS; ++i) {
+        cells[i] = mda_cell_make('!' + i % 94, (i % 2) ? MDA_NORMAL | MDA_BOLD : MDA_NORMAL);
+    }
+    mda_scrollback_enter(&sb, &screen, &ctx->blank);
+    mda_scrollback_scroll(&sb, &screen, &ctx->blank, -3);
+    mda_scrollback_scroll(&sb, &screen, &ctx->blank, 1);
+}
+
+/**
+ * @brief Console output with hardware scrolling: 26 scrolls carry the start
+ * address past the 2048 cell wrap, folding the rows drawn across it, then
+ * one scroll down moves it back over the wrap.
+ */
+static void golden_hw_scroll(mda_context_t* ctx) {
+    char line[MDA_COLUMNS];
+    mda_set_hw_scroll(ctx, true);
+    for (uint8_t i = 0; i < MDA_ROWS + 26; ++i) {
+        ctx->attributes = (i % 4 == 0) ? MDA_NORMAL | MDA_BOLD : MDA_NORMAL;
+        snprintf(line, sizeof(line), "line %02u start %4u %.*s", i, mda_crtc_start(), i % 40, "----+----+----+----+----+----+----+----+");
+        mda_print_string(ctx, line);
+        if (i < MDA_ROWS + 25) {
+            mda_CR(ctx);
+            mda_LF(ctx);
+        }
+    }
+    mda_point_t home = mda_point_make(0, 0);
+    mda_hw_scroll_down(&ctx->blank);
+    mda_cursor_to(ctx, &home);
+    ctx->attributes = MDA_REVERSE;
+    snprintf(line, sizeof(line), "scrolled back to start %4u", mda_crtc_start());
+    mda_print_string(ctx, line);
+    mda_set_hw_scroll(ctx, false);
+}
+
+/**
+ * @brief A filled series ramping up and down over a trace flat at its minimum,
+ * and a sparkline below: both keep the baseline where the value bottoms out.
+ */
+static void golden_strip_chart(mda_context_t* ctx) {
+    static mda_strip_chart_t chart;
+    static mda_strip_chart_t spark;
+    mda_rect_t r0 = mda_rect_make(2, 1, 40, 8);
+    mda_rect_t r1 = mda_rect_make(2, 10, 40, 1);
+    (void)ctx;
+    mda_strip_chart_init(&chart, &r0, 2, 1, MDA_STRIP_MEAN);
+    mda_strip_chart_set_series(&chart, 0, 0, 100, MDA_NORMAL, true);
+    mda_strip_chart_set_series(&chart, 1, 0, 100, MDA_NORMAL | MDA_BOLD, false);
+    mda_strip_chart_init(&spark, &r1, 1, 1, MDA_STRIP_PEAK);
+    for (int16_t i = 0; i < 48; ++i) {
+        int16_t ramp = (i % 24 < 12) ? (i % 24) * 10 - 10 : (24 - i % 24) * 10 - 10;
+        int16_t values[2] = { ramp, (i < 24) ? 0 : -5 };
+        mda_strip_chart_push(&chart, values);
+        mda_strip_chart_push(&spark, values);
+    }
+}
+
+/**
+ * @brief Record 100 frames, keyframes and deltas, over a scratch file, then
+ * play them back step by step onto a screen of stars. The bottom row says
+ * whether frame 70 and the last frame came back as recorded.
+ */
+static void golden_playback(mda_context_t* ctx) {
+    static uint8_t buffer[1024];
+    static mda_recorder_t rec;
+    static mda_player_t player;
+    static mda_player_key_t keys[8];
+    static mda_cell_t middle[MDA_SCREEN_WORDS];
+    static mda_cell_t last[MDA_SCREEN_WORDS];
+    char path[] = "/tmp/goldenXXXXXX";
+    mda_cell_t star = mda_cell_make('*', MDA_NORMAL);
+    mda_cell_t* screen = host_screen_cells();
+    int fd = mkstemp(path);
+    if (fd < 0) {
+        return;
+    }
+    close(fd);
+    bool recorded = mda_recorder_open(&rec, path, buffer, sizeof(buffer));
+    for (uint8_t i = 0; recorded && i < 100; ++i) {
+        mda_point_t p = mda_point_make((i * 7) % 40, i % (MDA_ROWS - 1));
+        if (i == 50) {              // a delta larger than a keyframe
+            mda_cell_t shade = mda_cell_make(CP437_LIGHT_SHADE, MDA_NORMAL);
+            mda_rect_t r = mda_rect_make(0, 0, MDA_COLUMNS, MDA_ROWS - 1);
+            mda_fill_rect(&r, &shade);
+        }
+        mda_printf_at(&p, 40, (i % 3) ? MDA_NORMAL : MDA_REVERSE, "frame %3u", i);
+        mda_recorder_frame(&rec, MDA_RECORD_ALL_ROWS);
+        if (i == 70) {
+            memcpy(middle, screen, sizeof(middle));
+        }
+    }
+    memcpy(last, screen, sizeof(last));
+    recorded = recorded && mda_recorder_close(&rec);
+    mda_fill_screen(&star);
+    uint8_t steps = 0;
+    bool middle_ok = false;
+    if (recorded && mda_player_open(&player, path, keys, sizeof(keys) / sizeof(keys[0]))) {
+        while (mda_player_step(&player)) {
+            mda_player_show(&player);
+            if (steps++ == 70) {
+                middle_ok = memcmp(screen, middle, sizeof(middle)) == 0;
+            }
+        }
+        mda_player_close(&player);
+    }
+    remove(path);
+    bool last_ok = memcmp(screen, last, (MDA_SCREEN_WORDS - MDA_COLUMNS) * sizeof(mda_cell_t)) == 0;
+    mda_point_t status = mda_point_make(0, MDA_ROWS - 1);
+    mda_printf_at(&status, MDA_COLUMNS, ctx->attributes, "played %u frames, frame 70 %s, last frame %s",
+                  steps, middle_ok ? "matches" : "DIFFERS", last_ok ? "matches" : "DIFFERS");
+}
+
+/**
+ * @brief Print a pager line number, '?' while unknown.
+ */
+static void golden_pager_line(const mda_pager_t* pager, char* text, size_t size) {
+    uint32_t line = mda_pager_top_line(pager);
+    if (line == MDA_PAGER_LINE_UNKNOWN) {
+        snprintf(text, size, "?");
+    }
+    else {
+        snprintf(text, size, "%lu", (unsigned long)line);
+    }
+}
+
+/**
+ * @brief A 300 line file paged into the index, then seeks: 50% lands beyond
+ * the index, 0% and a scroll back from 50% land inside it. The bottom row
+ * lists the top line number after each move.
+ */
+static void golden_pager(mda_context_t* ctx) {
+    static mda_pager_t pager;
+    char path[] = "/tmp/goldenXXXXXX";
+    char lines[5][12];
+    int fd = mkstemp(path);
+    FILE* f = (fd < 0) ? NULL : fdopen(fd, "w");
+    if (f == NULL) {
+        return;
+    }
+    for (uint16_t i = 0; i < 300; ++i) {
+        fprintf(f, "line %03u%.*s\n", i, i % 50, "\tthe quick brown fox jumps over the lazy dog.....");
+    }
+    fclose(f);
+    mda_rect_t r = mda_rect_make(0, 0, MDA_COLUMNS, MDA_ROWS - 1);
+    if (mda_pager_open(&pager, path, &r)) {
+        for (uint8_t i = 0; i < 4; ++i) {
+            mda_pager_page_down(&pager);
+        }
+        golden_pager_line(&pager, lines[0], sizeof(lines[0]));
+        mda_pager_seek_percent(&pager, 50);
+        golden_pager_line(&pager, lines[1], sizeof(lines[1]));
+        mda_pager_seek_percent(&pager, 0);
+        golden_pager_line(&pager, lines[2], sizeof(lines[2]));
+        mda_pager_seek_percent(&pager, 50);
+        golden_pager_line(&pager, lines[3], sizeof(lines[3]));
+        for (uint8_t i = 0; i < 60; ++i) {
+            mda_pager_line_up(&pager);
+        }
+        golden_pager_line(&pager, lines[4], sizeof(lines[4]));
+        mda_pager_close(&pager);
+    }
+    remove(path);
+    mda_point_t status = mda_point_make(0, MDA_ROWS - 1);
+    mda_printf_at(&status, MDA_COLUMNS, ctx->attributes, "paged %s, 50%% %s, 0%% %s, 50%% %s, 60 up %s",
+                  lines[0], lines[1], lines[2], lines[3], lines[4]);
+}
+
+static const golden_scenario_t golden_scenarios[] = {
+    { "fill_screen", "SCREEN.MDA",    0,  0, MDA_COLUMNS, MDA_ROWS, false, golden_fill_screen },
+    { "rect",        "RECT.MDA",      9, 14, 37,          9,        false, golden_rect },
+    { "load_rect",   "LOADRECT.MDA", 20,  5, 40,          15,       true,  golden_load_rect },
+    { "scroll",      "SCROLL.MDA",    0,  0, MDA_COLUMNS, MDA_ROWS, false, golden_scroll },
+    { "line_edit",   "LINEEDIT.MDA",  0,  0, MDA_COLUMNS, MDA_ROWS, false, golden_line_edit },
+    { "list_view",   "LISTVIEW.MDA",  0,  0, MDA_COLUMNS, MDA_ROWS, false, golden_list_view },
+    { "console",     "CONSOLE.MDA",   0,  0, MDA_COLUMNS, MDA_ROWS, false, golden_console },
+    { "borders",     "BORDERS.MDA",   0,  0, MDA_COLUMNS, MDA_ROWS, false, golden_borders },
+    { "markup",      "MARKUP.MDA",    0,  0, MDA_COLUMNS, 4,        false, golden_markup },
+    { "editor",      "EDITOR.MDA",    0,  0, 32,          8,        false, golden_editor },
+    { "scrollback",  "SCROLLBK.MDA",  0,  0, MDA_COLUMNS, MDA_ROWS, false, golden_scrollback },
+    { "hw_scroll",   "HWSCROLL.MDA",  0,  0, MDA_COLUMNS, MDA_ROWS, false, golden_hw_scroll },
+    { "strip_chart", "STRIP.MDA",     0,  0, 44,          12,       false, golden_strip_chart },
+    { "playback",    "PLAYBACK.MDA",  0,  0, MDA_COLUMNS, MDA_ROWS, false, golden_playback },
+    { "pager",       "PAGER.MDA",     0,  0, MDA_COLUMNS, MDA_ROWS, false, golden_pager },
+};
+
+#define GOLDEN_SCENARIOS    (sizeof(golden_scenarios) / sizeof(golden_scenarios[0]))
+
+/**
+ * @brief Print a cell of the diff: the character if printable, else its code, then the attribute.
+ */
+static void golden_print_cell(mda_cell_t cell) {
+    uint8_t chr = (uint8_t)cell.chr;
+    if (chr >= ' ' && chr < 0x7F) {
+        printf("'%c' %02X", chr, cell.attr);
+    }
+    else {
+        printf("%02X  %02X", chr, cell.attr);
+    }
+}
+
+/**
+ * @brief Report the cells that differ; false if any do.
+ */
+static bool golden_compare(const golden_scenario_t* s, uint16_t n) {
+    uint16_t differ = 0;
+    uint8_t x0 = UINT8_MAX, y0 = UINT8_MAX, x1 = 0, y1 = 0;
+    for (uint16_t i = 0; i < n; ++i) {
+        if (golden_actual[i].packed != golden_expected[i].packed) {
+            uint8_t x = s->x + i % s->w;
+            uint8_t y = s->y + i / s->w;
+            x0 = (x < x0) ? x : x0;
+            y0 = (y < y0) ? y : y0;
+            x1 = (x > x1) ? x : x1;
+            y1 = (y > y1) ? y : y1;
+            ++differ;
+        }
+    }
+    if (differ == 0) {
+        return true;
+    }
+    printf("FAIL %s: %u cells differ from %s in %u,%u-%u,%u\n", s->name, differ, s->golden, x0, y0, x1, y1);
+    printf("     x  y  expected  actual\n");
+    uint16_t shown = 0;
+    for (uint16_t i = 0; i < n && shown < GOLDEN_DIFF_LINES; ++i) {
+        if (golden_actual[i].packed != golden_expected[i].packed) {
+            printf("    %2u %2u  ", s->x + i % s->w, s->y + i / s->w);
+            golden_print_cell(golden_expected[i]);
+            printf("   ");
+            golden_print_cell(golden_actual[i]);
+            putchar('\n');
+            ++shown;
+        }
+    }
+    if (differ > shown) {
+        printf("    ... %u more\n", differ - shown);
+    }
+    return false;
+}
+
+/**
+ * @brief Run a scenario, then compare its rectangle with its golden frame, or rewrite the frame.
+ */
+static bool golden_run(const golden_scenario_t* s, bool update) {
+    mda_context_t ctx;
+    update = update && !s->fixed;
+    host_screen_context(&ctx);
+    s->run(&ctx);
+    uint16_t n = s->w * s->h;
+    for (uint8_t y = 0; y < s->h; ++y) {       // as the CRTC displays them, from its start address
+        for (uint8_t x = 0; x < s->w; ++x) {
+            golden_actual[y * s->w + x] = mda_crtc_model_cell(s->x + x, s->y + y);
+        }
+    }
+    FILE* f = golden_open(golden_dir, s->golden, update ? "wb" : "rb");
+    if (f == NULL) {
+        printf("FAIL %s: cannot open %s/%s%s\n", s->name, golden_dir, s->golden, update ? "" : " (-u creates it)");
+        return false;
+    }
+    if (update) {
+        bool ok = fwrite(golden_actual, sizeof(mda_cell_t), n, f) == n;
+        ok = (fclose(f) == 0) && ok;
+        printf("%s %s\n", ok ? "wrote" : "FAIL cannot write", s->golden);
+        return ok;
+    }
+    size_t read = fread(golden_expected, sizeof(mda_cell_t), MDA_SCREEN_WORDS, f);
+    fclose(f);
+    if (read != n) {
+        printf("FAIL %s: %s has %lu cells, not %u\n", s->name, s->golden, (unsigned long)read, n);
+        return false;
+    }
+    return golden_compare(s, n);
+}
+
+int main(int argc, char* argv[]) {
+    bool update = false;
+    bool selected[GOLDEN_SCENARIOS] = { false };
+    bool any = false;
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "-u") == 0) {
+            update = true;
+            continue;
+        }
+        if (strcmp(argv[i], "-d") == 0 && i + 1 < argc) {
+            golden_dir = argv[++i];
+            continue;
+        }
+        if (strcmp(argv[i], "-i") == 0 && i + 1 < argc) {
+            golden_inputs = argv[++i];
+            continue;
+        }
+        bool found = false;
+        for (uint8_t j = 0; j < GOLDEN_SCENARIOS; ++j) {
+            if (strcmp(argv[i], golden_scenarios[j].name) == 0) {
+                selected[j] = found = any = true;
+            }
+        }
+        if (!found) {
+            printf("usage: GOLDEN [-u] [-d golden] [-i inputs] [scenario ...]\nscenarios:");
+            for (uint8_t j = 0; j < GOLDEN_SCENARIOS; ++j) {
+                printf(" %s", golden_scenarios[j].name);
+            }
+            putchar('\n');
+            return 2;
+        }
+    }
+    mda_clock_init();
+    uint32_t start = mda_clock_us();
+    uint8_t run = 0;
+    uint8_t failed = 0;
+    for (uint8_t j = 0; j < GOLDEN_SCENARIOS; ++j) {
+        if (!any || selected[j]) {
+            ++run;
+            failed += !golden_run(&golden_scenarios[j], update);
+        }
+    }
+    printf("%u scenarios, %u failed, %lu us\n", run, failed, (unsigned long)(mda_clock_us() - start));
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,80 @@
+/**
+ * @file peek.c
+ * @brief Screen Export Viewer
+ * @details Reads a screen exported with host_export.h (TUI_EXPORT=path)
+ * while the program runs: prints it as UTF-8 text, saves it as a .MDA
+ * screen dump, or follows it live.
+ *
+ * Usage: PEEK export [out.MDA | -f]
+ *
+ * -f redraws the text whenever a new frame is exported, until interrupted.
+ *
+ * @author Jeremy Thornton
+ */
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "../HOST/host_export.h"
+#include "../MDA/mda_remote.h"
+
+#define PEEK_POLL_US    20000
+
+static mda_cell_t peek_cells[MDA_SCREEN_WORDS];
+
+/**
+ * @brief Print the characters of the snapshot, one line per row.
+ */
+static void peek_print(uint32_t frame, uint16_t cursor) {
+    uint8_t utf8[MDA_REMOTE_UTF8_MAX];
+    for (uint8_t y = 0; y < MDA_ROWS; ++y) {
+        for (uint8_t x = 0; x < MDA_COLUMNS; ++x) {
+            fwrite(utf8, 1, mda_remote_utf8((uint8_t)peek_cells[y * MDA_COLUMNS + x].chr, utf8), stdout);
+        }
+        putchar('\n');
+    }
+    if (cursor < MDA_SCREEN_WORDS) {
+        printf("frame %lu, cursor %u,%u\n", (unsigned long)frame, cursor % MDA_COLUMNS, cursor / MDA_COLUMNS);
+    }
+    else {
+        printf("frame %lu, cursor hidden\n", (unsigned long)frame);
+    }
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        printf("usage: PEEK export [out.MDA | -f]\n");
+        return 2;
+    }
+    host_export_t export;
+    if (!host_export_attach(&export, argv[1])) {
+        printf("%s: not a screen export\n", argv[1]);
+        return 2;
+    }
+    uint16_t cursor;
+    uint32_t frame = host_export_snapshot(&export, peek_cells, &cursor);
+    if (argc > 2 && strcmp(argv[2], "-f") == 0) {
+        for (;;) {
+            printf("\x1B[H\x1B[2J");
+            peek_print(frame, cursor);
+            fflush(stdout);
+            uint32_t seen = frame;
+            while ((frame = host_export_snapshot(&export, peek_cells, &cursor)) == seen) {
+                usleep(PEEK_POLL_US);
+            }
+        }
+    }
+    if (argc > 2) {
+        FILE* f = fopen(argv[2], "wb");     // the layout mda_save_screen() writes
+        if (f == NULL || fwrite(peek_cells, sizeof(mda_cell_t), MDA_SCREEN_WORDS, f) != MDA_SCREEN_WORDS) {
+            printf("%s: cannot write\n", argv[2]);
+            return 1;
+        }
+        fclose(f);
+    }
+    else {
+        peek_print(frame, cursor);
+    }
+    host_export_close(&export);
+    return 0;
+}
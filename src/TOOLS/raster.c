@@ -0,0 +1,193 @@
+/**
+ * @file raster.c
+ * @brief Batch Rasterizer for .MDA Dumps
+ * @details Draws .MDA screen and rectangle dumps (mda_save_screen(),
+ * mda_save_rect()) as the MDA shows them and writes each next to its dump,
+ * or into -o, as a .png, or a .ppm with -ppm. Directories are searched for
+ * *.MDA.
+ *
+ * Usage: RASTER [-j n] [-o directory] [-ppm] [-white] [-w columns] dump|directory ...
+ *
+ * -j      Worker threads, the online CPUs by default; each takes the next
+ *         dump until none are left, sharing the glyph cache.
+ * -o      Directory for the images, created if missing.
+ * -white  Grey levels instead of green phosphor.
+ * -w      Columns of rectangle dumps. By default 4000 bytes is a screen and
+ *         other sizes are rows of 80 columns.
+ *
+ * A dump whose cells are not rows of the width fails the run when it is the
+ * only dump named. In a batch, several dumps or a directory, it is reported
+ * as skipped: rectangle dumps of other widths share directories with screens.
+ *
+ * @author Jeremy Thornton
+ */
+#include <dirent.h>
+#include <errno.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "../HOST/host_raster.h"
+
+#define RASTER_FILES_MAX    1024
+#define RASTER_JOBS_MAX     64
+#define RASTER_PATH_MAX     512
+
+static char* raster_files[RASTER_FILES_MAX];
+static uint16_t raster_count;
+static atomic_uint raster_next;
+static atomic_uint raster_failed;
+static bool raster_batch;
+static bool raster_ppm;
+static const char* raster_output;
+static uint8_t raster_columns;
+static const host_raster_palette_t* raster_palette = &host_raster_green;
+
+static void raster_add(const char* path) {
+    if (raster_count < RASTER_FILES_MAX) {
+        raster_files[raster_count++] = strdup(path);
+    }
+}
+
+/**
+ * @brief Add path, or the *.MDA in it if it is a directory.
+ */
+static void raster_add_path(const char* path) {
+    struct stat st;
+    if (stat(path, &st) != 0 || !S_ISDIR(st.st_mode)) {
+        raster_add(path);
+        return;
+    }
+    raster_batch = true;
+    DIR* dir = opendir(path);
+    struct dirent* entry;
+    while (dir != NULL && (entry = readdir(dir)) != NULL) {
+        size_t n = strlen(entry->d_name);
+        if (n > 4 && strcasecmp(entry->d_name + n - 4, ".MDA") == 0) {
+            char file[RASTER_PATH_MAX];
+            snprintf(file, sizeof(file), "%s/%s", path, entry->d_name);
+            raster_add(file);
+        }
+    }
+    if (dir != NULL) {
+        closedir(dir);
+    }
+}
+
+/**
+ * @brief Rasterize one dump; false, with a message, if it cannot be.
+ * In a batch a dump that is not rows of the width is skipped, not failed.
+ */
+static bool raster_file(const char* path) {
+    FILE* f = fopen(path, "rb");
+    if (f == NULL) {
+        printf("%s: cannot open\n", path);
+        return false;
+    }
+    static _Thread_local mda_cell_t cells[UINT8_MAX * UINT8_MAX];
+    size_t n = fread(cells, sizeof(mda_cell_t), UINT8_MAX * UINT8_MAX, f);
+    fclose(f);
+    uint8_t w = raster_columns ? raster_columns : MDA_COLUMNS;
+    if (n == 0 || n % w != 0 || n / w > UINT8_MAX) {
+        printf("%s: %s%lu cells are not rows of %u\n", path, raster_batch ? "skipped, " : "", (unsigned long)n, w);
+        return raster_batch;
+    }
+    uint8_t h = (uint8_t)(n / w);
+    uint8_t* pixels = malloc((size_t)w * HOST_RASTER_CELL_W * h * HOST_RASTER_CELL_H);
+    if (pixels == NULL) {
+        printf("%s: out of memory\n", path);
+        return false;
+    }
+    host_raster_cells(cells, w, h, pixels);
+    char out[RASTER_PATH_MAX];
+    const char* name = path;
+    if (raster_output != NULL) {
+        const char* slash = strrchr(path, '/');
+        name = (slash != NULL) ? slash + 1 : path;
+    }
+    const char* dot = strrchr(name, '.');
+    size_t stem = (dot != NULL && strchr(dot, '/') == NULL) ? (size_t)(dot - name) : strlen(name);
+    snprintf(out, sizeof(out), "%s%s%.*s.%s", raster_output ? raster_output : "", raster_output ? "/" : "",
+             (int)stem, name, raster_ppm ? "ppm" : "png");
+    bool ok = raster_ppm
+            ? host_raster_write_ppm(out, pixels, w * HOST_RASTER_CELL_W, h * HOST_RASTER_CELL_H, raster_palette)
+            : host_raster_write_png(out, pixels, w * HOST_RASTER_CELL_W, h * HOST_RASTER_CELL_H, raster_palette);
+    free(pixels);
+    if (!ok) {
+        printf("%s: cannot write\n", out);
+    }
+    return ok;
+}
+
+static void* raster_worker(void* arg) {
+    (void)arg;
+    unsigned i;
+    while ((i = atomic_fetch_add(&raster_next, 1)) < raster_count) {
+        if (!raster_file(raster_files[i])) {
+            atomic_fetch_add(&raster_failed, 1);
+        }
+    }
+    return NULL;
+}
+
+int main(int argc, char* argv[]) {
+    long jobs = sysconf(_SC_NPROCESSORS_ONLN);
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "-j") == 0 && i + 1 < argc) {
+            jobs = atol(argv[++i]);
+        }
+        else if (strcmp(argv[i], "-w") == 0 && i + 1 < argc) {
+            raster_columns = (uint8_t)atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "-o") == 0 && i + 1 < argc) {
+            raster_output = argv[++i];
+        }
+        else if (strcmp(argv[i], "-ppm") == 0) {
+            raster_ppm = true;
+        }
+        else if (strcmp(argv[i], "-white") == 0) {
+            raster_palette = &host_raster_white;
+        }
+        else {
+            raster_add_path(argv[i]);
+        }
+    }
+    if (raster_count == 0) {
+        printf("usage: RASTER [-j n] [-o directory] [-ppm] [-white] [-w columns] dump|directory ...\n");
+        return 2;
+    }
+    if (raster_count > 1) {
+        raster_batch = true;
+    }
+    if (raster_output != NULL && mkdir(raster_output, 0777) != 0 && errno != EEXIST) {
+        printf("%s: cannot create\n", raster_output);
+        return 1;
+    }
+    if (jobs < 1) {
+        jobs = 1;
+    }
+    if (jobs > raster_count) {
+        jobs = raster_count;
+    }
+    if (jobs > RASTER_JOBS_MAX) {
+        jobs = RASTER_JOBS_MAX;
+    }
+    pthread_t threads[RASTER_JOBS_MAX];
+    long started = 0;
+    while (started < jobs - 1 && pthread_create(&threads[started], NULL, raster_worker, NULL) == 0) {
+        ++started;
+    }
+    raster_worker(NULL);                        // this thread is a worker too
+    for (long i = 0; i < started; ++i) {
+        pthread_join(threads[i], NULL);
+    }
+    for (uint16_t i = 0; i < raster_count; ++i) {
+        free(raster_files[i]);
+    }
+    return atomic_load(&raster_failed) ? 1 : 0;
+}
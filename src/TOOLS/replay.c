@@ -0,0 +1,215 @@
+/**
+ * @file replay.c
+ * @brief Trace Replay Benchmark
+ * @details Re-executes a trace captured with mda_trace.h on the display,
+ * timing each call, and checks every recorded frame checksum. Arguments
+ * are read before the clock starts, so the times cover the primitive only.
+ *
+ * Usage: REPLAY trace [passes]
+ *
+ * Prints, per traced function, the calls, total and mean microseconds,
+ * then the frame checksums matched. Exit status 1 if any frame differs.
+ *
+ * @author Jeremy Thornton
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../MDA/mda_clock.h"
+#include "../MDA/mda_context.h"
+#include "../MDA/mda_primitives.h"
+#include "../MDA/mda_crtc.h"
+#include "../MDA/mda_trace.h"
+#ifndef __DOS__
+#include "../HOST/host_terminal.h"
+#endif
+
+#define REPLAY_STRING_MAX   4096
+
+/**
+ * @brief Bytes of arguments after each fixed size op.
+ */
+static const uint8_t replay_args[MDA_TRACE_OPS] = {
+    0, 2, MDA_TRACE_CONTEXT_SIZE, 0,    // screen, frame, context, load_rect
+    4, 6, 6, 10, 10,                    // plot, hline, vline, hline_caps, vline_caps
+    6, 6, 20, 0, 4, 2,                  // draw_rect, fill_rect, draw_border, write_cells, write_attr, fill_screen
+    6, 6, 6, 6, 2, 2,                   // scrolls, hw scrolls
+    2, 0, 0, 0, 0, 0, 0, 0, 0, 1, 0     // cursor_to, BS .. CRLF, print_char, print_string
+};
+
+static uint32_t replay_calls[MDA_TRACE_OPS];
+static uint32_t replay_us[MDA_TRACE_OPS];
+static mda_cell_t replay_cells[MDA_SCREEN_WORDS];
+static char replay_string[REPLAY_STRING_MAX];
+
+/**
+ * @brief Write w x h cells to the screen at rect.
+ */
+static void replay_rect(const mda_rect_t* rect, const mda_cell_t* cells) {
+    mda_point_t p = rect->origin;
+    for (uint8_t y = 0; y < rect->h; ++y, ++p.y) {
+        mda_write_cells(&p, cells, rect->w);
+        cells += rect->w;
+    }
+}
+
+/**
+ * @brief Restore the context state of a MDA_TRACE_CONTEXT record.
+ */
+static void replay_context(mda_context_t* ctx, const uint8_t* state) {
+    ctx->bounds = mda_rect_make(state[0], state[1], state[2], state[3]);
+    ctx->attributes = state[4];
+    ctx->blank = mda_cell_make(state[5], state[6]);
+    ctx->htab_size = state[7];
+    ctx->vtab_size = state[8];
+    mda_point_t p = mda_point_make(state[9], state[10]);
+    mda_cursor_to(ctx, &p);
+    ctx->hw_scroll = state[11];
+}
+
+/**
+ * @brief Replay one pass of the trace.
+ * @return Frames whose checksum differed, or -1 if the trace is malformed.
+ */
+static int replay_pass(FILE* f, mda_context_t* ctx, uint16_t* frames) {
+    union {
+        uint8_t bytes[20];
+        mda_cell_t cells[10];       // keeps the arguments cell aligned
+    } a;
+    const mda_point_t* p0 = (const mda_point_t*)a.bytes;
+    const mda_point_t* p1 = (const mda_point_t*)(a.bytes + 2);
+    const mda_rect_t* rect = (const mda_rect_t*)a.bytes;
+    int differ = 0;
+    int op;
+    *frames = 0;
+    while ((op = fgetc(f)) != EOF) {
+        if (op >= MDA_TRACE_OPS || fread(a.bytes, 1, replay_args[op], f) != replay_args[op]) {
+            return -1;
+        }
+        uint16_t count = 0;
+        switch (op) {       // variable length arguments
+            case MDA_TRACE_LOAD_RECT:
+                if (fread(a.bytes, 1, 4, f) != 4) {
+                    return -1;
+                }
+                count = rect->w * rect->h;
+                break;
+            case MDA_TRACE_SCREEN:
+                count = MDA_SCREEN_WORDS;
+                break;
+            case MDA_TRACE_WRITE_CELLS:
+                if (fread(a.bytes, 1, 3, f) != 3) {
+                    return -1;
+                }
+                count = a.bytes[2];
+                break;
+            case MDA_TRACE_PRINT_STRING:
+                for (int c = fgetc(f); c != 0; c = fgetc(f)) {
+                    if (c == EOF || count == REPLAY_STRING_MAX - 1) {
+                        return -1;
+                    }
+                    replay_string[count++] = (char)c;
+                }
+                replay_string[count] = '\0';
+                count = 0;
+                break;
+            default:
+                break;
+        }
+        if (count > MDA_SCREEN_WORDS || fread(replay_cells, sizeof(mda_cell_t), count, f) != count) {
+            return -1;
+        }
+        uint32_t start = mda_clock_us();
+        switch (op) {
+            case MDA_TRACE_SCREEN: {
+                mda_rect_t screen = mda_rect_make(0, 0, MDA_COLUMNS, MDA_ROWS);
+                replay_rect(&screen, replay_cells);
+                break;
+            }
+            case MDA_TRACE_FRAME:
+                (*frames)++;
+                if (mda_trace_checksum() != (a.bytes[0] | ((uint16_t)a.bytes[1] << 8))) {
+                    differ++;
+                }
+                break;
+            case MDA_TRACE_CONTEXT:       replay_context(ctx, a.bytes); break;
+            case MDA_TRACE_LOAD_RECT:     replay_rect(rect, replay_cells); break;
+            case MDA_TRACE_PLOT:          mda_plot(p0, &a.cells[1]); break;
+            case MDA_TRACE_HLINE:         mda_draw_hline(p0, p1, &a.cells[2]); break;
+            case MDA_TRACE_VLINE:         mda_draw_vline(p0, p1, &a.cells[2]); break;
+            case MDA_TRACE_HLINE_CAPS:    mda_draw_hline_caps(p0, p1, &a.cells[2]); break;
+            case MDA_TRACE_VLINE_CAPS:    mda_draw_vline_caps(p0, p1, &a.cells[2]); break;
+            case MDA_TRACE_DRAW_RECT:     mda_draw_rect(rect, &a.cells[2]); break;
+            case MDA_TRACE_FILL_RECT:     mda_fill_rect(rect, &a.cells[2]); break;
+            case MDA_TRACE_DRAW_BORDER:   mda_draw_border(rect, &a.cells[2]); break;
+            case MDA_TRACE_WRITE_CELLS:   mda_write_cells(p0, replay_cells, (uint8_t)count); break;
+            case MDA_TRACE_WRITE_ATTR:    mda_write_attr(p0, a.bytes[2], a.bytes[3]); break;
+            case MDA_TRACE_FILL_SCREEN:   mda_fill_screen(&a.cells[0]); break;
+            case MDA_TRACE_SCROLL_UP:     mda_scroll_up(rect, &a.cells[2]); break;
+            case MDA_TRACE_SCROLL_DOWN:   mda_scroll_down(rect, &a.cells[2]); break;
+            case MDA_TRACE_SCROLL_LEFT:   mda_scroll_left(rect, &a.cells[2]); break;
+            case MDA_TRACE_SCROLL_RIGHT:  mda_scroll_right(rect, &a.cells[2]); break;
+            case MDA_TRACE_HW_SCROLL_UP:  mda_hw_scroll_up(&a.cells[0]); break;
+            case MDA_TRACE_HW_SCROLL_DOWN: mda_hw_scroll_down(&a.cells[0]); break;
+            case MDA_TRACE_CURSOR_TO:     mda_cursor_to(ctx, (mda_point_t*)p0); break;
+            case MDA_TRACE_BS:            mda_BS(ctx); break;
+            case MDA_TRACE_HT:            mda_HT(ctx); break;
+            case MDA_TRACE_LF:            mda_LF(ctx); break;
+            case MDA_TRACE_VT:            mda_VT(ctx); break;
+            case MDA_TRACE_FF:            mda_FF(ctx); break;
+            case MDA_TRACE_CR:            mda_CR(ctx); break;
+            case MDA_TRACE_DEL:           mda_DEL(ctx); break;
+            case MDA_TRACE_CRLF:          mda_CRLF(ctx); break;
+            case MDA_TRACE_PRINT_CHAR:    mda_print_char(ctx, (char)a.bytes[0]); break;
+            case MDA_TRACE_PRINT_STRING:  mda_print_string(ctx, replay_string); break;
+        }
+        replay_us[op] += mda_clock_us() - start;
+        replay_calls[op]++;
+    }
+    return differ;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        printf("usage: REPLAY trace [passes]\n");
+        return 2;
+    }
+    int passes = (argc > 2) ? atoi(argv[2]) : 1;
+    FILE* f = fopen(argv[1], "rb");
+    char header[MDA_TRACE_FILE_HEADER];
+    if (f == NULL || fread(header, 1, MDA_TRACE_FILE_HEADER, f) != MDA_TRACE_FILE_HEADER
+        || memcmp(header, MDA_TRACE_MAGIC, 4) != 0 || header[4] != MDA_TRACE_VERSION) {
+        printf("%s: not a trace\n", argv[1]);
+        return 2;
+    }
+    mda_context_t ctx;
+    mda_initialize_default_context(&ctx);
+    mda_clock_init();
+    int differ = 0;
+    uint16_t frames = 0;
+    for (int pass = 0; pass < passes && differ >= 0; ++pass) {
+        fseek(f, MDA_TRACE_FILE_HEADER, SEEK_SET);
+        mda_crtc_set_start(0);
+        differ = replay_pass(f, &ctx, &frames);
+    }
+    fclose(f);
+    mda_crtc_set_start(0);
+    mda_FF(&ctx);
+#ifndef __DOS__
+    host_terminal_close();      // the report goes to the normal screen
+#endif
+    if (differ < 0) {
+        printf("%s: malformed trace\n", argv[1]);
+        return 2;
+    }
+    printf("%-16s %8s %10s %8s\n", "call", "count", "total us", "mean us");
+    for (int op = MDA_TRACE_LOAD_RECT; op < MDA_TRACE_OPS; ++op) {
+        if (replay_calls[op] > 0) {
+            printf("%-16s %8lu %10lu %8lu\n", mda_trace_op_name((mda_trace_op_t)op), (unsigned long)replay_calls[op],
+                   (unsigned long)replay_us[op], (unsigned long)(replay_us[op] / replay_calls[op]));
+        }
+    }
+    printf("frames %u, checksums %s (%d differ)\n", frames, differ ? "FAILED" : "ok", differ);
+    return differ ? 1 : 0;
+}
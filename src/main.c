@@ -5,7 +5,7 @@
 
 int main() {
 
-    #ifndef __LARGE__
+    #if defined(__DOS__) && !defined(__LARGE__)
         printf("Incorrect memory model is selected.\n");
         printf("Rebuild RETROLIB using the large memory model with the -ml compiler option.\n");
         return 0;
@@ -28,6 +28,26 @@ int main() {
     //demo_save_restore(&ctx);
     //demo_rect_save_restore(&ctx);
     demo_scroll(&ctx);
+    //demo_list_view(&ctx);
+    //demo_pager(&ctx);
+    //demo_scrollback(&ctx);
+    //demo_hw_scroll(&ctx);
+    //demo_display_list(&ctx);
+    //demo_surface(&ctx);
+    //demo_canvas(&ctx);
+    //demo_strip_chart(&ctx);
+    //demo_border(&ctx);
+    //demo_pattern(&ctx);
+    //demo_printf(&ctx);
+    //demo_markup(&ctx);
+    //demo_layout(&ctx);
+    //demo_editor(&ctx);
+    //demo_line_edit(&ctx);
+    //demo_recorder(&ctx);
+    //demo_trace(&ctx);
+    //demo_remote(&ctx);
+    //demo_presenter(&ctx);
+    //demo_raster(&ctx);
 
     getchar();
 